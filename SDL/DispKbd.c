@@ -16,6 +16,7 @@
 #include "../arch/ControlPane.h"
 #include "../arch/dbugsys.h"
 #include "../arch/keyboard.h"
+#include "../prof.h"
 
 #include "KeyTable.h"
 
@@ -186,6 +187,8 @@ int main(int argc, char *argv[])
     return EXIT_FAILURE;
   }
 
+  Prof_Init();
+
   exit_code = dagstandalone(argc, argv);
 
   SDL_Quit();
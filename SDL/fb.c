@@ -22,6 +22,8 @@
 #include "../arch/dbugsys.h"
 #include "../arch/displaydev.h"
 #include "../arch/ControlPane.h"
+#include "../arch/rowkernels.h"
+#include "../arch/displaythreads.h"
 #include <stdlib.h>
 
 /* An upper limit on how big to support monitor size, used for
@@ -55,6 +57,7 @@ static void PollDisplay(ARMul_State *state,int XScale,int YScale);
 #define SDD_Name(x) sdd16_##x
 #define SDD_RowsAtOnce 1
 #define SDD_Row SDD_HostColour *
+#define SDD_DirectRows
 #define SDD_DisplayDev SDD16_DisplayDev
 
 static SDD_HostColour SDD_Name(Host_GetColour)(ARMul_State *state,unsigned int col) { return GetColour(state, col); }
@@ -161,6 +164,7 @@ static void SDD_Name(Host_PollDisplay)(ARMul_State *state) {
 #undef SDD_Name
 #undef SDD_RowsAtOnce
 #undef SDD_Row
+#undef SDD_DirectRows
 #undef SDD_DisplayDev
 
 /* Standard display device, 32bpp */
@@ -169,6 +173,7 @@ static void SDD_Name(Host_PollDisplay)(ARMul_State *state) {
 #define SDD_Name(x) sdd32_##x
 #define SDD_RowsAtOnce 1
 #define SDD_Row SDD_HostColour *
+#define SDD_DirectRows
 #define SDD_DisplayDev SDD32_DisplayDev
 
 static SDD_HostColour SDD_Name(Host_GetColour)(ARMul_State *state,unsigned int col) { return GetColour(state, col); }
@@ -275,6 +280,7 @@ static void SDD_Name(Host_PollDisplay)(ARMul_State *state) {
 #undef SDD_Name
 #undef SDD_RowsAtOnce
 #undef SDD_Row
+#undef SDD_DirectRows
 #undef SDD_DisplayDev
 
 /* ------------------------------------------------------------------ */
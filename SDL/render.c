@@ -19,6 +19,8 @@
 #include "../arch/dbugsys.h"
 #include "../arch/displaydev.h"
 #include "../arch/ControlPane.h"
+#include "../arch/rowkernels.h"
+#include "../arch/displaythreads.h"
 #include <stdlib.h>
 
 /* An upper limit on how big to support monitor size, used for
@@ -54,6 +56,7 @@ static void PollDisplay(ARMul_State *state);
 #define SDD_Name(x) sdd16_##x
 #define SDD_RowsAtOnce 1
 #define SDD_Row SDD_HostColour *
+#define SDD_DirectRows
 #define SDD_DisplayDev SDD16R_DisplayDev
 
 static SDD_HostColour SDD_Name(Host_GetColour)(ARMul_State *state,unsigned int col) { return GetColour(state, col); }
@@ -132,6 +135,7 @@ static bool SDD_Name(Host_ChangeMode)(ARMul_State *state,int width,int height,in
 #undef SDD_Name
 #undef SDD_RowsAtOnce
 #undef SDD_Row
+#undef SDD_DirectRows
 #undef SDD_DisplayDev
 
 /* Standard display device, 32bpp */
@@ -140,6 +144,7 @@ static bool SDD_Name(Host_ChangeMode)(ARMul_State *state,int width,int height,in
 #define SDD_Name(x) sdd32_##x
 #define SDD_RowsAtOnce 1
 #define SDD_Row SDD_HostColour *
+#define SDD_DirectRows
 #define SDD_DisplayDev SDD32R_DisplayDev
 
 static SDD_HostColour SDD_Name(Host_GetColour)(ARMul_State *state,unsigned int col) { return GetColour(state, col); }
@@ -218,6 +223,7 @@ static bool SDD_Name(Host_ChangeMode)(ARMul_State *state,int width,int height,in
 #undef SDD_Name
 #undef SDD_RowsAtOnce
 #undef SDD_Row
+#undef SDD_DirectRows
 #undef SDD_DisplayDev
 
 /* ------------------------------------------------------------------ */
@@ -34,6 +34,7 @@
 #include "../arch/displaydev.h"
 
 #include "../arch/ControlPane.h"
+#include "../prof.h"
 #include "platform.h"
 
 /* ------------------------------------------------------------------ */
@@ -987,5 +988,7 @@ static void insist(int expr, const char *diag)
 
 int main(int argc, char *argv[])
 {
+  Prof_Init();
+
   return dagstandalone(argc, argv);
 }
@@ -126,7 +126,7 @@ void Sound_HostBuffered(SoundData *buffer,int32_t numSamples)
     bufsize /= sizeof(SoundData);
     if(numSamples > buffree)
     {
-      warn_sound("*** sound overflow! %d %d %d %d ***\n",numSamples-buffree,ARMul_EmuRate,Sound_FudgeRate,Sound_DMARate);
+      warn_sound("*** sound overflow! %d %d %d ***\n",numSamples-buffree,Sound_FudgeRate,Sound_DMARate);
       numSamples = buffree; /* We could block until space is available, but I'm woried we'd get stuck blocking forever because the FudgeRate increase wouldn't compensate for the ARMul cycles lost due to blocking */
       if(Sound_FudgeRate < -stepsize)
         Sound_FudgeRate = Sound_FudgeRate/2;
@@ -135,7 +135,7 @@ void Sound_HostBuffered(SoundData *buffer,int32_t numSamples)
     }
     else if(!used)
     {
-      warn_sound("*** sound underflow! %d %d %d ***\n",ARMul_EmuRate,Sound_FudgeRate,Sound_DMARate);
+      warn_sound("*** sound underflow! %d %d ***\n",Sound_FudgeRate,Sound_DMARate);
       if(Sound_FudgeRate > stepsize)
         Sound_FudgeRate = Sound_FudgeRate/2;
       else
@@ -97,13 +97,14 @@ void *state_alloc(int s)
 			if((IOCM = (struct OCMIFace *)GetInterface((struct Library *)ocmb, "main", 1, NULL))) {
 				p = ObtainOnChipMem();
 				using_ocm = TRUE;
+				memset(p, 0, s);
 			}
 		}
 	}
 #endif
 
 	if(p == NULL) {
-		p = AllocVec(s, MEMF_PRIVATE);
+		p = AllocVec(s, MEMF_PRIVATE | MEMF_CLEAR);
 	}
 	
 	return p;
@@ -939,7 +940,7 @@ Kbd_PollHostKbd(ARMul_State *state)
 	}
 
 	#ifdef __amigaos4__
-	ARexx_Handle();
+	ARexx_Handle(state);
 	
 	if(arexx_quit)
 		cleanup();
@@ -1027,6 +1028,11 @@ DisplayDev_Init(ARMul_State *state)
 									ASLFR_DoPatterns,TRUE,
 									TAG_DONE);
 
+	/* Apply the display tooltypes */
+	if(useupdateflags) DisplayDev_UseUpdateFlags = true;
+	DisplayDev_FrameSkip = frameskip;
+	if(autoupdateflags) DisplayDev_AutoUpdateFlags = true;
+
 #if 0
 	return DisplayDev_Set(state,&SDD_DisplayDev);
 #else
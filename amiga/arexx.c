@@ -14,6 +14,7 @@ struct ARexxIFace *IARexx;
 
 Object *arexx_obj = NULL;
 BOOL arexx_quit = FALSE;
+static ARMul_State *arexx_state = NULL; /* Machine the commands apply to */
 
 enum
 {
@@ -55,8 +56,9 @@ void ARexx_Init()
 
 }
 
-void ARexx_Handle()
+void ARexx_Handle(ARMul_State *state)
 {
+	arexx_state = state;
 	RA_HandleRexx(arexx_obj);
 }
 
@@ -88,11 +90,11 @@ STATIC VOID rx_floppy(struct ARexxCmd *cmd, struct RexxMsg *rxm)
 	UNUSED_VAR(rxm);
 
 	drv = *(long *)cmd->ac_ArgList[0];
-	FDC_EjectFloppy(drv);
+	FDC_EjectFloppy(arexx_state,drv);
 
 	if(cmd->ac_ArgList[1])
 	{
-		err = FDC_InsertFloppy(drv,(char *)cmd->ac_ArgList[1]);
+		err = FDC_InsertFloppy(arexx_state,drv,(char *)cmd->ac_ArgList[1]);
 
 		if(err)
 		{
@@ -4,9 +4,10 @@
 
 #include <proto/arexx.h>
 #include <classes/arexx.h>
+#include "../armdefs.h"
 
 extern void ARexx_Init(void);
-extern void ARexx_Handle(void);
+extern void ARexx_Handle(ARMul_State *state);
 extern void ARexx_Execute(char *);
 extern void ARexx_Cleanup(void);
 extern BOOL arexx_quit;
@@ -25,4 +25,7 @@ extern int force8bit;
 extern int swapmousebuttons;
 extern BOOL anymonitor;
 extern BOOL use_ocm;
+extern BOOL useupdateflags;
+extern int frameskip;
+extern BOOL autoupdateflags;
 #endif
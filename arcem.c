@@ -0,0 +1,246 @@
+/*
+  arcem.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Embedding interface, see arcem.h.
+
+  Arcem_Run drives ARMul_DoProg, using ARMul_Stop to get it to return. Cycle
+  limits are implemented with an EventQ entry, which is removed again if the
+  emulator stops for some other reason first.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "arcem.h"
+#include "armdefs.h"
+#include "eventq.h"
+#include "arch/ArcemConfig.h"
+#include "arch/ControlPane.h"
+#include "arch/displaydev.h"
+#include "arch/fastmap.h"
+#include "arch/keyboard.h"
+
+#if (ARCEM_STOP_EXIT != ARMul_Stop_Exit) || (ARCEM_STOP_CYCLES != ARMul_Stop_Cycles) || (ARCEM_STOP_VSYNC != ARMul_Stop_VSync)
+#error "ARCEM_STOP_ values must match ARMul_Stop_ values"
+#endif
+
+/* Largest number of cycles to run per ARMul_DoProg call, so the limit event
+   is never too far in the future for the event queue */
+#define ARCEM_MAX_SLICE (MAX_CYCLES_INTO_FUTURE/2)
+
+struct ArcemMachine {
+  ArcemConfig Config;
+  ARMul_State *State;
+  uint64_t Cycles; /* 64bit total of ARMul_Time */
+  CycleCount LastCycle;
+  bool Exited;
+};
+
+void Arcem_Init(void)
+{
+  ARMul_EmulateInit();
+}
+
+ArcemMachine *Arcem_Create(int argc, char *argv[])
+{
+  ArcemConfig config;
+  ArcemConfig_Result result = ArcemConfig_SetupDefaults(&config);
+
+  if (result == Result_Continue)
+    result = ArcemConfig_ParseCommandLine(&config, argc, argv);
+
+  if (result != Result_Continue) {
+    ArcemConfig_Free(&config);
+    return NULL;
+  }
+
+  return Arcem_CreateFromConfig(&config);
+}
+
+ArcemMachine *Arcem_CreateFromConfig(ArcemConfig *config)
+{
+  ArcemMachine *machine = calloc(1, sizeof(ArcemMachine));
+  if (!machine) {
+    ControlPane_Error(false, "Could not allocate machine");
+    ArcemConfig_Free(config);
+    return NULL;
+  }
+
+  machine->Config = *config;
+  machine->State = ARMul_NewState(&machine->Config);
+  if (!machine->State) {
+    ArcemConfig_Free(&machine->Config);
+    free(machine);
+    return NULL;
+  }
+  machine->LastCycle = machine->State->NumCycles;
+
+  return machine;
+}
+
+void Arcem_Destroy(ArcemMachine *machine)
+{
+  if (!machine)
+    return;
+  ARMul_FreeState(machine->State);
+  ArcemConfig_Free(&machine->Config);
+  free(machine);
+}
+
+static void Arcem_CycleLimit(ARMul_State *state, CycleCount nowtime)
+{
+  UNUSED_VAR(nowtime);
+  EventQ_Remove(state, 0);
+  ARMul_Stop(state, ARMul_Stop_Cycles);
+}
+
+static void Arcem_UpdateCycles(ArcemMachine *machine)
+{
+  ARMul_State *state = machine->State;
+  machine->Cycles += (CycleCount) (ARMul_Time - machine->LastCycle);
+  machine->LastCycle = ARMul_Time;
+}
+
+unsigned int Arcem_Run(ArcemMachine *machine, uint64_t cycles, unsigned int stopon)
+{
+  ARMul_State *state = machine->State;
+  uint64_t end = machine->Cycles + cycles;
+  unsigned int reason;
+
+  if (machine->Exited)
+    return ARCEM_STOP_EXIT;
+
+  state->StopMask = stopon & ARMul_Stop_VSync;
+  for (;;) {
+    if (cycles) {
+      uint64_t left = end - machine->Cycles;
+      EventQ_Insert(state, ARMul_Time + (CycleCount) (left < ARCEM_MAX_SLICE ? left : ARCEM_MAX_SLICE), Arcem_CycleLimit);
+    }
+
+    ARMul_DoProg(state);
+    Arcem_UpdateCycles(machine);
+    reason = state->StopReason;
+
+    if (reason != ARMul_Stop_Cycles) {
+      int idx = EventQ_Find(state, Arcem_CycleLimit);
+      if (idx >= 0)
+        EventQ_Remove(state, idx);
+      break;
+    }
+    if (machine->Cycles >= end)
+      break;
+  }
+  state->StopMask = 0;
+
+  if (reason & ARMul_Stop_Exit)
+    machine->Exited = true;
+  return reason;
+}
+
+int Arcem_ExitCode(ArcemMachine *machine)
+{
+  return machine->State->ExitCode;
+}
+
+uint64_t Arcem_Cycles(ArcemMachine *machine)
+{
+  return machine->Cycles;
+}
+
+uint64_t Arcem_Instructions(ArcemMachine *machine)
+{
+  return machine->State->NumInstrs;
+}
+
+uint32_t Arcem_GetReg(ArcemMachine *machine, unsigned int reg)
+{
+  ARMul_State *state = machine->State;
+  if (reg == 15)
+    return ARMul_GetR15(state);
+  return state->Reg[reg & 15];
+}
+
+void Arcem_SetReg(ArcemMachine *machine, unsigned int reg, uint32_t value)
+{
+  ARMul_State *state = machine->State;
+  if (reg == 15)
+    ARMul_SetR15(state, value);
+  else
+    state->Reg[reg & 15] = value;
+}
+
+size_t Arcem_ReadMemory(ArcemMachine *machine, uint32_t address, void *buf, size_t len)
+{
+  ARMul_State *state = machine->State;
+  uint8_t *dest = buf;
+  size_t done = 0;
+
+  while (done < len) {
+    ARMword addr = (address + done) & UINT32_C(0x3ffffff);
+    FastMapEntry *entry = FastMap_GetEntryNoWrap(state, addr);
+    if (!FASTMAP_RESULT_DIRECT(FastMap_DecodeRead(entry, state->FastMapMode)))
+      break;
+#ifdef HOST_BIGENDIAN
+    addr ^= 3;
+#endif
+    dest[done++] = *((const uint8_t *) FastMap_Log2Phy(entry, addr));
+  }
+  return done;
+}
+
+size_t Arcem_WriteMemory(ArcemMachine *machine, uint32_t address, const void *buf, size_t len)
+{
+  ARMul_State *state = machine->State;
+  const uint8_t *src = buf;
+  size_t done = 0;
+
+  while (done < len) {
+    ARMword addr = (address + done) & UINT32_C(0x3ffffff);
+    FastMapEntry *entry = FastMap_GetEntryNoWrap(state, addr);
+    ARMword *phy;
+    if (!FASTMAP_RESULT_DIRECT(FastMap_DecodeWrite(entry, state->FastMapMode)))
+      break;
+    phy = FastMap_Log2Phy(entry, addr & ~UINT32_C(3));
+#ifdef HOST_BIGENDIAN
+    addr ^= 3;
+#endif
+    ((uint8_t *) phy)[addr & 3] = src[done++];
+    FastMap_PhyClobberFunc(state, phy);
+  }
+  return done;
+}
+
+bool Arcem_Key(ArcemMachine *machine, unsigned int key, bool down)
+{
+  ARMul_State *state = machine->State;
+  if (key >= ARCH_KEY_count)
+    return false;
+  keyboard_key_changed(&KBD, (arch_key_id) key, !down);
+  return true;
+}
+
+void Arcem_MouseMove(ArcemMachine *machine, int dx, int dy)
+{
+  ARMul_State *state = machine->State;
+
+  if (dx > 63) dx = 63;
+  if (dx < -63) dx = -63;
+  if (dy > 63) dy = 63;
+  if (dy < -63) dy = -63;
+
+  KBD.MouseXCount = dx & 127;
+  KBD.MouseYCount = dy & 127;
+}
+
+const uint32_t *Arcem_Framebuffer(ArcemMachine *machine, int *width, int *height)
+{
+  return NullDisplayDev_GetBuffer(machine->State, width, height);
+}
+
+ARMul_State *Arcem_GetState(ArcemMachine *machine)
+{
+  return machine->State;
+}
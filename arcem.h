@@ -0,0 +1,88 @@
+/*
+  arcem.h
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Embedding interface. Lets a host program create emulated machines, run them
+  for a number of cycles or until something of interest happens, and inspect
+  or poke them in between, without going through dagstandalone().
+
+  Several machines can exist at once, and each may be run on its own thread
+  (only one thread may use a given machine at a time). Call Arcem_Init()
+  before starting any threads. The host display, sound and input code is
+  still single-instance, so when linked into a frontend only one machine
+  should be non-headless. libarcem itself only provides the headless host.
+*/
+#ifndef ARCEM_H
+#define ARCEM_H
+
+#include "c99.h"
+
+typedef struct ArcemMachine ArcemMachine;
+
+struct ARMul_State;
+struct ArcemConfig_s;
+
+/* Reasons for Arcem_Run to return, as a bitmask */
+#define ARCEM_STOP_EXIT   1 /* The guest shut the machine down (or asked to exit) */
+#define ARCEM_STOP_CYCLES 2 /* The requested number of cycles have been run */
+#define ARCEM_STOP_VSYNC  4 /* A frame ended. Only if requested */
+
+/* Set up the tables which are shared by all machines */
+extern void Arcem_Init(void);
+
+/* Create a machine, configured from command line style arguments (argv[0]
+   is ignored, see --help). The config file is only read if --config is
+   given. Returns NULL on failure, or if --help or --version were used */
+extern ArcemMachine *Arcem_Create(int argc, char *argv[]);
+
+/* Create a machine from a config set up with the ArcemConfig_ functions.
+   The machine takes ownership of any memory the config refers to */
+extern ArcemMachine *Arcem_CreateFromConfig(struct ArcemConfig_s *config);
+
+extern void Arcem_Destroy(ArcemMachine *machine);
+
+/* Run until one of the reasons in stopon (a mask of ARCEM_STOP_VSYNC)
+   happens, the guest exits, or the given number of cycles have been run.
+   cycles == 0 means no limit. Returns the ARCEM_STOP_ reasons. Stopping and
+   resuming costs a couple of extra cycles for refilling the pipeline */
+extern unsigned int Arcem_Run(ArcemMachine *machine, uint64_t cycles, unsigned int stopon);
+
+/* The exit code the guest gave, once Arcem_Run has returned ARCEM_STOP_EXIT */
+extern int Arcem_ExitCode(ArcemMachine *machine);
+
+/* Number of cycles & instructions run so far */
+extern uint64_t Arcem_Cycles(ArcemMachine *machine);
+extern uint64_t Arcem_Instructions(ArcemMachine *machine);
+
+/* Registers of the current mode. R15 holds the PSR bits and the address of
+   the next instruction to run (without the usual +8 pipeline offset).
+   Writing R15 can change the mode */
+extern uint32_t Arcem_GetReg(ArcemMachine *machine, unsigned int reg);
+extern void Arcem_SetReg(ArcemMachine *machine, unsigned int reg, uint32_t value);
+
+/* Copy memory out of/into the logical address space, as the CPU would see
+   it in its current mode. Only directly mapped memory can be accessed (RAM &
+   ROM for reads, RAM for writes), not I/O. Returns the number of bytes
+   copied, which will be short if an inaccessible page is reached */
+extern size_t Arcem_ReadMemory(ArcemMachine *machine, uint32_t address, void *buf, size_t len);
+extern size_t Arcem_WriteMemory(ArcemMachine *machine, uint32_t address, const void *buf, size_t len);
+
+/* Press or release a key or mouse button. key is an ARCH_KEY_ value from
+   arch/keyboard.h. Returns false if the key is unknown */
+extern bool Arcem_Key(ArcemMachine *machine, unsigned int key, bool down);
+
+/* Move the mouse. Positive dy moves up. Each axis is limited to +/-63 per
+   keyboard poll, and the next call replaces any movement not yet sent */
+extern void Arcem_MouseMove(ArcemMachine *machine, int dx, int dy);
+
+/* Get the last frame drawn by the headless display, as 0x00RRGGBB pixels,
+   width*height in size. Returns NULL if the machine isn't headless, or
+   hasn't set up a display mode yet */
+extern const uint32_t *Arcem_Framebuffer(ArcemMachine *machine, int *width, int *height);
+
+/* The underlying emulator state, for code which uses the internals */
+extern struct ARMul_State *Arcem_GetState(ArcemMachine *machine);
+
+#endif
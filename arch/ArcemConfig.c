@@ -108,6 +108,18 @@ ArcemConfig_Result ArcemConfig_SetupDefaults(ArcemConfig *pConfig)
   memset(pConfig->aST506Paths, 0, sizeof(char *) * 4);
   memset(pConfig->aST506DiskShapes, 0, sizeof(struct HDCshape) * 4);
 
+#if defined(ARMUL_IDLE_DETECT)
+  pConfig->bIdleDetect = true;
+#endif
+#if defined(DISPLAY_THREADS)
+  pConfig->iDisplayThreads = 0;
+#endif
+
+  pConfig->bHeadless = false;
+  pConfig->iBenchCycles = 0;
+  pConfig->iBenchSeconds = 0;
+  pConfig->bBenchMicro = false;
+
   pConfig->bAspectRatioCorrection = true;
   pConfig->bUpscale = true;
 
@@ -188,6 +200,14 @@ static int ArcemConfig_Handler(void* user, const char* section,
                 warn("Unrecognised value for %s: %s\n", name, value);
                 return 0;
             }
+#if defined(ARMUL_IDLE_DETECT)
+        } else if (0 == strcmp(name, "idle")) {
+            pConfig->bIdleDetect = (atoi(value) != 0);
+#endif
+#if defined(DISPLAY_THREADS)
+        } else if (0 == strcmp(name, "displaythreads")) {
+            pConfig->iDisplayThreads = atoi(value);
+#endif
         } else {
             warn("Unknown section/name: %s, %s, %s\n", section, name, value);
             return 0;
@@ -295,6 +315,19 @@ ArcemConfig_Result ArcemConfig_ParseCommandLine(ArcemConfig *pConfig, int argc,
     "     Where value is one of 'ARM2', 'ARM250', 'ARM3'\n"
     "  --noaspect - Disable aspect ratio correction\n"
     "  --noupscale - Disable upscaling\n"
+#if defined(ARMUL_IDLE_DETECT)
+    "  --noidle - Don't skip ahead when the CPU is in an idle loop\n"
+#endif /* ARMUL_IDLE_DETECT */
+#if defined(DISPLAY_THREADS)
+    "  --displaythreads <value> - Convert display rows on this many worker\n"
+    "     threads (default 0, i.e. on the emulator thread)\n"
+#endif /* DISPLAY_THREADS */
+    "  --headless - Run without display, sound or input, and print benchmark\n"
+    "     results on exit\n"
+    "  --cycles <value> - Exit after the given number of emulated cycles\n"
+    "  --seconds <value> - Exit after the given number of emulated seconds\n"
+    "  --bench-micro - Also time IRQ entry/exit and the display row kernels\n"
+    "     when printing benchmark results\n"
 #if defined(SYSTEM_riscos_single) || defined(SYSTEM_win)
     "  --display <mode> - Select display driver, 'pal' or 'std'\n"
 #endif /* SYSTEM_riscos_single || SYSTEM_win */
@@ -427,6 +460,49 @@ ArcemConfig_Result ArcemConfig_ParseCommandLine(ArcemConfig *pConfig, int argc,
       pConfig->bUpscale = false;
       iArgument += 1;
     }
+#if defined(ARMUL_IDLE_DETECT)
+    else if(0 == strcmp("--noidle",argv[iArgument])) {
+      pConfig->bIdleDetect = false;
+      iArgument += 1;
+    }
+#endif /* ARMUL_IDLE_DETECT */
+#if defined(DISPLAY_THREADS)
+    else if(0 == strcmp("--displaythreads",argv[iArgument])) {
+      if(iArgument+1 < argc) { /* Is there a following argument? */
+        pConfig->iDisplayThreads = atoi(argv[iArgument+1]);
+        iArgument += 2;
+      } else {
+        ControlPane_Error(false,"No argument following the --displaythreads option");
+        return Result_Failure;
+      }
+    }
+#endif /* DISPLAY_THREADS */
+    else if(0 == strcmp("--headless",argv[iArgument])) {
+      pConfig->bHeadless = true;
+      iArgument += 1;
+    }
+    else if(0 == strcmp("--cycles",argv[iArgument])) {
+      if(iArgument+1 < argc) { /* Is there a following argument? */
+        pConfig->iBenchCycles = strtoull(argv[iArgument+1],NULL,0);
+        iArgument += 2;
+      } else {
+        ControlPane_Error(false,"No argument following the --cycles option");
+        return Result_Failure;
+      }
+    }
+    else if(0 == strcmp("--seconds",argv[iArgument])) {
+      if(iArgument+1 < argc) { /* Is there a following argument? */
+        pConfig->iBenchSeconds = (uint32_t) strtoul(argv[iArgument+1],NULL,0);
+        iArgument += 2;
+      } else {
+        ControlPane_Error(false,"No argument following the --seconds option");
+        return Result_Failure;
+      }
+    }
+    else if(0 == strcmp("--bench-micro",argv[iArgument])) {
+      pConfig->bBenchMicro = true;
+      iArgument += 1;
+    }
 #if defined(SYSTEM_riscos_single) || defined(SYSTEM_win)
     else if(0 == strcmp("--display", argv[iArgument])) {
       if(iArgument+1 < argc) { /* Is there a following argument? */
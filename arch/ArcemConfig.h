@@ -97,6 +97,18 @@ struct ArcemConfig_s {
   /* Shapes of the MFM ST506 drives as set in the config file */
   struct HDCshape aST506DiskShapes[4];
 
+#if defined(ARMUL_IDLE_DETECT)
+  bool bIdleDetect; /* Skip ahead to the next event when the CPU is idle */
+#endif
+#if defined(DISPLAY_THREADS)
+  int iDisplayThreads; /* Number of worker threads to convert display rows on, 0 to convert them on the emulator thread */
+#endif
+
+  bool bHeadless; /* Use the null display device, no sound and no host input */
+  uint64_t iBenchCycles; /* If nonzero, exit after this many emulated cycles */
+  uint32_t iBenchSeconds; /* If nonzero, exit after this many emulated seconds */
+  bool bBenchMicro; /* Also run the microbenchmarks when reporting the benchmark results */
+
   bool bAspectRatioCorrection; /* Apply H/V scaling for aspect ratio correction */
   bool bUpscale; /* Allow upscaling to fill screen */
 
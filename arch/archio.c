@@ -2,10 +2,12 @@
 /* (c) David Alan Gilbert 1995 - see Readme file for copying info */
 
 #include <ctype.h>
+#include <stdlib.h>
 
 #include "../armdefs.h"
 
 #include "dbugsys.h"
+#include "ControlPane.h"
 
 #include "armarc.h"
 #include "fdc1772.h"
@@ -21,8 +23,6 @@
 
 /*#define IOC_TRACE*/
 
-struct IOCStruct ioc;
-
 static void UpdateTimerRegisters_Event(ARMul_State *state,CycleCount time);
 
 /*-----------------------------------------------------------------------------*/
@@ -38,48 +38,64 @@ static void FDCHDC_Poll(ARMul_State *state,CycleCount nowtime)
 bool
 IO_Init(ARMul_State *state)
 {
-  ioc.ControlReg = 0xff;
-  ioc.ControlRegInputData = 0x7f; /* Not sure about IF and IR pins */
-  ioc.IRQStatus = 0x0090; /* (A) Top bit always set - plus power on reset */
-  ioc.IRQMask = 0;
-  ioc.FIRQStatus = 0;
-  ioc.FIRQMask = 0;
-  ioc.TimerInputLatch[0] = 0xffff;
-  ioc.TimerInputLatch[1] = 0xffff;
-  ioc.TimerInputLatch[2] = 0xffff;
-  ioc.TimerInputLatch[3] = 0xffff;
-  ioc.Timer0CanInt = ioc.Timer1CanInt = 1;
-  ioc.TimersLastUpdated = -1;
-  ioc.NextTimerTrigger = ARMul_Time;
-  ioc.TimerFracBit = 0; 
-  ioc.IOCRate = ioc.InvIOCRate = 0x10000; /* Default values shouldn't matter so much */
-  ioc.IOEBControlReg = 0;
+  state->Ioc = calloc(1,sizeof(struct IOCStruct));
+  if (!state->Ioc) {
+    ControlPane_Error(false,"Couldn't allocate IOC");
+    return false;
+  }
+
+  IOC.ControlReg = 0xff;
+  IOC.ControlRegInputData = 0x7f; /* Not sure about IF and IR pins */
+  IOC.IRQStatus = 0x0090; /* (A) Top bit always set - plus power on reset */
+  IOC.IRQMask = 0;
+  IOC.FIRQStatus = 0;
+  IOC.FIRQMask = 0;
+  IOC.TimerInputLatch[0] = 0xffff;
+  IOC.TimerInputLatch[1] = 0xffff;
+  IOC.TimerInputLatch[2] = 0xffff;
+  IOC.TimerInputLatch[3] = 0xffff;
+  IOC.Timer0CanInt = IOC.Timer1CanInt = 1;
+  IOC.TimersLastUpdated = -1;
+  IOC.NextTimerTrigger = ARMul_Time;
+  IOC.TimerFracBit = 0; 
+  IOC.IOCRate = IOC.InvIOCRate = 0x10000; /* Default values shouldn't matter so much */
+  IOC.IOEBControlReg = 0;
   EventQ_Insert(state,ARMul_Time,UpdateTimerRegisters_Event);
 
   IO_UpdateNirq(state);
   IO_UpdateNfiq(state);
 
-  if (!I2C_Init(state))
+  if (!I2C_Init(state) || !FDC_Init(state) || !HDC_Init(state) || !Kbd_Init(state))
     return false;
-  FDC_Init(state);
-  HDC_Init(state);
-  Kbd_Init(state);
   EventQ_Insert(state,ARMul_Time+250,FDCHDC_Poll);
   return true;
 } /* IO_Init */
 
+/*-----------------------------------------------------------------------------*/
+void
+IO_Exit(ARMul_State *state)
+{
+  Kbd_Exit(state);
+  HDC_Exit(state);
+  FDC_Exit(state);
+  I2C_Exit(state);
+  free(state->Ioc);
+  state->Ioc = NULL;
+} /* IO_Exit */
+
 /*------------------------------------------------------------------------------*/
 void
 IO_UpdateNfiq(ARMul_State *state)
 {
   register ARMword tmp = state->Exception & ~Exception_FIQ;
 
-  if (ioc.FIRQStatus & ioc.FIRQMask) {
+  if (IOC.FIRQStatus & IOC.FIRQMask) {
     /* Cause FIQ */
     tmp |= Exception_FIQ;
   }
 
   state->Exception = tmp;
+  ARMul_ForceEventCheck(state);
 }
 
 /*------------------------------------------------------------------------------*/
@@ -88,12 +104,13 @@ IO_UpdateNirq(ARMul_State *state)
 {
   register ARMword tmp = state->Exception & ~Exception_IRQ;
 
-  if (ioc.IRQStatus & ioc.IRQMask) {
+  if (IOC.IRQStatus & IOC.IRQMask) {
     /* Cause interrupt! */
     tmp |= Exception_IRQ;
   }
 
   state->Exception = tmp;
+  ARMul_ForceEventCheck(state);
 }
 
 /** Calculate if Timer0 or Timer1 can cause an interrupt; if either of them
@@ -102,25 +119,25 @@ IO_UpdateNirq(ARMul_State *state)
 static void
 CalcCanTimerInt(ARMul_State *state)
 {
-  bool oldTimer0CanInt = ioc.Timer0CanInt;
-  bool oldTimer1CanInt = ioc.Timer1CanInt;
+  bool oldTimer0CanInt = IOC.Timer0CanInt;
+  bool oldTimer1CanInt = IOC.Timer1CanInt;
 
 #if 0 /* This old code was wrong and was preventing RISC OS from booting, since RISC OS checks that the timers are working (or something) by programming one of them while the IRQ is masked out */
   /* If its not causing an interrupt at the moment, and its interrupt is
      enabled */
-  ioc.Timer0CanInt = ((ioc.IRQStatus & IRQA_TM0) == 0) &&
-                     ((ioc.IRQMask & IRQA_TM0) != 0);
-  ioc.Timer1CanInt = ((ioc.IRQStatus & IRQA_TM1) == 0) &&
-                     ((ioc.IRQMask & IRQA_TM1) != 0);
+  IOC.Timer0CanInt = ((IOC.IRQStatus & IRQA_TM0) == 0) &&
+                     ((IOC.IRQMask & IRQA_TM0) != 0);
+  IOC.Timer1CanInt = ((IOC.IRQStatus & IRQA_TM1) == 0) &&
+                     ((IOC.IRQMask & IRQA_TM1) != 0);
 #else
   /* New code: Just look at the current IRQ status (although chances are that's wrong as well?) */
-  ioc.Timer0CanInt = ((ioc.IRQStatus & IRQA_TM0) == 0);
-  ioc.Timer1CanInt = ((ioc.IRQStatus & IRQA_TM1) == 0);
+  IOC.Timer0CanInt = ((IOC.IRQStatus & IRQA_TM0) == 0);
+  IOC.Timer1CanInt = ((IOC.IRQStatus & IRQA_TM1) == 0);
 #endif
 
   /* If any have just been enabled update the triggers */
-  if (((!oldTimer0CanInt) && (ioc.Timer0CanInt)) ||
-      ((!oldTimer1CanInt) && (ioc.Timer1CanInt)))
+  if (((!oldTimer0CanInt) && (IOC.Timer0CanInt)) ||
+      ((!oldTimer1CanInt) && (IOC.Timer1CanInt)))
     UpdateTimerRegisters(state);
 } /* CalcCanTimerInt */
 
@@ -130,13 +147,13 @@ CalcCanTimerInt(ARMul_State *state)
 static uint_fast16_t
 GetCurrentTimerVal(ARMul_State *state,uint_fast8_t toget)
 {
-  CycleDiff timeSinceLastUpdate = ARMul_Time - ioc.TimersLastUpdated;
-  int32_t scaledTimeSlip = (int32_t)((((uint64_t) timeSinceLastUpdate) * ioc.IOCRate + ioc.TimerFracBit)>>16);
+  CycleDiff timeSinceLastUpdate = ARMul_Time - IOC.TimersLastUpdated;
+  int32_t scaledTimeSlip = (int32_t)((((uint64_t) timeSinceLastUpdate) * IOC.IOCRate + IOC.TimerFracBit)>>16);
   int32_t tmpL;
   int32_t result;
 
-  tmpL = ioc.TimerInputLatch[toget]+1;
-  result = ioc.TimerCount[toget] - (scaledTimeSlip % tmpL);
+  tmpL = IOC.TimerInputLatch[toget]+1;
+  result = IOC.TimerCount[toget] - (scaledTimeSlip % tmpL);
   if (result < 0) result += tmpL;
 
   return result & 0xffff;
@@ -148,10 +165,10 @@ static void UpdateTimerRegisters_Internal(ARMul_State *state,CycleCount nowtime,
 {
   uint32_t tmpL;
   CycleDiff scaledTimeSlip, nextTrigger;
-  CycleDiff timeSinceLastUpdate = nowtime - ioc.TimersLastUpdated;
+  CycleDiff timeSinceLastUpdate = nowtime - IOC.TimersLastUpdated;
   /* Take into account any lost fractions of an IOC tick */
-  uint64_t TimeSlip = (((uint64_t) timeSinceLastUpdate) * ioc.IOCRate)+ioc.TimerFracBit;
-  ioc.TimerFracBit = (uint_least16_t) (TimeSlip & 0xffff);
+  uint64_t TimeSlip = (((uint64_t) timeSinceLastUpdate) * IOC.IOCRate)+IOC.TimerFracBit;
+  IOC.TimerFracBit = (uint_least16_t) (TimeSlip & 0xffff);
   scaledTimeSlip = (CycleDiff) (TimeSlip>>16);
 
   /* In theory we should be able to use MAX_CYCLES_INTO_FUTURE as our default
@@ -160,64 +177,64 @@ static void UpdateTimerRegisters_Internal(ARMul_State *state,CycleCount nowtime,
      happens (presumably due a bug in ArcEm somewhere).
      So use a failsafe default next trigger time of 65536 IOC cycles from now
      (i.e. the max possible timer period) */
-  nextTrigger = ioc.InvIOCRate; /* a.k.a. 65536 IOC cycles from now */
+  nextTrigger = IOC.InvIOCRate; /* a.k.a. 65536 IOC cycles from now */
 
   /* ----------------------------------------------------------------- */
-  tmpL = ioc.TimerInputLatch[0]+1;
-  if (ioc.TimerCount[0] < scaledTimeSlip) {
+  tmpL = IOC.TimerInputLatch[0]+1;
+  if (IOC.TimerCount[0] < scaledTimeSlip) {
     KBD.TimerIntHasHappened++;
-    ioc.IRQStatus |= IRQA_TM0;
+    IOC.IRQStatus |= IRQA_TM0;
     IO_UpdateNirq(state);
-    ioc.Timer0CanInt = 0; /* Because it's just caused one which hasn't cleared yet */
+    IOC.Timer0CanInt = 0; /* Because it's just caused one which hasn't cleared yet */
   }
-  ioc.TimerCount[0] -= (scaledTimeSlip % tmpL);
-  if (ioc.TimerCount[0] < 0) ioc.TimerCount[0] += tmpL;
+  IOC.TimerCount[0] -= (scaledTimeSlip % tmpL);
+  if (IOC.TimerCount[0] < 0) IOC.TimerCount[0] += tmpL;
 
-  if (ioc.Timer0CanInt) {
-    tmpL = (uint32_t)((((uint64_t) (ioc.TimerCount[0]+1)) * ioc.InvIOCRate) >> 16);
+  if (IOC.Timer0CanInt) {
+    tmpL = (uint32_t)((((uint64_t) (IOC.TimerCount[0]+1)) * IOC.InvIOCRate) >> 16);
     if ((int32_t)tmpL < nextTrigger) nextTrigger = tmpL;
   }
 
   /* ----------------------------------------------------------------- */
-  tmpL = ioc.TimerInputLatch[1]+1;
-  if (ioc.TimerCount[1] < scaledTimeSlip) {
-    ioc.IRQStatus |= IRQA_TM1;
+  tmpL = IOC.TimerInputLatch[1]+1;
+  if (IOC.TimerCount[1] < scaledTimeSlip) {
+    IOC.IRQStatus |= IRQA_TM1;
     IO_UpdateNirq(state);
-    ioc.Timer1CanInt = 0; /* Because its just caused one which hasn't cleared yet */
+    IOC.Timer1CanInt = 0; /* Because its just caused one which hasn't cleared yet */
   }
-  ioc.TimerCount[1] -= (scaledTimeSlip % tmpL);
-  if (ioc.TimerCount[1] < 0) ioc.TimerCount[1] += tmpL;
+  IOC.TimerCount[1] -= (scaledTimeSlip % tmpL);
+  if (IOC.TimerCount[1] < 0) IOC.TimerCount[1] += tmpL;
 
-  if (ioc.Timer1CanInt) {
-    tmpL = (uint32_t)((((uint64_t) (ioc.TimerCount[1]+1)) * ioc.InvIOCRate) >> 16);
+  if (IOC.Timer1CanInt) {
+    tmpL = (uint32_t)((((uint64_t) (IOC.TimerCount[1]+1)) * IOC.InvIOCRate) >> 16);
     if ((int32_t)tmpL < nextTrigger) nextTrigger = tmpL;
   }
 
   /* ----------------------------------------------------------------- */
-  if (ioc.TimerInputLatch[2]) {
-    tmpL = ioc.TimerInputLatch[2]+1;
-    ioc.TimerCount[2] -= (scaledTimeSlip % tmpL);
-    if(ioc.TimerCount[2] < 0) ioc.TimerCount[2] += tmpL;
+  if (IOC.TimerInputLatch[2]) {
+    tmpL = IOC.TimerInputLatch[2]+1;
+    IOC.TimerCount[2] -= (scaledTimeSlip % tmpL);
+    if(IOC.TimerCount[2] < 0) IOC.TimerCount[2] += tmpL;
   }
 
   /* ----------------------------------------------------------------- */
-  if (ioc.TimerInputLatch[3]) {
-    tmpL = ioc.TimerInputLatch[3]+1;
-    ioc.TimerCount[3] -= (scaledTimeSlip % tmpL);
-    if(ioc.TimerCount[3] < 0) ioc.TimerCount[3] += tmpL;
+  if (IOC.TimerInputLatch[3]) {
+    tmpL = IOC.TimerInputLatch[3]+1;
+    IOC.TimerCount[3] -= (scaledTimeSlip % tmpL);
+    if(IOC.TimerCount[3] < 0) IOC.TimerCount[3] += tmpL;
   }
 
-  ioc.TimersLastUpdated = nowtime;
+  IOC.TimersLastUpdated = nowtime;
 
   /* Don't get stuck if we're waiting for something that's about to fire */
-  if(!idx && (nextTrigger < 32768) && (nextTrigger*ioc.IOCRate < 65536))
+  if(!idx && (nextTrigger < 32768) && (nextTrigger*IOC.IOCRate < 65536))
   {
     do {
       nextTrigger = (nextTrigger<<1) | 1;
-    } while(nextTrigger*ioc.IOCRate < 65536);
+    } while(nextTrigger*IOC.IOCRate < 65536);
   }
 
-  ioc.NextTimerTrigger = nowtime + nextTrigger;
+  IOC.NextTimerTrigger = nowtime + nextTrigger;
   EventQ_Reschedule(state,nowtime + nextTrigger,UpdateTimerRegisters_Event,idx);
 }
 
@@ -242,8 +259,8 @@ static void
 IOC_ControlLinesUpdate(ARMul_State *state)
 {
 
-  dbug_ioc("IOC_ControlLines: Clk=%d Data=%d\n", (ioc.ControlReg & 2) != 0,
-           ioc.ControlReg & 1);
+  dbug_ioc("IOC_ControlLines: Clk=%d Data=%d\n", (IOC.ControlReg & 2) != 0,
+           IOC.ControlReg & 1);
   I2C_Update(state);
 
 } /* IOC_ControlLinesUpdate */
@@ -275,59 +292,59 @@ GetWord_IOCReg(ARMul_State *state, uint_fast8_t Register)
 
   switch (Register) {
     case 0: /* Control reg */
-      Result = ioc.ControlRegInputData & ioc.ControlReg;
+      Result = IOC.ControlRegInputData & IOC.ControlReg;
       dbug_ioc("IOCRead: ControlReg=0x%x\n", Result);
       break;
 
     case 1: /* Serial Rx data */
-      Result = ioc.SerialRxData;
-      ioc.IRQStatus &= ~IRQB_SRX; /* Clear receive reg full */
+      Result = IOC.SerialRxData;
+      IOC.IRQStatus &= ~IRQB_SRX; /* Clear receive reg full */
       dbug_ioc("IOCRead: SerialRxData=0x%x\n", Result);
       IO_UpdateNirq(state);
       break;
 
     case 4: /* IRQ Status A */
-      Result = ioc.IRQStatus & 0xff;
+      Result = IOC.IRQStatus & 0xff;
       dbug_ioc("IOCRead: IRQStatusA=0x%x\n", Result);
       break;
 
     case 5: /* IRQ Request A */
-      Result = (ioc.IRQStatus & ioc.IRQMask) & 0xff;
+      Result = (IOC.IRQStatus & IOC.IRQMask) & 0xff;
       dbug_ioc("IOCRead: IRQRequestA=0x%x\n", Result);
       break;
 
     case 6: /* IRQ Mask A */
-      Result = ioc.IRQMask & 0xff;
+      Result = IOC.IRQMask & 0xff;
       dbug_ioc("IOCRead: IRQMaskA=0x%x\n", Result);
       break;
 
     case 8: /* IRQ Status B */
-      Result = ioc.IRQStatus >> 8;
+      Result = IOC.IRQStatus >> 8;
       dbug_ioc("IOCRead: IRQStatusB=0x%x\n", Result);
       break;
 
     case 9: /* IRQ Request B */
-      Result = (ioc.IRQStatus & ioc.IRQMask) >> 8;
+      Result = (IOC.IRQStatus & IOC.IRQMask) >> 8;
       dbug_ioc("IOCRead: IRQRequestB=0x%x\n", Result);
       break;
 
     case 0xa: /* IRQ Mask B */
-      Result = ioc.IRQMask >> 8;
+      Result = IOC.IRQMask >> 8;
       dbug_ioc("IOCRead: IRQMaskB=0x%x\n", Result);
       break;
 
     case 0xc: /* FIRQ Status */
-      Result = ioc.FIRQStatus;
+      Result = IOC.FIRQStatus;
       dbug_ioc("IOCRead: FIRQStatus=0x%x\n", Result);
       break;
 
     case 0xd: /* FIRQ Request */
-      Result = ioc.FIRQStatus & ioc.FIRQMask;
+      Result = IOC.FIRQStatus & IOC.FIRQMask;
       dbug_ioc("IOCRead: FIRQRequest=0x%x\n", Result);
       break;
 
     case 0xe: /* FIRQ mask */
-      Result = ioc.FIRQMask;
+      Result = IOC.FIRQMask;
       dbug_ioc("IOCRead: FIRQMask=0x%x\n", Result);
       break;
 
@@ -336,7 +353,7 @@ GetWord_IOCReg(ARMul_State *state, uint_fast8_t Register)
     case 0x18: /* T2 count low */
     case 0x1c: /* T3 count low */
       Timer = (Register & 0xf) >> 2;
-      Result = ioc.TimerOutputLatch[Timer] & 0xff;
+      Result = IOC.TimerOutputLatch[Timer] & 0xff;
       /*dbug_ioc("IOCRead: Timer %d low counter read=0x%x\n", Timer, Result);
       dbug_ioc("SPECIAL: R0=0x%x R1=0x%x R14=0x%x\n", state->Reg[0],
               state->Reg[1], state->Reg[14]); */
@@ -347,7 +364,7 @@ GetWord_IOCReg(ARMul_State *state, uint_fast8_t Register)
     case 0x19: /* T2 count high */
     case 0x1a: /* T3 count high */
       Timer = (Register & 0xf) >> 2;
-      Result = (ioc.TimerOutputLatch[Timer] >> 8) & 0xff;
+      Result = (IOC.TimerOutputLatch[Timer] >> 8) & 0xff;
       dbug_ioc("IOCRead: Timer %d high counter read=0x%x\n", Timer, Result);
       break;
 
@@ -368,14 +385,14 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
 
   switch (Register) {
     case 0: /* Control reg */
-      ioc.ControlReg = (data & 0x3f) | 0xc0; /* Needs more work */
+      IOC.ControlReg = (data & 0x3f) | 0xc0; /* Needs more work */
       IOC_ControlLinesUpdate(state);
       dbug_ioc("IOC Write: Control reg val=0x%x\n", data);
       break;
 
     case 1: /* Serial Tx Data */
-      ioc.SerialTxData = data & 0xff; /* Should tell the keyboard about this */
-      ioc.IRQStatus &= ~IRQB_STX; /* Clear KART Tx empty */
+      IOC.SerialTxData = data & 0xff; /* Should tell the keyboard about this */
+      IOC.IRQStatus &= ~IRQB_STX; /* Clear KART Tx empty */
       dbug_ioc("IOC Write: Serial Tx Reg Val=0x%x\n", data);
       IO_UpdateNirq(state);
       break;
@@ -384,7 +401,7 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
       dbug_ioc("IOC Write: Clear Ints Val=0x%x\n", data);
       /* Clear appropriate interrupts */
       data &= 0x7c;
-      ioc.IRQStatus &= ~data;
+      IOC.IRQStatus &= ~data;
       /* If we have cleared a timer interrupt then it may cause another */
       if (data & 0x60)
         CalcCanTimerInt(state);
@@ -392,22 +409,22 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
       break;
 
     case 6: /* IRQ Mask A */
-      ioc.IRQMask &= 0xff00;
-      ioc.IRQMask |= (data & 0xff);
+      IOC.IRQMask &= 0xff00;
+      IOC.IRQMask |= (data & 0xff);
       CalcCanTimerInt(state);
       dbug_ioc("IOC Write: IRQ Mask A Val=0x%x\n", data);
       IO_UpdateNirq(state);
       break;
 
     case 0xa: /* IRQ mask B */
-      ioc.IRQMask &= 0xff;
-      ioc.IRQMask |= (data & 0xff) << 8;
+      IOC.IRQMask &= 0xff;
+      IOC.IRQMask |= (data & 0xff) << 8;
       dbug_ioc("IOC Write: IRQ Mask B Val=0x%x\n", data);
       IO_UpdateNirq(state);
       break;
 
     case 0xe: /* FIRQ Mask */
-      ioc.FIRQMask = data;
+      IOC.FIRQMask = data;
       IO_UpdateNfiq(state);
       dbug_ioc("IOC Write: FIRQ Mask Val=0x%x\n", data);
       break;
@@ -418,11 +435,11 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
     case 0x1c: /* T3 latch low */
       Timer = (Register & 0xf) >> 2;
       UpdateTimerRegisters(state);
-      ioc.TimerInputLatch[Timer] &= 0xff00;
-      ioc.TimerInputLatch[Timer] |= data;
+      IOC.TimerInputLatch[Timer] &= 0xff00;
+      IOC.TimerInputLatch[Timer] |= data;
       UpdateTimerRegisters(state);
       dbug_ioc("IOC Write: Timer %d latch write low Val=0x%x InpLatch=0x%x\n",
-              Timer, data, ioc.TimerInputLatch[Timer]);
+              Timer, data, IOC.TimerInputLatch[Timer]);
       break;
 
     case 0x11: /* T0 latch High */
@@ -431,11 +448,11 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
     case 0x1d: /* T3 latch High */
       Timer = (Register & 0xf) >> 2;
       UpdateTimerRegisters(state);
-      ioc.TimerInputLatch[Timer] &= 0xff;
-      ioc.TimerInputLatch[Timer] |= data << 8;
+      IOC.TimerInputLatch[Timer] &= 0xff;
+      IOC.TimerInputLatch[Timer] |= data << 8;
       UpdateTimerRegisters(state);
       dbug_ioc("IOC Write: Timer %d latch write high Val=0x%x InpLatch=0x%x\n",
-              Timer, data, ioc.TimerInputLatch[Timer]);
+              Timer, data, IOC.TimerInputLatch[Timer]);
       break;
 
     case 0x12: /* T0 Go */
@@ -444,10 +461,10 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
     case 0x1e: /* T3 Go */
       Timer = (Register & 0xf) >> 2;
       UpdateTimerRegisters(state);
-      ioc.TimerCount[Timer] = ioc.TimerInputLatch[Timer];
+      IOC.TimerCount[Timer] = IOC.TimerInputLatch[Timer];
       UpdateTimerRegisters(state);
       dbug_ioc("IOC Write: Timer %d Go! Counter=0x%"PRIx32"\n",
-              Timer, ioc.TimerCount[Timer]);
+              Timer, IOC.TimerCount[Timer]);
       break;
 
     case 0x13: /* T0 Latch command */
@@ -455,10 +472,10 @@ PutVal_IOCReg(ARMul_State *state, uint_fast8_t Register, uint_fast8_t data)
     case 0x1b: /* T2 Latch command */
     case 0x1f: /* T3 Latch command */
       Timer = (Register & 0xf) / 4;
-      ioc.TimerOutputLatch[Timer] = GetCurrentTimerVal(state,Timer);
+      IOC.TimerOutputLatch[Timer] = GetCurrentTimerVal(state,Timer);
       /*dbug_ioc("(T%dLc)", Timer); */
       /*dbug_ioc("IOC Write: Timer %d Latch command Output Latch=0x%x\n",
-        Timer, ioc.TimerOutputLatch[Timer]); */
+        Timer, IOC.TimerOutputLatch[Timer]); */
       break;
 
     default:
@@ -666,13 +683,13 @@ PutValIO(ARMul_State *state, ARMword address, ARMword data, bool byteNotword)
 int
 IOC_ReadKbdTx(ARMul_State *state)
 {
-  if ((ioc.IRQStatus & IRQB_STX) == 0) {
-    /*dbug_ioc("IOC_ReadKbdTx: Value=0x%x\n", ioc.SerialTxData); */
+  if ((IOC.IRQStatus & IRQB_STX) == 0) {
+    /*dbug_ioc("IOC_ReadKbdTx: Value=0x%x\n", IOC.SerialTxData); */
     /* There is a byte present (Kart TX not empty) */
     /* Mark as empty and then return the value */
-    ioc.IRQStatus |= IRQB_STX;
+    IOC.IRQStatus |= IRQB_STX;
     IO_UpdateNirq(state);
-    return ioc.SerialTxData;
+    return IOC.SerialTxData;
   } else return -1;
 } /* IOC_ReadKbdTx */
 
@@ -683,14 +700,14 @@ int
 IOC_WriteKbdRx(ARMul_State *state, uint_least8_t value)
 {
   /*dbug_ioc("IOC_WriteKbdRx: value=0x%x\n", value); */
-  if (ioc.IRQStatus & IRQB_SRX) {
+  if (IOC.IRQStatus & IRQB_SRX) {
     /* Still full */
     return -1;
   } else {
     /* We write only if it was empty */
-    ioc.SerialRxData = value;
+    IOC.SerialRxData = value;
 
-    ioc.IRQStatus |= IRQB_SRX; /* Now full */
+    IOC.IRQStatus |= IRQB_SRX; /* Now full */
     IO_UpdateNirq(state);
   }
 
@@ -27,7 +27,7 @@ struct IOCStruct {
   uint32_t InvIOCRate; /* Inverse IOC rate, 16.16 */
 };
 
-extern struct IOCStruct ioc;
+#define IOC (*(state->Ioc))
 
 
 #define IRQA_VFLYBK (1U << 3)   /* Start of display vertical flyback */
@@ -67,6 +67,9 @@ void IOC_DoIntCheck(ARMul_State *state);
 /*-----------------------------------------------------------------------------*/
 bool IO_Init(ARMul_State *state);
 
+/*-----------------------------------------------------------------------------*/
+void IO_Exit(ARMul_State *state);
+
 /*-----------------------------------------------------------------------------*/
 ARMword GetWord_IO(ARMul_State *state, ARMword address);
 
@@ -12,6 +12,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #if defined(__riscos__) && defined(__TARGET_UNIXLIB__)
 #include <unixlib/local.h>
 #endif
@@ -30,6 +31,7 @@
 #include "ArcemConfig.h"
 #include "sound.h"
 #include "displaydev.h"
+#include "bench.h"
 #include "filecalls.h"
 #include "ControlPane.h"
 
@@ -40,24 +42,28 @@ extern char arcemDir[256];
 #endif
 
 
-struct MEMCStruct memc;
-
 /*-----------------------------------------------------------------------------*/
 
-static ARMword ARMul_ManglePhysAddr(ARMword phy);
+static ARMword ARMul_ManglePhysAddr(ARMul_State *state,ARMword phy);
+static void FastMap_CalcDisplayWatch(ARMul_State *state,uint32_t *watch);
 
 /*------------------------------------------------------------------------------*/
 /* OK - this is getting treated as an odds/sods engine - just hook up anything
    you need to do occasionally! */
 #ifndef _WIN32
+static ARMul_State *DumpHandler_State = NULL; /* Most recently created machine */
+
 static void DumpHandler(int sig) {
-  ARMul_State *state = &statestr;
+  ARMul_State *state = DumpHandler_State;
   FILE *res;
   int i, idx;
   ARMword size;
 
   UNUSED_VAR(sig);
 
+  if (!state)
+    return;
+
   warn("SIGUSR2 at PC=0x%"PRIx32"\n",ARMul_GetPC(state));
   signal(SIGUSR2,DumpHandler);
   /* Register dump */
@@ -108,7 +114,7 @@ static void DumpHandler(int sig) {
 
   /* IOC timers */
   for(i=0;i<4;i++)
-    warn("Timer%d Count %08"PRIx32" Latch %08x\n",i,(uint32_t)ioc.TimerCount[i],ioc.TimerInputLatch[i]);
+    warn("Timer%d Count %08"PRIx32" Latch %08x\n",i,(uint32_t)IOC.TimerCount[i],IOC.TimerInputLatch[i]);
 
   /* Memory map */
   warn("MEMC using %dKB page size\n",4<<MEMC.PageSizeFlags);
@@ -145,7 +151,7 @@ static void DumpHandler(int sig) {
           break;
       }
       phys *= size;
-      mangle = ARMul_ManglePhysAddr(phys);
+      mangle = ARMul_ManglePhysAddr(state,phys);
       warn("log %08"PRIx32" -> phy %08"PRIx32" (pre-mangle %08"PRIx32") prot %s\n",logadr,mangle,phys,prot[(pt>>8)&3]);
     }
   }
@@ -195,6 +201,30 @@ ARMul_MemoryInit(ARMul_State *state)
   uint32_t extnrom_entry_count;
 #endif
   uint32_t initmemsize = 0;
+
+  state->Memc = calloc(1,sizeof(struct MEMCStruct));
+  if (state->Memc == NULL) {
+    ControlPane_Error(false,"Couldn't allocate MEMC");
+    return false;
+  }
+
+  /* The FastMap, RAM/ROM and func tables are accessed at random on every
+     instruction fetch and load/store, so try to get huge pages for them */
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+  /* Func indices go after the entries, in the same block */
+  MEMC.FastMapSize = FASTMAP_SIZE*(sizeof(FastMapEntry)+sizeof(FastMapFuncIndex));
+#else
+  MEMC.FastMapSize = FASTMAP_SIZE*sizeof(FastMapEntry);
+#endif
+  state->FastMap = Memory_AllocHuge(&MEMC.FastMapSize,&MEMC.FastMapBacking);
+  if (state->FastMap == NULL) {
+    ControlPane_Error(false,"Could not allocate FastMap");
+    ARMul_MemoryExit(state);
+    return false;
+  }
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+  state->FastMapFuncs = (FastMapFuncIndex *) (state->FastMap+FASTMAP_SIZE);
+#endif
   
   MEMC.DRAMPageSize = MEMC_PAGESIZE_3_32K;
   switch(CONFIG.eMemSize) {
@@ -245,6 +275,7 @@ ARMul_MemoryInit(ARMul_State *state)
   }
 
 #ifndef _WIN32
+  DumpHandler_State = state;
   signal(SIGUSR2,DumpHandler);
 #endif
 
@@ -293,35 +324,45 @@ ARMul_MemoryInit(ARMul_State *state)
   dbug("Total ROM size required = %"PRIu32" KB\n",
        (MEMC.ROMHighSize + extnrom_size) / 1024);
 
-  /* Now allocate ROMs & RAM in one chunk */
+  /* Now allocate ROMs & RAM in one chunk. Memory_AllocHuge gives page
+     aligned, demand-zeroed memory, so untouched RAM costs nothing, and the
+     ROM image can be mapped straight from the file into its place in the
+     chunk (unless the chunk is on explicit huge pages) */
   RAMChunkSize = MAX(MEMC.RAMSize,512*1024); /* Ensure at least 512K RAM allocated to avoid any issues caused by DMA pointers going out of range */
   ROMRAMChunkSize = RAMChunkSize+MEMC.ROMHighSize+extnrom_size;
-  MEMC.ROMRAMChunk = calloc(1,ROMRAMChunkSize+256);
+  MEMC.ROMRAMChunkSize = ROMRAMChunkSize;
+  MEMC.ROMRAMChunk = Memory_AllocHuge(&MEMC.ROMRAMChunkSize,&MEMC.ROMRAMBacking);
   if(MEMC.ROMRAMChunk == NULL) {
     ControlPane_Error(false,"Couldn't allocate ROMRAMChunk");
     fclose(ROMFile);
     return false;
   }
 
-  /* Get everything 256 byte aligned for FastMap to work */
-  MEMC.PhysRam = (ARMword*) ((((FastMapUInt)MEMC.ROMRAMChunk)+255)&~255); /* RAM must come first for FastMap_LogRamFunc to work! */
+  /* Page alignment satisfies the 256 byte alignment FastMap needs */
+  MEMC.PhysRam = (ARMword*) MEMC.ROMRAMChunk; /* RAM must come first for FastMap_LogRamFunc to work! */
   MEMC.ROMHigh = MEMC.PhysRam + (RAMChunkSize>>2);
 
   dbug(" Loading ROM....\n ");
 
-  File_ReadEmu(ROMFile,(uint8_t *) MEMC.ROMHigh,MEMC.ROMHighSize);
+  /* Copy-on-write, so every machine using this ROM image shares its pages */
+  File_MapEmu(ROMFile,(uint8_t *) MEMC.ROMHigh,MEMC.ROMHighSize);
 
-  /* Close System ROM Image File */
+  /* Close System ROM Image File (any mapping stays valid) */
   fclose(ROMFile);
 
 #ifdef ARMUL_INSTR_FUNC_CACHE
-  MEMC.EmuFuncChunk = calloc(sizeof(FastMapUInt)/4,ROMRAMChunkSize+256);
+  /* Only pages holding executed code are ever touched */
+  MEMC.EmuFuncChunkSize = sizeof(ARMEmuFuncSlot)*(ROMRAMChunkSize/4);
+  MEMC.EmuFuncChunk = Memory_AllocHuge(&MEMC.EmuFuncChunkSize,&MEMC.EmuFuncBacking);
   if(MEMC.EmuFuncChunk == NULL) {
     ControlPane_Error(false,"Couldn't allocate EmuFuncChunk");
     ARMul_MemoryExit(state);
     return false;
   }
-#ifdef FASTMAP_64
+#if defined(ARMUL_INSTR_FUNC_INDEX)
+  /* Indices are half the size of the data, so ROMRAMChunk needs shifting to account for the shift that occurs in FastMap_Phy2Func */
+  state->FastMapInstrFuncOfs = ((FastMapUInt)MEMC.EmuFuncChunk)-(((FastMapUInt)MEMC.ROMRAMChunk)>>1);
+#elif defined(FASTMAP_64)
   /* On 64bit systems, ROMRAMChunk needs shifting to account for the shift that occurs in FastMap_Phy2Func */
   state->FastMapInstrFuncOfs = ((FastMapUInt)MEMC.EmuFuncChunk)-(((FastMapUInt)MEMC.ROMRAMChunk)<<1);
 #else
@@ -329,6 +370,29 @@ ARMul_MemoryInit(ARMul_State *state)
 #endif
 #endif
 
+#ifdef ARMUL_CODE_PAGES
+  state->CodePages = calloc(sizeof(CodePage),(ROMRAMChunkSize+(1<<CODEPAGE_SHIFT)-1)>>CODEPAGE_SHIFT);
+  if(state->CodePages == NULL) {
+    ControlPane_Error(false,"Couldn't allocate CodePages");
+    ARMul_MemoryExit(state);
+    return false;
+  }
+  state->CodePageBase = (FastMapUInt) MEMC.ROMRAMChunk;
+#endif
+#ifdef ARMUL_CODE_PAGE_STATS
+  state->CodeStats.DataStores = state->CodeStats.CodeStores = state->CodeStats.CodeWrites = 0;
+#endif
+
+#ifdef ARMUL_BLOCK_CACHE
+  state->BlockCache = calloc(BLOCKCACHE_SIZE,sizeof(BasicBlock));
+  if(state->BlockCache == NULL) {
+    ControlPane_Error(false,"Couldn't allocate BlockCache");
+    ARMul_MemoryExit(state);
+    return false;
+  }
+  state->BlockCur = NULL;
+#endif
+
   /* Create Space for extension ROM in ROMLow */
   if (extnrom_size) {
     MEMC.ROMLowSize = extnrom_size;
@@ -340,7 +404,7 @@ ARMul_MemoryInit(ARMul_State *state)
       return false;
     }
 
-    /* calloc() now used to ensure that Extension ROM space is zero'ed */
+    /* Memory_Alloc() ensures that Extension ROM space is zero'ed */
     MEMC.ROMLow = MEMC.ROMHigh + (MEMC.ROMHighSize>>2);
 
 #if defined(EXTNROM_SUPPORT)
@@ -359,7 +423,7 @@ ARMul_MemoryInit(ARMul_State *state)
     return false;
   }
 
-  if (!DisplayDev_Init(state)) {
+  if (CONFIG.bHeadless ? !DisplayDev_Set(state,&Null_DisplayDev) : !DisplayDev_Init(state)) {
     /* There was an error of some sort - it will already have been reported */
     ARMul_MemoryExit(state);
     return false;
@@ -371,9 +435,12 @@ ARMul_MemoryInit(ARMul_State *state)
     return false;
   }
 
+  Bench_Init(state);
+
   for (i = 0; i < 512 * 1024 / UPDATEBLOCKSIZE; i++) {
     MEMC.UpdateFlags[i] = 1;
   }
+  FastMap_CalcDisplayWatch(state,MEMC.DisplayWatch);
 
   ARMul_RebuildFastMap(state);
   FastMap_RebuildMapMode(state);
@@ -394,17 +461,43 @@ ARMul_MemoryInit(ARMul_State *state)
  */
 void ARMul_MemoryExit(ARMul_State *state)
 {
+  Bench_Exit(state);
   Sound_Shutdown(state);
   DisplayDev_Shutdown(state);
-  free(MEMC.ROMRAMChunk);
-  MEMC.ROMRAMChunk = NULL;
+  IO_Exit(state);
+#ifndef _WIN32
+  if (DumpHandler_State == state)
+    DumpHandler_State = NULL;
+#endif
+  if (state->Memc) {
+    Memory_Free(MEMC.ROMRAMChunk,MEMC.ROMRAMChunkSize);
 #ifdef ARMUL_INSTR_FUNC_CACHE
-  free(MEMC.EmuFuncChunk);
-  MEMC.EmuFuncChunk = NULL;
+    Memory_Free(MEMC.EmuFuncChunk,MEMC.EmuFuncChunkSize);
+#endif
+    Memory_Free(state->FastMap,MEMC.FastMapSize);
+    state->FastMap = NULL;
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+    state->FastMapFuncs = NULL;
+#endif
+    free(state->Memc);
+    state->Memc = NULL;
+  }
+#ifdef ARMUL_CODE_PAGE_STATS
+  dbug("Code pages: %"PRIu64" data stores skipped, %"PRIu64" code page stores, %"PRIu64" code overwrites\n",
+       state->CodeStats.DataStores,state->CodeStats.CodeStores,state->CodeStats.CodeWrites);
+#endif
+#ifdef ARMUL_CODE_PAGES
+  free(state->CodePages);
+  state->CodePages = NULL;
+#endif
+#ifdef ARMUL_BLOCK_CACHE
+  free(state->BlockCache);
+  state->BlockCache = NULL;
+  state->BlockCur = NULL;
 #endif
 }
 
-static ARMword ARMul_ManglePhysAddr(ARMword phy)
+static ARMword ARMul_ManglePhysAddr(ARMul_State *state,ARMword phy)
 {
   /* Emulate the different ways that MEMC converts physical addresses to
      row & column addresses. We perform two mappings here: From the physical
@@ -505,22 +598,72 @@ static ARMword ARMul_ManglePhysAddr(ARMword phy)
   return phy | (bank<<22);
 }    
 
-static void FastMap_SetEntries(ARMul_State *state, ARMword addr,ARMword *data,FastMapAccessFunc func,FastMapUInt flags,ARMword size)
+static ARMword FastMap_ROMMap1Func(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_PhysRamFuncROMMap2(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_PhysRamFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_LogRamFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_ConIOFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_VIDCFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_DMAFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+static ARMword FastMap_MEMCFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags);
+
+/* Every access func the FastMap uses, so that entries can refer to them by
+   index (see ARMUL_FASTMAP_FUNC_INDEX) */
+typedef enum FastMapFunc {
+  FastMapFunc_None           = 0,
+  FastMapFunc_ROMMap1        = 1,
+  FastMapFunc_PhysRamROMMap2 = 2,
+  FastMapFunc_PhysRam        = 3,
+  FastMapFunc_LogRam         = 4,
+  FastMapFunc_ConIO          = 5,
+  FastMapFunc_VIDC           = 6,
+  FastMapFunc_DMA            = 7,
+  FastMapFunc_MEMC           = 8
+} FastMapFunc;
+
+const FastMapAccessFunc FastMap_AccessFuncs[] = {
+  NULL,
+  FastMap_ROMMap1Func,
+  FastMap_PhysRamFuncROMMap2,
+  FastMap_PhysRamFunc,
+  FastMap_LogRamFunc,
+  FastMap_ConIOFunc,
+  FastMap_VIDCFunc,
+  FastMap_DMAFunc,
+  FastMap_MEMCFunc
+};
+
+static void FastMap_SetEntries(ARMul_State *state, ARMword addr,ARMword *data,FastMapFunc func,FastMapUInt flags,ARMword size)
 {
   FastMapEntry *entry = FastMap_GetEntryNoWrap(state,addr);
 /*  dbug("FastMap_SetEntries(%08x,%08x,%08x,%08x,%08x)\n",addr,data,func,flags,size); */
   FastMapUInt offset = ((FastMapUInt)data)-addr; /* Offset so we can just add the phy addr to get a pointer back */
   flags |= offset>>8;
+#ifdef ARMUL_BLOCK_CACHE
+  /* Mapping is changing, so any running block must stop */
+  state->BlockCur = NULL;
+#endif
+  FastMap_Changed(state);
 /*  dbug("->entry %08x\n->FlagsAndData %08x\n",entry,flags); */
+  MEMC.FastMapStats.Entries += size>>12;
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+  memset(&state->FastMapFuncs[addr>>12],func,size>>12);
   while(size) {
     entry->FlagsAndData = flags;
-    entry->AccessFunc = func;
     entry++;
     size -= 4096;
   }
+#else
+  while(size) {
+    entry->FlagsAndData = flags;
+    entry->AccessFunc = FastMap_AccessFuncs[func];
+    entry++;
+    size -= 4096;
+  }
+#endif
 }
 
-static void FastMap_SetEntries_Repeat(ARMul_State *state,ARMword addr,ARMword *data,FastMapAccessFunc func,FastMapUInt flags,ARMword size,ARMword totsize)
+static void FastMap_SetEntries_Repeat(ARMul_State *state,ARMword addr,ARMword *data,FastMapFunc func,FastMapUInt flags,ARMword size,ARMword totsize)
 {
   while(totsize > size) {
     FastMap_SetEntries(state,addr,data,func,flags,size);
@@ -542,6 +685,9 @@ static void ARMul_PurgeFastMapPTIdx(ARMul_State *state,ARMword idx)
   if(MEMC.ROMMapFlag != MapFlag_Normal)
     return; /* Still in ROM mode, abort */
     
+#ifdef ARMUL_BLOCK_CACHE
+  state->BlockCur = NULL;
+#endif
   pt = MEMC.PageTable[idx];
   if(pt>0)
   {
@@ -574,7 +720,7 @@ static void ARMul_PurgeFastMapPTIdx(ARMul_State *state,ARMword idx)
         break;
     }
     size=12+MEMC.PageSizeFlags;
-    phys = ARMul_ManglePhysAddr(phys<<size);
+    phys = ARMul_ManglePhysAddr(state,phys<<size);
     size = 1<<size;
     entry = FastMap_GetEntryNoWrap(state,logadr);
     
@@ -603,6 +749,7 @@ static void ARMul_PurgeFastMapPTIdx(ARMul_State *state,ARMword idx)
         }
       }
       /* No replacement found, so just nuke this entry */
+      FastMap_Changed(state);
       while(size) {
         if((entry->FlagsAndData<<8) == addr)
           entry->FlagsAndData = 0; /* No need to nuke function pointer */
@@ -613,16 +760,63 @@ static void ARMul_PurgeFastMapPTIdx(ARMul_State *state,ARMword idx)
   }
 }
 
-static void FastMap_DMAAbleWrite(ARMword address,ARMword data)
+static inline bool FastMap_DisplayWatched(ARMul_State *state,ARMword phy)
 {
+  /* Whether writes to this physical address must use an access func */
+  ARMword page = phy>>12;
+  return DisplayDev_UseUpdateFlags && (phy < 512*1024) && (MEMC.DisplayWatch[page>>5] & (UINT32_C(1)<<(page&31)));
+}
+
+static void FastMap_DisplayPageUpdated(ARMul_State *state,ARMword page)
+{
+  uint32_t *flags = MEMC.UpdateFlags+page*(4096/UPDATEBLOCKSIZE);
+  int i;
+  for(i=0;i<4096/UPDATEBLOCKSIZE;i++)
+    flags[i]++;
+}
+
+/* Called for writes to the lower 512K. Returns true if the address is in a
+   watched display page, in which case further writes to it can go direct
+   until it's re-armed */
+static bool FastMap_DMAAbleWrite(ARMul_State *state,ARMword address,ARMword data)
+{
+  ARMword page = address>>12;
+  uint32_t bit = UINT32_C(1)<<(page&31);
   UNUSED_VAR(data);
-  MEMC.UpdateFlags[address/UPDATEBLOCKSIZE]++;
+  if(!DisplayDev_UseUpdateFlags || !(MEMC.DisplayWatch[page>>5] & bit))
+  {
+    MEMC.UpdateFlags[address/UPDATEBLOCKSIZE]++;
+    return false;
+  }
+  if(!(MEMC.DisplayDirty[page>>5] & bit))
+  {
+    /* First write since the page was armed. Direct writes won't be seen until
+       it's re-armed, so the whole page has to be flagged */
+    MEMC.DisplayDirty[page>>5] |= bit;
+    MEMC.FastMapStats.WatchTraps++;
+    FastMap_DisplayPageUpdated(state,page);
+  }
+  else
+    MEMC.UpdateFlags[address/UPDATEBLOCKSIZE]++;
+  return true;
+}
+
+static void FastMap_UnwatchEntry(ARMul_State *state,FastMapEntry *entry)
+{
+  /* Let writes through this logical entry go direct. Entries using a write
+     func never get into the data TLB, and code fetches don't care about
+     write access, so nothing needs invalidating */
+  if(MEMC.NumDisplayUnwatched == DISPLAYWATCH_MAXENTRIES)
+    return;
+  MEMC.DisplayUnwatched[MEMC.NumDisplayUnwatched++] = (uint16_t) (entry-state->FastMap);
+  entry->FlagsAndData &= ~FASTMAP_W_FUNC;
 }
 
 static ARMword FastMap_LogRamFunc(ARMul_State *state, ARMword addr,ARMword data,ARMword flags)
 {
   /* Write to DMAAble log RAM, kinda crappy */
-  ARMword *phy = FastMap_Log2Phy(FastMap_GetEntry(state,addr),addr&~3);
+  FastMapEntry *entry = FastMap_GetEntry(state,addr);
+  ARMword *phy = FastMap_Log2Phy(entry,addr&~3);
   ARMword orig = *phy;
   if(flags & FASTMAP_ACCESSFUNC_BYTE)
   {
@@ -634,13 +828,82 @@ static ARMword FastMap_LogRamFunc(ARMul_State *state, ARMword addr,ARMword data,
   {
     *phy = data;
     FastMap_PhyClobberFunc(state,phy);
-    /* Convert pointer to physical addr, then update DMA flags */
-    addr = (ARMword) (((FastMapUInt)phy)-((FastMapUInt)MEMC.PhysRam));
-    FastMap_DMAAbleWrite(addr,data);
+    /* Convert pointer to physical addr, then update DMA flags. Only the
+       logical mapping gets unwatched, the physical mapping is rarely used */
+    if(FastMap_DMAAbleWrite(state,(ARMword) (((FastMapUInt)phy)-((FastMapUInt)MEMC.PhysRam)),data) && (addr < MEMORY_0x2000000_RAM_PHYS))
+      FastMap_UnwatchEntry(state,entry);
   }
   return 0;
 } 
 
+void ARMul_RearmDisplayWatch(ARMul_State *state)
+{
+  ARMword page, i;
+  uint32_t dirty = 0;
+  for(i=0;i<sizeof(MEMC.DisplayDirty)/sizeof(uint32_t);i++)
+    dirty |= MEMC.DisplayDirty[i];
+  if(!dirty)
+    return;
+
+  /* The pages may have been written to at any point since they were first
+     written to, including after the display last drew them */
+  for(page=0;page<(512*1024)/4096;page++)
+  {
+    if(MEMC.DisplayDirty[page>>5] & (UINT32_C(1)<<(page&31)))
+    {
+      MEMC.FastMapStats.WatchRearms++;
+      FastMap_DisplayPageUpdated(state,page);
+    }
+  }
+  memset(MEMC.DisplayDirty,0,sizeof(MEMC.DisplayDirty));
+
+  /* Put the write func back on the entries that had it removed */
+  for(i=0;i<MEMC.NumDisplayUnwatched;i++)
+  {
+    ARMword addr = ((ARMword) MEMC.DisplayUnwatched[i])<<12;
+    FastMapEntry *entry = FastMap_GetEntryNoWrap(state,addr);
+    FastMapUInt flags = entry->FlagsAndData & FASTMAP_FLAG(0xff);
+    ARMword phy;
+    /* Skip any that have been rebuilt or unmapped since */
+    if((flags & FASTMAP_W_FUNC) || !(flags & (FASTMAP_W_USR|FASTMAP_W_OS|FASTMAP_W_SVC)))
+      continue;
+    phy = (ARMword) (((FastMapUInt)FastMap_Log2Phy(entry,addr))-((FastMapUInt)MEMC.PhysRam));
+    if(FastMap_DisplayWatched(state,phy))
+      FastMap_SetEntries(state,addr,MEMC.PhysRam+(phy>>2),FastMapFunc_LogRam,flags|FASTMAP_W_FUNC,4096);
+  }
+  MEMC.NumDisplayUnwatched = 0;
+}
+
+static void FastMap_CalcDisplayWatch(ARMul_State *state,uint32_t *watch)
+{
+  /* Same range the display drivers update their flags over */
+  ARMword start = MIN(MEMC.Vinit,MEMC.Vstart)<<4;
+  ARMword end = (MEMC.Vend+1)<<4;
+  ARMword page;
+  if(end <= start)
+  {
+    /* Nonsense values, watch everything */
+    start = 0;
+    end = 512*1024;
+  }
+  memset(watch,0,sizeof(MEMC.DisplayWatch));
+  for(page=start>>12;(page<<12)<end;page++)
+    watch[page>>5] |= UINT32_C(1)<<(page&31);
+}
+
+static void ARMul_UpdateDisplayWatch(ARMul_State *state)
+{
+  uint32_t watch[sizeof(MEMC.DisplayWatch)/sizeof(uint32_t)];
+  FastMap_CalcDisplayWatch(state,watch);
+  if(!memcmp(watch,MEMC.DisplayWatch,sizeof(watch)))
+    return;
+  memcpy(MEMC.DisplayWatch,watch,sizeof(watch));
+  /* The rebuild sorts out the write funcs of every entry */
+  MEMC.NumDisplayUnwatched = 0;
+  if(DisplayDev_UseUpdateFlags)
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
+}
+
 static void ARMul_RebuildFastMapPTIdx(ARMul_State *state, ARMword idx)
 {
   int32_t pt;
@@ -685,13 +948,20 @@ static void ARMul_RebuildFastMapPTIdx(ARMul_State *state, ARMword idx)
         break;
     }
     size=12+MEMC.PageSizeFlags;
-    phys = ARMul_ManglePhysAddr(phys<<size);
+    phys = ARMul_ManglePhysAddr(state,phys<<size);
     size = 1<<size;
     flags = PPL_To_Flags[(pt>>8)&3];
     if((phys<512*1024) && DisplayDev_UseUpdateFlags)
     {
-      /* DMAable, must use func on write */
-      FastMap_SetEntries(state,logadr,MEMC.PhysRam+(phys>>2),FastMap_LogRamFunc,flags|FASTMAP_W_FUNC,size);
+      /* DMAable, pages the display is using must use func on write */
+      ARMword i;
+      for(i=0;i<size;i+=4096)
+      {
+        if(FastMap_DisplayWatched(state,phys+i))
+          FastMap_SetEntries(state,logadr+i,MEMC.PhysRam+((phys+i)>>2),FastMapFunc_LogRam,flags|FASTMAP_W_FUNC,4096);
+        else
+          FastMap_SetEntries(state,logadr+i,MEMC.PhysRam+((phys+i)>>2),0,flags,4096);
+      }
     }
     else
     {
@@ -716,32 +986,35 @@ static void DMA_PutVal(ARMul_State *state,ARMword address)
       case 0: /* Vinit */
         if(MEMC.Vinit != RegVal)
         {
-          MEMC.Vinit = RegVal;
           (DisplayDev_Current->DAGWrite)(state,RegNum,RegVal);
+          MEMC.Vinit = RegVal;
+          ARMul_UpdateDisplayWatch(state);
         }
         break;
 
       case 1: /* Vstart */
         if(MEMC.Vstart != RegVal)
         {
-          MEMC.Vstart = RegVal;
           (DisplayDev_Current->DAGWrite)(state,RegNum,RegVal);
+          MEMC.Vstart = RegVal;
+          ARMul_UpdateDisplayWatch(state);
         }
         break;
 
       case 2: /* Vend */
         if(MEMC.Vend != RegVal)
         {
-          MEMC.Vend = RegVal;
           (DisplayDev_Current->DAGWrite)(state,RegNum,RegVal);
+          MEMC.Vend = RegVal;
+          ARMul_UpdateDisplayWatch(state);
         }
         break;
 
       case 3: /* Cinit */
         if(MEMC.Cinit != RegVal)
         {
-          MEMC.Cinit = RegVal;
           (DisplayDev_Current->DAGWrite)(state,RegNum,RegVal);
+          MEMC.Cinit = RegVal;
         }
         break;
 
@@ -749,7 +1022,7 @@ static void DMA_PutVal(ARMul_State *state,ARMword address)
         MEMC.Sstart = RegVal;
         /* The data sheet does not define what happens if you write start before end. */
         MEMC.NextSoundBufferValid = true;
-        ioc.IRQStatus &= ~IRQB_SIRQ; /* Take sound interrupt off */
+        IOC.IRQStatus &= ~IRQB_SIRQ; /* Take sound interrupt off */
         IO_UpdateNirq(state);
         dbug_memc("Write to MEMC Sstart register\n");
         break;
@@ -771,7 +1044,7 @@ static void DMA_PutVal(ARMul_State *state,ARMword address)
           MEMC.SendN = swap;
           MEMC.SstartC = MEMC.Sptr;
           MEMC.NextSoundBufferValid = false;
-          ioc.IRQStatus |= IRQB_SIRQ; /* Take sound interrupt on */
+          IOC.IRQStatus |= IRQB_SIRQ; /* Take sound interrupt on */
           IO_UpdateNirq(state);
         }
         break;
@@ -780,10 +1053,26 @@ static void DMA_PutVal(ARMul_State *state,ARMword address)
         dbug_memc("MEMC Control register set to 0x%"PRIx32" by PC=0x%"PRIx32" R[15]=0x%"PRIx32"\n",
                   address, state->pc, state->Reg[15]);
         MEMC.ControlReg = RegVal;
-        MEMC.PageSizeFlags = (MEMC.ControlReg & 3);
-        state->OSmode = (MEMC.ControlReg&(1<<10));
-        FastMap_RebuildMapMode(state);
-        ARMul_RebuildFastMap(state);
+        MEMC.FastMapStats.ControlWrites++;
+        /* Most writes just toggle video/sound DMA, so only update what's
+           changed. OS mode only affects the access mode mask, while the
+           page size affects the RAM mappings */
+        if((state->OSmode == ((MEMC.ControlReg&(1<<10)) != 0)) &&
+           (MEMC.PageSizeFlags == (MEMC.ControlReg & 3)))
+        {
+          MEMC.FastMapStats.ControlSkips++;
+          break;
+        }
+        if(state->OSmode != ((MEMC.ControlReg&(1<<10)) != 0))
+        {
+          state->OSmode = ((MEMC.ControlReg&(1<<10)) != 0);
+          FastMap_RebuildMapMode(state);
+        }
+        if(MEMC.PageSizeFlags != (MEMC.ControlReg & 3))
+        {
+          MEMC.PageSizeFlags = (MEMC.ControlReg & 3);
+          ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
+        }
         break;
     }
 }
@@ -792,6 +1081,7 @@ static void MEMC_PutVal(ARMul_State *state, ARMword address)
 {
     /* Logical-to-physical address translation */
     unsigned tmp;
+    uint64_t entries = MEMC.FastMapStats.Entries;
 
     tmp = address - MEMORY_0x3800000_W_LOG2PHYS;
 
@@ -800,6 +1090,9 @@ static void MEMC_PutVal(ARMul_State *state, ARMword address)
     ARMul_PurgeFastMapPTIdx(state,address); /* Unmap old value */
     MEMC.PageTable[address] = tmp & 0x0fffffff;
     ARMul_RebuildFastMapPTIdx(state, address); /* Map in new value */
+
+    MEMC.FastMapStats.PTUpdates++;
+    MEMC.FastMapStats.PTEntries += MEMC.FastMapStats.Entries-entries;
 }
 
 static ARMword FastMap_ROMMap1Func(ARMul_State *state, ARMword addr,ARMword data,ARMword flags)
@@ -808,7 +1101,7 @@ static ARMword FastMap_ROMMap1Func(ARMul_State *state, ARMword addr,ARMword data
   UNUSED_VAR(data);
   UNUSED_VAR(flags);
   MEMC.ROMMapFlag = MapFlag_UnaccessedROM;
-  ARMul_RebuildFastMap(state);
+  ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   return MEMC.ROMHigh[(addr & MEMC.ROMHighMask)>>2];
 }
 
@@ -819,7 +1112,7 @@ static ARMword FastMap_PhysRamFuncROMMap2(ARMul_State *state, ARMword addr,ARMwo
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     MEMC.ROMMapFlag = MapFlag_Normal;
-    ARMul_RebuildFastMap(state);
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   }
   phy = FastMap_Log2Phy(FastMap_GetEntry(state,addr),addr&~3);
   if(!(flags & FASTMAP_ACCESSFUNC_WRITE))
@@ -834,7 +1127,7 @@ static ARMword FastMap_PhysRamFuncROMMap2(ARMul_State *state, ARMword addr,ARMwo
   *phy = data;
   FastMap_PhyClobberFunc(state,phy);
   if(addr < 512*1024)
-    FastMap_DMAAbleWrite(addr,data);
+    FastMap_DMAAbleWrite(state,addr,data);
   return 0;
 }
 
@@ -856,7 +1149,7 @@ static ARMword FastMap_PhysRamFunc(ARMul_State *state, ARMword addr,ARMword data
     *phy = data;
     FastMap_PhyClobberFunc(state,phy);
     /* Update DMA flags */
-    FastMap_DMAAbleWrite(addr,data);
+    FastMap_DMAAbleWrite(state,addr,data);
   }
   return 0;
 }
@@ -869,7 +1162,7 @@ static ARMword FastMap_ConIOFunc(ARMul_State *state, ARMword addr,ARMword data,A
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     MEMC.ROMMapFlag = MapFlag_Normal;
-    ARMul_RebuildFastMap(state);
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   }
   if(flags & FASTMAP_ACCESSFUNC_WRITE)
   {
@@ -887,7 +1180,7 @@ static ARMword FastMap_VIDCFunc(ARMul_State *state, ARMword addr,ARMword data,AR
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     MEMC.ROMMapFlag = MapFlag_Normal;
-    ARMul_RebuildFastMap(state);
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   }
   if(flags & FASTMAP_ACCESSFUNC_WRITE)
   {
@@ -911,7 +1204,7 @@ static ARMword FastMap_DMAFunc(ARMul_State *state, ARMword addr,ARMword data,ARM
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     MEMC.ROMMapFlag = MapFlag_Normal;
-    ARMul_RebuildFastMap(state);
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   }
   if(flags & FASTMAP_ACCESSFUNC_WRITE)
   {
@@ -935,7 +1228,7 @@ static ARMword FastMap_MEMCFunc(ARMul_State *state, ARMword addr,ARMword data,AR
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     MEMC.ROMMapFlag = MapFlag_Normal;
-    ARMul_RebuildFastMap(state);
+    ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM|FASTMAP_REGION_ROM);
   }
   if(flags & FASTMAP_ACCESSFUNC_WRITE)
   {
@@ -951,12 +1244,10 @@ static ARMword FastMap_MEMCFunc(ARMul_State *state, ARMword addr,ARMword data,AR
   return data;
 }
 
-void ARMul_RebuildFastMap(ARMul_State *state)
+static void FastMap_RebuildLogical(ARMul_State *state)
 {
   ARMword i;
-  FastMapEntry *entry;
-  
-  /* completely rebuild the fast map */
+
   switch(MEMC.ROMMapFlag)
   {
   case MapFlag_Normal:
@@ -970,7 +1261,7 @@ void ARMul_RebuildFastMap(ARMul_State *state)
     break;
   case MapFlag_UnaccessedLow:
     /* Map ROM to 0x0, using access func, even though we know the very first thing the processor will do is fetch from 0x0 and transition us away... */
-    FastMap_SetEntries_Repeat(state,0,0,FastMap_ROMMap1Func,FASTMAP_R_USR|FASTMAP_R_OS|FASTMAP_R_SVC|FASTMAP_R_FUNC,MEMC.ROMHighSize,0x800000);
+    FastMap_SetEntries_Repeat(state,0,0,FastMapFunc_ROMMap1,FASTMAP_R_USR|FASTMAP_R_OS|FASTMAP_R_SVC|FASTMAP_R_FUNC,MEMC.ROMHighSize,0x800000);
     FastMap_SetEntries(state,0x800000,0,0,0,0x1800000);
     break;
   case MapFlag_UnaccessedROM:
@@ -979,31 +1270,35 @@ void ARMul_RebuildFastMap(ARMul_State *state)
     FastMap_SetEntries(state,0x800000,0,0,0,0x1800000);
     break;
   }
+}
+
+static void FastMap_RebuildPhysRam(ARMul_State *state)
+{
+  ARMword i;
 
-  /* Map physical RAM */
   if(MEMC.ROMMapFlag == MapFlag_UnaccessedROM)
   {
     /* Use access func for all of it */
-    FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS,0,FastMap_PhysRamFuncROMMap2,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_R_FUNC|FASTMAP_W_FUNC,16*1024*1024);
+    FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS,0,FastMapFunc_PhysRamROMMap2,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_R_FUNC|FASTMAP_W_FUNC,16*1024*1024);
   }
   else
   {
     for(i=0;i<16*1024*1024;i+=4096)
     {
-      ARMword phy = ARMul_ManglePhysAddr(i);
-      if((phy < 512*1024) && DisplayDev_UseUpdateFlags)
+      ARMword phy = ARMul_ManglePhysAddr(state,i);
+      if(FastMap_DisplayWatched(state,phy))
       {
-        /* Lower 512K must use access func for write
+        /* Pages the display is using must use access func for write
            But we can use a fast function (for when the OS has correctly detected our RAM setup) or a slow one. */
         if(i == phy)
         {
           /* Direct mapping, use fast func */
-          FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS+i,MEMC.PhysRam+(phy>>2),FastMap_PhysRamFunc,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_W_FUNC,4096);
+          FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS+i,MEMC.PhysRam+(phy>>2),FastMapFunc_PhysRam,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_W_FUNC,4096);
         }
         else
         {
           /* Indirect mapping, reuse LogRamFunc */
-          FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS+i,MEMC.PhysRam+(phy>>2),FastMap_LogRamFunc,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_W_FUNC,4096);
+          FastMap_SetEntries(state,MEMORY_0x2000000_RAM_PHYS+i,MEMC.PhysRam+(phy>>2),FastMapFunc_LogRam,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_W_FUNC,4096);
         }
       }
       else
@@ -1013,28 +1308,65 @@ void ARMul_RebuildFastMap(ARMul_State *state)
       }
     }
   }
+}
 
-  /* I/O space */
-  FastMap_SetEntries(state,MEMORY_0x3000000_CON_IO,0,FastMap_ConIOFunc,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_R_FUNC|FASTMAP_W_FUNC,0x400000);
+static void FastMap_RebuildROM(ARMul_State *state)
+{
+#ifndef ARMUL_FASTMAP_FUNC_INDEX
+  ARMword i;
+  FastMapEntry *entry;
+#endif
 
   /* ROM Low/VIDC/DMA */
   /* Make life easier for ourselves by mapping in everything as DMA then overwriting with VIDC */
   if(MEMC.ROMLow && (MEMC.ROMMapFlag != MapFlag_UnaccessedROM))
-    FastMap_SetEntries_Repeat(state,MEMORY_0x3400000_R_ROM_LOW,MEMC.ROMLow,FastMap_DMAFunc,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC,MEMC.ROMLowSize,0x400000);
+    FastMap_SetEntries_Repeat(state,MEMORY_0x3400000_R_ROM_LOW,MEMC.ROMLow,FastMapFunc_DMA,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC,MEMC.ROMLowSize,0x400000);
   else
-    FastMap_SetEntries(state,MEMORY_0x3400000_R_ROM_LOW,0,FastMap_DMAFunc,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC|FASTMAP_R_FUNC,0x400000);
+    FastMap_SetEntries(state,MEMORY_0x3400000_R_ROM_LOW,0,FastMapFunc_DMA,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC|FASTMAP_R_FUNC,0x400000);
 
   /* Overwrite with VIDC */
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+  memset(&state->FastMapFuncs[MEMORY_0x3400000_W_VIDEOCON>>12],FastMapFunc_VIDC,(MEMORY_0x3600000_W_DMA_GEN-MEMORY_0x3400000_W_VIDEOCON)>>12);
+#else
   entry = FastMap_GetEntryNoWrap(state,MEMORY_0x3400000_W_VIDEOCON);
   for(i=0;i<MEMORY_0x3600000_W_DMA_GEN-MEMORY_0x3400000_W_VIDEOCON;i+=4096)
   {
     entry->AccessFunc = FastMap_VIDCFunc;
     entry++;
   }
+#endif
+  MEMC.FastMapStats.Entries += (MEMORY_0x3600000_W_DMA_GEN-MEMORY_0x3400000_W_VIDEOCON)>>12;
 
   /* ROM High/MEMC */
   if(MEMC.ROMHigh && (MEMC.ROMMapFlag != MapFlag_UnaccessedROM))
-    FastMap_SetEntries_Repeat(state,MEMORY_0x3800000_R_ROM_HIGH,MEMC.ROMHigh,FastMap_MEMCFunc,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC,MEMC.ROMHighSize,0x800000);
+    FastMap_SetEntries_Repeat(state,MEMORY_0x3800000_R_ROM_HIGH,MEMC.ROMHigh,FastMapFunc_MEMC,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC,MEMC.ROMHighSize,0x800000);
   else
-    FastMap_SetEntries(state,MEMORY_0x3800000_R_ROM_HIGH,0,FastMap_MEMCFunc,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC|FASTMAP_R_FUNC,0x800000);
+    FastMap_SetEntries(state,MEMORY_0x3800000_R_ROM_HIGH,0,FastMapFunc_MEMC,FASTMAP_R_USR|FASTMAP_R_SVC|FASTMAP_R_OS|FASTMAP_W_SVC|FASTMAP_W_FUNC|FASTMAP_R_FUNC,0x800000);
+}
+
+void ARMul_RebuildFastMapRegions(ARMul_State *state, unsigned int regions)
+{
+  uint64_t entries = MEMC.FastMapStats.Entries;
+
+  if(regions & FASTMAP_REGION_LOGICAL)
+    FastMap_RebuildLogical(state);
+
+  if(regions & FASTMAP_REGION_PHYSRAM)
+    FastMap_RebuildPhysRam(state);
+
+  /* I/O space */
+  if(regions & FASTMAP_REGION_IO)
+    FastMap_SetEntries(state,MEMORY_0x3000000_CON_IO,0,FastMapFunc_ConIO,FASTMAP_R_SVC|FASTMAP_W_SVC|FASTMAP_R_FUNC|FASTMAP_W_FUNC,0x400000);
+
+  if(regions & FASTMAP_REGION_ROM)
+    FastMap_RebuildROM(state);
+
+  MEMC.FastMapStats.Rebuilds++;
+  MEMC.FastMapStats.RebuildEntries += MEMC.FastMapStats.Entries-entries;
+}
+
+void ARMul_RebuildFastMap(ARMul_State *state)
+{
+  /* completely rebuild the fast map */
+  ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_ALL);
 }
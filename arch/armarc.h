@@ -5,10 +5,15 @@
 #include "../armdefs.h"
 #include "archio.h"
 #include "fdc1772.h"
+#include "filecalls.h"
 #ifdef SOUND_SUPPORT
 #include "sound.h"
 #endif
 
+/* Max number of logical FastMap entries which can have display write watching
+   lifted at once. Any more keep using the access func until re-armed */
+#define DISPLAYWATCH_MAXENTRIES 256
+
 /* Memory map locations */
 #define MEMORY_0x3800000_R_ROM_HIGH   0x3800000  /* Some sections of the memory map    */
 #define MEMORY_0x3800000_W_LOG2PHYS   0x3800000  /* have different functions when read */
@@ -68,23 +73,70 @@ struct MEMCStruct {
   PageSize DRAMPageSize; /* Page size we pretend our DRAM is */
   PageSize PageSizeFlags;
 
-  /* Fastmap memory block pointers */
+  /* Fastmap memory block pointers (from Memory_AllocHuge) */
   void *ROMRAMChunk;
+  size_t ROMRAMChunkSize;
+  MemoryBacking ROMRAMBacking;
 #ifdef ARMUL_INSTR_FUNC_CACHE
   void *EmuFuncChunk;
+  size_t EmuFuncChunkSize;
+  MemoryBacking EmuFuncBacking;
 #endif
+  size_t FastMapSize; /* Size of state->FastMap */
+  MemoryBacking FastMapBacking;
 
   int32_t PageTable[512]; /* Good old fashioned MEMC1 page table */
 
   uint32_t UpdateFlags[(512*1024)/UPDATEBLOCKSIZE]; /* One flag for
                                                        each block of DMAble RAM
                                                        incremented on a write */
-};
 
+  /* Write watching of the DMAable RAM the display is using, one bit per 4K
+     page. See ARMul_RearmDisplayWatch */
+  uint32_t DisplayWatch[(512*1024)/(4096*32)]; /* Pages covered by Vinit/Vstart to Vend */
+  uint32_t DisplayDirty[(512*1024)/(4096*32)]; /* Watched pages written to since they were last armed */
+  uint16_t DisplayUnwatched[DISPLAYWATCH_MAXENTRIES]; /* Logical FastMap entries which have had their write func removed */
+  uint_fast16_t NumDisplayUnwatched;
+
+  /* FastMap maintenance counters */
+  struct {
+    uint64_t Entries;        /* Total entries written */
+    uint64_t Rebuilds;       /* Region rebuilds */
+    uint64_t RebuildEntries; /* Entries written by region rebuilds */
+    uint64_t PTUpdates;      /* Page table writes */
+    uint64_t PTEntries;      /* Entries written by page table writes */
+    uint64_t ControlWrites;  /* Control register writes */
+    uint64_t ControlSkips;   /* Control register writes which didn't need a rebuild */
+    uint64_t WatchTraps;     /* First writes to watched display pages */
+    uint64_t WatchRearms;    /* Watched display pages re-armed after being written to */
+  } FastMapStats;
+};
 
-extern struct MEMCStruct memc;
 
-#define MEMC (memc)
+#define MEMC (*(state->Memc))
+
+/* FastMap regions, for ARMul_RebuildFastMapRegions */
+#define FASTMAP_REGION_LOGICAL 1 /* Logically mapped RAM, 0x0-0x1ffffff */
+#define FASTMAP_REGION_PHYSRAM 2 /* Physically mapped RAM, 0x2000000-0x2ffffff */
+#define FASTMAP_REGION_IO      4 /* I/O, 0x3000000-0x33fffff */
+#define FASTMAP_REGION_ROM     8 /* ROM/VIDC/DMA/MEMC, 0x3400000-0x3ffffff */
+#define FASTMAP_REGION_RAM     (FASTMAP_REGION_LOGICAL|FASTMAP_REGION_PHYSRAM)
+#define FASTMAP_REGION_ALL     (FASTMAP_REGION_RAM|FASTMAP_REGION_IO|FASTMAP_REGION_ROM)
+
+/* Rebuild the given regions of the FastMap, after changing something they
+   depend on. The RAM regions depend on ROMMapFlag, the page size, the page
+   tables, DisplayDev_UseUpdateFlags and MEMC.DisplayWatch. The ROM region
+   depends on ROMMapFlag. The I/O region never changes */
+void ARMul_RebuildFastMapRegions(ARMul_State *state, unsigned int regions);
+
+/* Writes to the pages of DMAable RAM the display is using go via an access
+   func while DisplayDev_UseUpdateFlags is set, everything else is direct. The
+   first write to a page bumps MEMC.UpdateFlags for the whole page and lets
+   further writes through that FastMap entry go direct. The display must call
+   this once per frame, between drawing its last row and its first row of the
+   next frame, to bump the flags of the pages written to since and start
+   watching them again */
+void ARMul_RearmDisplayWatch(ARMul_State *state);
 
 void ARMul_RebuildFastMap(ARMul_State *state);
 
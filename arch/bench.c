@@ -0,0 +1,333 @@
+/*
+  arch/bench.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Benchmark support, for --headless, --cycles and --seconds.
+
+  An event fires every 1/100th of an emulated second, i.e. every
+  ARMul_EmuRate/100 cycles. This is the same timebase used by the IOC timers,
+  VSync and sound DMA, so "emulated seconds" are the seconds the guest sees.
+  Since ARMul_EmuRate tracks the speed of the host, an emulated second will be
+  roughly one host second once the rate has settled. Use --cycles for a fixed
+  amount of guest work.
+
+  The event also keeps a 64bit total of the cycle counter (ARMul_Time wraps
+  every few minutes) and records ARMul_EmuRate once per emulated second, so
+  that its convergence can be reported.
+
+  Once the limit is reached, all the counters are snapshotted and the emulator
+  is asked to exit, so the figures cover exactly the requested period.
+
+  Host CPU time is measured per-thread where possible (see ARMul_HostClock),
+  so each machine in a multi-machine process reports its own figures.
+
+  With --bench-micro, the cost of taking an IRQ and returning from it is also
+  measured, by calling ARMul_Abort and writing back the old R15 in a loop.
+  This exercises the register bank switching and memory map mode changes that
+  interrupt-heavy guests pay for, without depending on the ROM. It runs when
+  the results are reported, once the emulator has stopped, so that it neither
+  delays startup nor disturbs a machine which is still being initialised.
+
+  The throughput of each of the display row conversion kernels (see
+  rowkernels.h) is measured along with it, converting rows of pseudo-random
+  pixels, and their output is checked against the C versions.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../armdefs.h"
+#include "../armemu.h"
+#include "../eventq.h"
+#include "ArcemConfig.h"
+#include "armarc.h"
+#include "bench.h"
+#include "dbugsys.h"
+#include "displaydev.h"
+#include "rowkernels.h"
+
+#define BENCH_MAX_SAMPLES 3600 /* Seconds of EmuRate history to keep */
+#define BENCH_CONVERGED_PCT 2 /* Max % deviation from final EmuRate to be considered converged */
+#define BENCH_IRQ_LOOPS 200000 /* Iterations of the IRQ entry/exit microbenchmark */
+#define BENCH_ROW_PIXELS 640 /* Source pixels per row for the row kernel microbenchmark */
+#define BENCH_ROW_MINTIME (CLOCKS_PER_SEC/200) /* Minimum time to run each row kernel for */
+
+typedef struct {
+  uint64_t Cycles;
+  uint64_t Instrs;
+  uint64_t EventDispatches;
+  uint64_t FramesRendered;
+  uint64_t FramesSkipped;
+  uint32_t Centisecs; /* Emulated time */
+  clock_t HostTime;
+} BenchCounters;
+
+struct BenchStruct {
+  bool Done;
+  CycleCount LastCycle;
+  uint64_t NextTick; /* Now.Cycles value for the next 1/100th second tick */
+  BenchCounters Start, Now;
+  uint32_t EmuRates[BENCH_MAX_SAMPLES];
+  uint32_t NumEmuRates;
+  uint32_t InitialEmuRate;
+  double IRQNanosUSR, IRQNanosSVC; /* IRQ entry+exit cost, from each mode */
+  double RowMpix[4][2][2][4]; /* Row kernel throughput, indexed as per RowKernels_Sets & RowKernelSet.Kernels. 0 if no kernel, -1 if its output was wrong */
+};
+
+#define BENCH (*(state->Bench))
+
+static const char *Bench_BackingName(MemoryBacking backing)
+{
+  switch(backing)
+  {
+  case MemoryBacking_HugeTransparent: return "huge (transparent)";
+  case MemoryBacking_HugeExplicit: return "huge (explicit)";
+  default: return "normal";
+  }
+}
+
+/* Time an IRQ being taken and returned from (as per SUBS PC,R14,#4) while
+   in the given mode. The registers are put back afterwards */
+static double Bench_IRQCost(ARMul_State *state,ARMword mode)
+{
+  ARMword reg[16], regbank[4][16];
+  ARMword r15;
+  clock_t start;
+  uint32_t i;
+
+  memcpy(reg,state->Reg,sizeof(reg));
+  memcpy(regbank,state->RegBank,sizeof(regbank));
+  ARMul_SetR15(state,(reg[15] & ~R15MODEBITS) | mode);
+  r15 = state->Reg[15];
+
+  start = ARMul_HostClock();
+  for(i=0;i<BENCH_IRQ_LOOPS;i++)
+  {
+    ARMul_Abort(state,ARMul_IRQV);
+    ARMul_SetR15(state,r15);
+  }
+  start = ARMul_HostClock()-start;
+
+  ARMul_SetR15(state,reg[15]);
+  memcpy(state->Reg,reg,sizeof(reg));
+  memcpy(state->RegBank,regbank,sizeof(regbank));
+  return (((double) start)*1e9)/(((double) CLOCKS_PER_SEC)*BENCH_IRQ_LOOPS);
+}
+
+/* Measure a row kernel, in millions of source pixels per second. Returns -1
+   if its output doesn't match the reference kernel */
+static double Bench_RowKernel(RowKernel kernel,RowKernel reference,unsigned int hostscale)
+{
+  ARMword in[BENCH_ROW_PIXELS/4];
+  uint32_t palette[256];
+  uint32_t out[2][BENCH_ROW_PIXELS*2];
+  uint32_t seed = 1;
+  uint32_t i, rows = 16;
+  clock_t start;
+
+  for(i=0;i<BENCH_ROW_PIXELS/4;i++)
+    in[i] = seed = seed*1103515245+12345;
+  for(i=0;i<256;i++)
+    palette[i] = seed = seed*1103515245+12345;
+
+  memset(out,0,sizeof(out));
+  (reference)(out[0],in,BENCH_ROW_PIXELS,palette);
+  (kernel)(out[1],in,BENCH_ROW_PIXELS,palette);
+  if(memcmp(out[0],out[1],(BENCH_ROW_PIXELS<<hostscale)*2))
+    return -1;
+
+  /* Keep doubling the number of rows until it takes long enough to time */
+  for(;;)
+  {
+    start = ARMul_HostClock();
+    for(i=0;i<rows;i++)
+      (kernel)(out[1],in,BENCH_ROW_PIXELS,palette);
+    start = ARMul_HostClock()-start;
+    if(start >= BENCH_ROW_MINTIME)
+      break;
+    rows *= 2;
+  }
+  return (((double) rows)*BENCH_ROW_PIXELS*CLOCKS_PER_SEC)/(((double) start)*1e6);
+}
+
+static void Bench_RowKernels(ARMul_State *state)
+{
+  uint32_t i, h, s, b;
+  for(i=0;RowKernels_Sets[i];i++)
+    for(h=0;h<2;h++)
+      for(s=0;s<2;s++)
+        for(b=0;b<4;b++)
+          if(RowKernels_Sets[i]->Kernels[h][s][b])
+            BENCH.RowMpix[i][h][s][b] = Bench_RowKernel(RowKernels_Sets[i]->Kernels[h][s][b],RowKernels_Sets[0]->Kernels[h][s][b],h+s);
+}
+
+static void Bench_Snapshot(ARMul_State *state,BenchCounters *c)
+{
+  c->Instrs = state->NumInstrs;
+  c->EventDispatches = state->EventDispatches;
+  c->FramesRendered = DisplayDev_FramesRendered;
+  c->FramesSkipped = DisplayDev_FramesSkipped;
+  c->HostTime = ARMul_HostClock();
+}
+
+static CycleCount Bench_NextDelay(ARMul_State *state)
+{
+  /* Wake up for the next tick, or the cycle limit, whichever is sooner */
+  uint64_t next = BENCH.NextTick;
+  if(CONFIG.iBenchCycles && !BENCH.Done && (CONFIG.iBenchCycles < next))
+    next = CONFIG.iBenchCycles;
+  return (CycleCount) (next-BENCH.Now.Cycles);
+}
+
+static void Bench_Event(ARMul_State *state,CycleCount nowtime)
+{
+  BENCH.Now.Cycles += (CycleCount) (nowtime-BENCH.LastCycle);
+  BENCH.LastCycle = nowtime;
+
+  while(BENCH.Now.Cycles >= BENCH.NextTick)
+  {
+    BENCH.NextTick += MAX(ARMul_EmuRate/100,1);
+    if(!(++BENCH.Now.Centisecs % 100) && (BENCH.NumEmuRates < BENCH_MAX_SAMPLES))
+      BENCH.EmuRates[BENCH.NumEmuRates++] = ARMul_EmuRate;
+  }
+
+  if(!BENCH.Done &&
+     ((CONFIG.iBenchCycles && (BENCH.Now.Cycles >= CONFIG.iBenchCycles)) ||
+      (CONFIG.iBenchSeconds && (BENCH.Now.Centisecs >= CONFIG.iBenchSeconds*100))))
+  {
+    Bench_Snapshot(state,&BENCH.Now);
+    BENCH.Done = true;
+    ARMul_Exit(state,0);
+  }
+
+  EventQ_RescheduleHead(state,nowtime+Bench_NextDelay(state),Bench_Event);
+}
+
+void Bench_Init(ARMul_State *state)
+{
+  if(!CONFIG.bHeadless && !CONFIG.iBenchCycles && !CONFIG.iBenchSeconds && !CONFIG.bBenchMicro)
+    return;
+  state->Bench = calloc(1,sizeof(struct BenchStruct));
+  if(!state->Bench)
+  {
+    warn("Couldn't allocate benchmark state, benchmarking disabled\n");
+    return;
+  }
+  BENCH.Done = false;
+  BENCH.LastCycle = ARMul_Time;
+  BENCH.NumEmuRates = 0;
+  BENCH.InitialEmuRate = ARMul_EmuRate;
+  BENCH.Start.Cycles = 0;
+  BENCH.Start.Centisecs = 0;
+  Bench_Snapshot(state,&BENCH.Start);
+  BENCH.Now = BENCH.Start;
+  BENCH.NextTick = MAX(ARMul_EmuRate/100,1);
+  EventQ_Insert(state,ARMul_Time+Bench_NextDelay(state),Bench_Event);
+}
+
+void Bench_Report(ARMul_State *state,FILE *f)
+{
+  BenchCounters d;
+  double hostsecs;
+  uint32_t i, h, s, b, converged;
+  uint32_t finalrate = ARMul_EmuRate;
+
+  if(!state->Bench)
+    return;
+  if(!BENCH.Done)
+  {
+    /* Guest exited by itself */
+    BENCH.Now.Cycles += (CycleCount) (ARMul_Time-BENCH.LastCycle);
+    BENCH.LastCycle = ARMul_Time;
+    Bench_Snapshot(state,&BENCH.Now);
+  }
+
+  d.Cycles = BENCH.Now.Cycles-BENCH.Start.Cycles;
+  d.Instrs = BENCH.Now.Instrs-BENCH.Start.Instrs;
+  d.EventDispatches = BENCH.Now.EventDispatches-BENCH.Start.EventDispatches;
+  d.FramesRendered = BENCH.Now.FramesRendered-BENCH.Start.FramesRendered;
+  d.FramesSkipped = BENCH.Now.FramesSkipped-BENCH.Start.FramesSkipped;
+  d.Centisecs = BENCH.Now.Centisecs-BENCH.Start.Centisecs;
+  hostsecs = ((double) (BENCH.Now.HostTime-BENCH.Start.HostTime))/CLOCKS_PER_SEC;
+
+  /* Find the first second from which EmuRate stayed close to its final value */
+  if(BENCH.NumEmuRates)
+    finalrate = BENCH.EmuRates[BENCH.NumEmuRates-1];
+  converged = BENCH.NumEmuRates;
+  for(i=BENCH.NumEmuRates;i>0;i--)
+  {
+    uint32_t rate = BENCH.EmuRates[i-1];
+    uint32_t diff = (rate > finalrate ? rate-finalrate : finalrate-rate);
+    if(((uint64_t) diff)*100 > ((uint64_t) finalrate)*BENCH_CONVERGED_PCT)
+      break;
+    converged = i-1;
+  }
+
+  /* The emulator has stopped, so the microbenchmarks are free to use the CPU state */
+  if(CONFIG.bBenchMicro)
+  {
+    BENCH.IRQNanosUSR = Bench_IRQCost(state,USER26MODE);
+    BENCH.IRQNanosSVC = Bench_IRQCost(state,SVC26MODE);
+    Bench_RowKernels(state);
+  }
+
+  fprintf(f,"Benchmark results:\n");
+  fprintf(f,"  Emulated cycles:       %"PRIu64"\n",d.Cycles);
+  fprintf(f,"  Emulated time:         %"PRIu32".%02"PRIu32" s\n",d.Centisecs/100,d.Centisecs%100);
+  fprintf(f,"  Host CPU time:         %.3f s\n",hostsecs);
+  fprintf(f,"  Guest instructions:    %"PRIu64"\n",d.Instrs);
+  fprintf(f,"  Guest MIPS:            %.2f\n",(hostsecs > 0 ? d.Instrs/(hostsecs*1e6) : 0.0));
+  fprintf(f,"  Host ns/instruction:   %.2f\n",(d.Instrs ? (hostsecs*1e9)/d.Instrs : 0.0));
+  fprintf(f,"  Event dispatches:      %"PRIu64" (%.1f per emulated second)\n",d.EventDispatches,(d.Centisecs ? (d.EventDispatches*100.0)/d.Centisecs : 0.0));
+  fprintf(f,"  Frames rendered:       %"PRIu64"\n",d.FramesRendered);
+  fprintf(f,"  Frames skipped:        %"PRIu64"\n",d.FramesSkipped);
+#ifdef DISPLAY_THREADS
+  fprintf(f,"  Threaded frames:       %"PRIu64" (waited for %"PRIu64")\n",DisplayDev_ThreadFrames,DisplayDev_ThreadWaits);
+#endif
+  fprintf(f,"  EmuRate initial/final: %"PRIu32" / %"PRIu32" Hz\n",BENCH.InitialEmuRate,finalrate);
+  if(BENCH.NumEmuRates)
+    fprintf(f,"  EmuRate converged:     after %"PRIu32" s (within %d%% of final, %"PRIu32" samples)\n",converged+1,BENCH_CONVERGED_PCT,BENCH.NumEmuRates);
+  else
+    fprintf(f,"  EmuRate converged:     n/a (less than 1 emulated second)\n");
+  if(CONFIG.bBenchMicro)
+  {
+    fprintf(f,"  IRQ entry+exit:        %.1f ns from USR, %.1f ns from SVC\n",BENCH.IRQNanosUSR,BENCH.IRQNanosSVC);
+    fprintf(f,"  Row kernels (Mpix/s):  16bpp 1X  16bpp 2X  32bpp 1X  32bpp 2X\n");
+  }
+  for(i=0;RowKernels_Sets[i];i++)
+    for(b=0;b<4;b++)
+    {
+      if(!BENCH.RowMpix[i][0][0][b] && !BENCH.RowMpix[i][1][0][b])
+        continue;
+      fprintf(f,"    %-4s %dbpp:          ",RowKernels_Sets[i]->Name,1<<b);
+      for(h=0;h<2;h++)
+        for(s=0;s<2;s++)
+        {
+          double mpix = BENCH.RowMpix[i][h][s][b];
+          if(mpix > 0)
+            fprintf(f,"%8.0f  ",mpix);
+          else
+            fprintf(f,"%8s  ",(mpix < 0 ? "WRONG" : "-"));
+        }
+      fprintf(f,"%s\n",(RowKernels[ROWKERNEL_HOST32][ROWKERNEL_1X][b] == RowKernels_Sets[i]->Kernels[ROWKERNEL_HOST32][ROWKERNEL_1X][b] ? "(in use)" : ""));
+    }
+  fprintf(f,"  Page backing:          RAM/ROM %s, FastMap %s",Bench_BackingName(MEMC.ROMRAMBacking),Bench_BackingName(MEMC.FastMapBacking));
+#ifdef ARMUL_INSTR_FUNC_CACHE
+  fprintf(f,", func cache %s",Bench_BackingName(MEMC.EmuFuncBacking));
+#endif
+  fprintf(f,"\n");
+  fprintf(f,"  FastMap rebuilds:      %"PRIu64" (%"PRIu64" entries)\n",MEMC.FastMapStats.Rebuilds,MEMC.FastMapStats.RebuildEntries);
+  fprintf(f,"  FastMap PT updates:    %"PRIu64" (%"PRIu64" entries)\n",MEMC.FastMapStats.PTUpdates,MEMC.FastMapStats.PTEntries);
+  fprintf(f,"  MEMC control writes:   %"PRIu64" (%"PRIu64" needed no rebuild)\n",MEMC.FastMapStats.ControlWrites,MEMC.FastMapStats.ControlSkips);
+  fprintf(f,"  Display page traps:    %"PRIu64" (%"PRIu64" pages re-armed)\n",MEMC.FastMapStats.WatchTraps,MEMC.FastMapStats.WatchRearms);
+  fflush(f);
+}
+
+void Bench_Exit(ARMul_State *state)
+{
+  free(state->Bench);
+  state->Bench = NULL;
+}
@@ -0,0 +1,27 @@
+/*
+  arch/bench.h
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Benchmark support: stops the emulator after a configured number of emulated
+  cycles or seconds, and reports performance figures on exit.
+*/
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include "../armdefs.h"
+
+/* Called by ARMul_MemoryInit. Starts the measurements if running headless,
+   if a cycle/time limit has been set, or if --bench-micro was given */
+extern void Bench_Init(ARMul_State *state);
+
+/* Print the results to the given file. The emulator must be stopped, as
+   this also runs the microbenchmarks if they were asked for */
+extern void Bench_Report(ARMul_State *state,FILE *f);
+
+/* Called by ARMul_MemoryExit. Frees the benchmark state */
+extern void Bench_Exit(ARMul_State *state);
+
+#endif
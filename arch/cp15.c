@@ -1,6 +1,7 @@
 /* (c) Peter Howkins 2006 - see Readme file for copying info
    with assistance from Tom Walker */
 #include "../armdefs.h"
+#include "ControlPane.h"
 
 #ifdef ARMUL_COPRO_SUPPORT
 #include "../armcopro.h"
@@ -17,13 +18,15 @@
 #define ARM3_CP15_REG_4_RW_UPDATABLE_AREAS   4
 #define ARM3_CP15_REG_5_RW_DISRUPTIVE_AREAS  5
 
-static struct
+struct CP15Struct
 {
   ARMword uControlRegister;
   ARMword uCachableAreas;
   ARMword uUpdatableAreas;
   ARMword uDisruptiveAreas;
-} ARM3_CP15_Registers;
+};
+
+#define ARM3_CP15_Registers (*(hState->Cp15))
 
 
 /**
@@ -36,13 +39,33 @@ static struct
  */
 static bool ARM3_Initialise(ARMul_State *hState)
 {
-  UNUSED_VAR(hState);
+  hState->Cp15 = calloc(1,sizeof(struct CP15Struct));
+  if (!hState->Cp15) {
+    ControlPane_Error(false,"Couldn't allocate ARM3 coprocessor");
+    return false;
+  }
 
   ARM3_CP15_Registers.uControlRegister = 0;
 
   return true;
 }
 
+/**
+ * ARM3_Finalise
+ *
+ * Free the ARM3 cpu control coprocessor's registers.
+ *
+ * @param hState Emulator state
+ * @returns Bool of successful finalisation
+ */
+static bool ARM3_Finalise(ARMul_State *hState)
+{
+  free(hState->Cp15);
+  hState->Cp15 = NULL;
+
+  return true;
+}
+
 /**
  * ARM3_RegisterRead
  *
@@ -57,8 +80,6 @@ static bool ARM3_Initialise(ARMul_State *hState)
  */
 static bool ARM3_RegisterRead(ARMul_State *hState, unsigned uReg, ARMword *puValue)
 {
-  UNUSED_VAR(hState);
-
   switch (uReg) {
     case ARM3_CP15_REG_0_RO_PROCESSOR_ID:
       *puValue = ARM3_CPU_ID;
@@ -105,8 +126,6 @@ static bool ARM3_RegisterRead(ARMul_State *hState, unsigned uReg, ARMword *puVal
  */
 static bool ARM3_RegisterWrite(ARMul_State *hState, unsigned uReg, ARMword uValue)
 {
-  UNUSED_VAR(hState);
-
   switch (uReg)
   {
     case ARM3_CP15_REG_0_RO_PROCESSOR_ID:
@@ -199,7 +218,7 @@ static unsigned ARM3_MCRs(ARMul_State *hState, unsigned uType, ARMword instr, AR
 
 static const ARMul_CoPro ARM3CoPro = {
   ARM3_Initialise,    /* CPInit */
-  NULL,               /* CPExit */
+  ARM3_Finalise,      /* CPExit */
   ARMul_NoCoPro4R,    /* LDC */
   ARMul_NoCoPro4W,    /* STC */
   ARM3_MRCs,          /* MRC */
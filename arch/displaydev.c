@@ -10,17 +10,12 @@
   emulator core
 */
 #include "../armdefs.h"
+#include "armarc.h"
 #include "displaydev.h"
 #include "archio.h"
 
 #include <string.h>
 
-const DisplayDev *DisplayDev_Current = NULL;
-
-bool DisplayDev_UseUpdateFlags = true;
-bool DisplayDev_AutoUpdateFlags = false;
-int DisplayDev_FrameSkip = 0;
-
 bool DisplayDev_Set(ARMul_State *state,const DisplayDev *dev)
 {
   struct Vidc_Regs Vidc;
@@ -61,18 +56,23 @@ void DisplayDev_GetCursorPos(ARMul_State *state,int *x,int *y)
 
 static const uint32_t vidcclocks[4] = {24000000,25175000,36000000,24000000};
 
-uint32_t DisplayDev_GetVIDCClockIn(void)
+uint32_t DisplayDev_GetVIDCClockIn(ARMul_State *state)
 {
-  return vidcclocks[ioc.IOEBControlReg & IOEB_CR_VIDC_MASK];
+  return vidcclocks[IOC.IOEBControlReg & IOEB_CR_VIDC_MASK];
 }
 
 void DisplayDev_VSync(ARMul_State *state)
 {
+  /* The display has finished with the frame, start watching for writes to it again */
+  ARMul_RearmDisplayWatch(state);
   /* Trigger VSync */
-  ioc.IRQStatus|=IRQA_VFLYBK;
+  IOC.IRQStatus|=IRQA_VFLYBK;
   IO_UpdateNirq(state);
   /* Update ARMul_EmuRate */
   EmuRate_Update(state);
+  /* Stop at the end of the frame, if asked to */
+  if(state->StopMask & ARMul_Stop_VSync)
+    ARMul_Stop(state,ARMul_Stop_VSync);
 }
 
 
@@ -12,13 +12,13 @@
 #ifndef DISPLAYDEV_H
 #define DISPLAYDEV_H
 
-typedef struct {
+struct DisplayDev {
   bool (*Init)(ARMul_State *state,const struct Vidc_Regs *Vidc); /* Initialise display device, return nonzero on failure */
   void (*Shutdown)(ARMul_State *state); /* Shutdown display device */
   void (*VIDCPutVal)(ARMul_State *state,ARMword address, ARMword data,bool bNw); /* Call made by core to handle writing to VIDC registers */
-  void (*DAGWrite)(ARMul_State *state,uint_fast8_t reg,uint_fast16_t val); /* Call made by core when video DAG registers are updated. reg 0=Vinit, 1=Vstart, 2=Vend, 3=Cinit */
+  void (*DAGWrite)(ARMul_State *state,uint_fast8_t reg,uint_fast16_t val); /* Call made by core when video DAG registers are about to be updated (MEMC still holds the old value). reg 0=Vinit, 1=Vstart, 2=Vend, 3=Cinit */
   void (*IOEBCRWrite)(ARMul_State *state,ARMword val); /* Call made by core when IOEB control register is updated */
-} DisplayDev;
+};
 
 /* Raw VIDC registers */
 struct Vidc_Regs {
@@ -51,26 +51,42 @@ struct Vidc_Regs {
 
 #define VIDC (*(state->Display))
 
-extern const DisplayDev *DisplayDev_Current; /* Pointer to current display device */
-extern bool DisplayDev_UseUpdateFlags; /* Global flag for whether the current device is using MEMC.UpdateFlags */
+/* These are all per-machine, and live in ARMul_State */
+
+#define DisplayDev_Current (state->DisplayDevice) /* Pointer to current display device */
+#define DisplayDev_UseUpdateFlags (state->DisplayUseUpdateFlags) /* Flag for whether the current device is using MEMC.UpdateFlags */
+
+#define DisplayDev_AutoUpdateFlags (state->DisplayAutoUpdateFlags) /* Automatically select whether to use UpdateFlags or not. If true, this causes DisplayDev_UseUpdateFlags and DisplayDev_FrameSkip to be updated automatically. */
 
-extern bool DisplayDev_AutoUpdateFlags; /* Automatically select whether to use UpdateFlags or not. If true, this causes DisplayDev_UseUpdateFlags and DisplayDev_FrameSkip to be updated automatically. */
+#define DisplayDev_FrameSkip (state->DisplayFrameSkip) /* If DisplayDev_UseUpdateFlags is true, this provides a frameskip value used by the standard & palettised drivers. If DisplayDev_UseUpdateFlags is false, it acts as failsafe counter that forces an update when a certain number of frames have passed */
 
-extern int DisplayDev_FrameSkip; /* If DisplayDev_UseUpdateFlags is true, this provides a frameskip value used by the standard & palettised drivers. If DisplayDev_UseUpdateFlags is false, it acts as failsafe counter that forces an update when a certain number of frames have passed */
+#define DisplayDev_FramesRendered (state->DisplayFramesRendered) /* Number of frames the standard & palettised drivers have drawn */
+#define DisplayDev_FramesSkipped (state->DisplayFramesSkipped) /* Number of frames the standard & palettised drivers have skipped due to frameskip */
+
+#define DisplayDev_ThreadFrames (state->DisplayThreadFrames) /* Number of frames the standard driver has handed to its worker threads */
+#define DisplayDev_ThreadWaits (state->DisplayThreadWaits) /* Number of times the standard driver had to wait for its worker threads to finish a frame */
 
 extern bool DisplayDev_Set(ARMul_State *state,const DisplayDev *dev); /* Switch to indicated display device, returns nonzero on failure */
 
 /* Host must provide this function to initialize the default display device */
 extern bool DisplayDev_Init(ARMul_State *state);
 
+/* Display device which renders to an offscreen buffer, for headless use */
+extern const DisplayDev Null_DisplayDev;
+
+/* Get the offscreen buffer of the null display device, as 0x00RRGGBB pixels,
+   width*height in size. Returns NULL if it isn't the current device, or no
+   mode has been set up yet */
+extern const uint32_t *NullDisplayDev_GetBuffer(ARMul_State *state,int *width,int *height);
+
 extern void DisplayDev_Shutdown(ARMul_State *state);
 
 /* Calculate cursor position relative to the first display pixel */
 extern void DisplayDev_GetCursorPos(ARMul_State *state,int *x,int *y);
 
-extern uint32_t DisplayDev_GetVIDCClockIn(void); /* Get VIDC source clock rate (affected by IOEB CR) */
+extern uint32_t DisplayDev_GetVIDCClockIn(ARMul_State *state); /* Get VIDC source clock rate (affected by IOEB CR) */
 
-extern void DisplayDev_VSync(ARMul_State *state); /* Trigger VSync interrupt & update ARMul_EmuRate. Note: Manipulates event queue! */
+extern void DisplayDev_VSync(ARMul_State *state); /* Trigger VSync interrupt, update ARMul_EmuRate & stop the emulator if ARMul_Stop_VSync is enabled. Note: Manipulates event queue! */
 
 /* General endian swapping/endian-aware memcpy functions */
 
@@ -0,0 +1,167 @@
+/*
+  arch/displaythreads.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Display worker thread pool, see displaythreads.h.
+
+  Jobs are small (a few hundred rows, started once per frame), so everything
+  is protected by one mutex. Workers take the next batch of items under the
+  lock, and process it with the lock released. The last worker to finish a
+  batch once all the items have been handed out signals the waiting thread.
+*/
+
+#include <stdlib.h>
+
+#include "../armdefs.h"
+#include "displaythreads.h"
+
+#ifdef DISPLAY_THREADS
+#include <pthread.h>
+
+struct DisplayThreads {
+  pthread_mutex_t Lock;
+  pthread_cond_t Work; /* Signalled when a job is started, or the pool is being destroyed */
+  pthread_cond_t Done; /* Signalled when the last batch of a job is finished */
+  DisplayThreads_Func Func;
+  void *Arg;
+  int Next; /* Next item to hand out */
+  int Count; /* Number of items in the job */
+  int Batch; /* Max items per batch */
+  int Active; /* Number of batches being processed */
+  bool Quit;
+  int NumThreads;
+  pthread_t *Threads;
+};
+
+static void *DisplayThreads_Worker(void *arg)
+{
+  DisplayThreads *pool = (DisplayThreads *) arg;
+  pthread_mutex_lock(&pool->Lock);
+  for(;;)
+  {
+    int first, count;
+    while(!pool->Quit && (pool->Next >= pool->Count))
+      pthread_cond_wait(&pool->Work,&pool->Lock);
+    if(pool->Quit)
+      break;
+    first = pool->Next;
+    count = MIN(pool->Batch,pool->Count-first);
+    pool->Next += count;
+    pool->Active++;
+    pthread_mutex_unlock(&pool->Lock);
+
+    (pool->Func)(pool->Arg,first,count);
+
+    pthread_mutex_lock(&pool->Lock);
+    if(!--pool->Active && (pool->Next >= pool->Count))
+      pthread_cond_signal(&pool->Done);
+  }
+  pthread_mutex_unlock(&pool->Lock);
+  return NULL;
+}
+
+DisplayThreads *DisplayThreads_Create(int num)
+{
+  DisplayThreads *pool;
+  if(num < 1)
+    return NULL;
+  pool = (DisplayThreads *) calloc(1,sizeof(DisplayThreads));
+  if(!pool)
+    return NULL;
+  pool->Threads = (pthread_t *) calloc(num,sizeof(pthread_t));
+  if(!pool->Threads)
+  {
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->Lock,NULL);
+  pthread_cond_init(&pool->Work,NULL);
+  pthread_cond_init(&pool->Done,NULL);
+  while(pool->NumThreads < num)
+  {
+    if(pthread_create(&pool->Threads[pool->NumThreads],NULL,DisplayThreads_Worker,pool))
+      break;
+    pool->NumThreads++;
+  }
+  if(!pool->NumThreads)
+  {
+    DisplayThreads_Destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void DisplayThreads_Destroy(DisplayThreads *pool)
+{
+  int i;
+  if(!pool)
+    return;
+  DisplayThreads_Wait(pool);
+  pthread_mutex_lock(&pool->Lock);
+  pool->Quit = true;
+  pthread_cond_broadcast(&pool->Work);
+  pthread_mutex_unlock(&pool->Lock);
+  for(i=0;i<pool->NumThreads;i++)
+    pthread_join(pool->Threads[i],NULL);
+  pthread_cond_destroy(&pool->Done);
+  pthread_cond_destroy(&pool->Work);
+  pthread_mutex_destroy(&pool->Lock);
+  free(pool->Threads);
+  free(pool);
+}
+
+void DisplayThreads_Start(DisplayThreads *pool,DisplayThreads_Func func,void *arg,int count,int batch)
+{
+  pthread_mutex_lock(&pool->Lock);
+  pool->Func = func;
+  pool->Arg = arg;
+  pool->Next = 0;
+  pool->Count = count;
+  pool->Batch = MAX(batch,1);
+  pthread_cond_broadcast(&pool->Work);
+  pthread_mutex_unlock(&pool->Lock);
+}
+
+bool DisplayThreads_Wait(DisplayThreads *pool)
+{
+  bool waited = false;
+  pthread_mutex_lock(&pool->Lock);
+  while((pool->Next < pool->Count) || pool->Active)
+  {
+    waited = true;
+    pthread_cond_wait(&pool->Done,&pool->Lock);
+  }
+  pthread_mutex_unlock(&pool->Lock);
+  return waited;
+}
+
+#else
+
+DisplayThreads *DisplayThreads_Create(int num)
+{
+  UNUSED_VAR(num);
+  return NULL;
+}
+
+void DisplayThreads_Destroy(DisplayThreads *pool)
+{
+  UNUSED_VAR(pool);
+}
+
+void DisplayThreads_Start(DisplayThreads *pool,DisplayThreads_Func func,void *arg,int count,int batch)
+{
+  /* Can't be called, as there's no way to create a pool */
+  UNUSED_VAR(pool);
+  UNUSED_VAR(batch);
+  (func)(arg,0,count);
+}
+
+bool DisplayThreads_Wait(DisplayThreads *pool)
+{
+  UNUSED_VAR(pool);
+  return false;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+  arch/displaythreads.h
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  A small pool of worker threads which a display driver can hand a frame's
+  rows to, so that converting them doesn't hold up the emulator thread (see
+  SDD_DirectRows in stddisplaydev.c).
+
+  Only available if built with DISPLAY_THREADS (which needs pthreads);
+  otherwise DisplayThreads_Create always fails, and the driver draws the rows
+  itself as normal.
+*/
+#ifndef DISPLAYTHREADS_H
+#define DISPLAYTHREADS_H
+
+typedef struct DisplayThreads DisplayThreads;
+
+/* Process items first to first+count-1 of the current job */
+typedef void (*DisplayThreads_Func)(void *arg,int first,int count);
+
+/* Create a pool of 'num' worker threads. Returns NULL on failure */
+extern DisplayThreads *DisplayThreads_Create(int num);
+
+/* Wait for any job to finish, then stop the workers & free the pool */
+extern void DisplayThreads_Destroy(DisplayThreads *pool);
+
+/* Start the workers calling 'func' on items 0 to count-1, in batches of up to
+   'batch' items. Returns straight away. Only one job can be in progress at a
+   time, so call DisplayThreads_Wait first if there might be one */
+extern void DisplayThreads_Start(DisplayThreads *pool,DisplayThreads_Func func,void *arg,int count,int batch);
+
+/* Wait for the current job (if any) to finish. Returns true if it hadn't
+   already */
+extern bool DisplayThreads_Wait(DisplayThreads *pool);
+
+#endif
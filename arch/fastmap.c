@@ -21,11 +21,24 @@ FASTMAP_FUNC ARMword ARMul_LoadWordS(ARMul_State *state,ARMword address)
 	state->NumCycles++;
 	address &= UINT32_C(0x3ffffff);
 
+#ifdef ARMUL_DATA_TLB
+	{
+		ARMword *phy = FastMap_TLBRead(state,address&~UINT32_C(3));
+		if(phy)
+		{
+			ARMul_CLEARABORT;
+			return *phy;
+		}
+	}
+#endif
 	entry = FastMap_GetEntryNoWrap(state,address);
 	res = FastMap_DecodeRead(entry,state->FastMapMode);
 	ARMul_CLEARABORT; /* More likely to clear the abort than not */
 	if(FASTMAP_RESULT_DIRECT(res))
 	{
+#ifdef ARMUL_DATA_TLB
+		FastMap_TLBFill(state,entry,address);
+#endif
 		return *(FastMap_Log2Phy(entry,address&~UINT32_C(3)));
 	}
 	else if(FASTMAP_RESULT_FUNC(res))
@@ -56,11 +69,28 @@ FASTMAP_FUNC ARMword ARMul_LoadByte(ARMul_State *state,ARMword address)
 	state->NumCycles++;
 	address &= UINT32_C(0x3ffffff);
 
+#ifdef ARMUL_DATA_TLB
+	{
+#ifdef HOST_BIGENDIAN
+		ARMword *phy = FastMap_TLBRead(state,address^3);
+#else
+		ARMword *phy = FastMap_TLBRead(state,address);
+#endif
+		if(phy)
+		{
+			ARMul_CLEARABORT;
+			return *((uint8_t*)phy);
+		}
+	}
+#endif
 	entry = FastMap_GetEntryNoWrap(state,address);
 	res = FastMap_DecodeRead(entry,state->FastMapMode);
 	ARMul_CLEARABORT; /* More likely to clear the abort than not */
 	if(FASTMAP_RESULT_DIRECT(res))
 	{
+#ifdef ARMUL_DATA_TLB
+		FastMap_TLBFill(state,entry,address);
+#endif
 #ifdef HOST_BIGENDIAN
 		address ^= 3;
 #endif
@@ -94,6 +124,18 @@ FASTMAP_FUNC void ARMul_StoreWordS(ARMul_State *state, ARMword address, ARMword
 	state->NumCycles++;
 	address &= UINT32_C(0x3ffffff);
 
+#ifdef ARMUL_DATA_TLB
+	{
+		ARMword *phy = FastMap_TLBWrite(state,address&~UINT32_C(3));
+		if(phy)
+		{
+			ARMul_CLEARABORT;
+			*phy = data;
+			FastMap_PhyClobberFunc(state,phy);
+			return;
+		}
+	}
+#endif
 	entry = FastMap_GetEntryNoWrap(state,address);
 	res = FastMap_DecodeWrite(entry,state->FastMapMode);
 /*  dbug("StoreWordS: %08x maps to entry %08x res %08x (mode %08x pc %08x)\n",address,entry,res,MEMC.FastMapMode,state->Reg[15]); */
@@ -101,6 +143,9 @@ FASTMAP_FUNC void ARMul_StoreWordS(ARMul_State *state, ARMword address, ARMword
 	if(FASTMAP_RESULT_DIRECT(res))
 	{
 		ARMword *phy = FastMap_Log2Phy(entry,address&~UINT32_C(3));
+#ifdef ARMUL_DATA_TLB
+		FastMap_TLBFill(state,entry,address);
+#endif
 		*phy = data;
 		FastMap_PhyClobberFunc(state,phy);
 	}
@@ -131,15 +176,35 @@ FASTMAP_FUNC void ARMul_StoreByte(ARMul_State *state, ARMword address, ARMword d
 	state->NumCycles++;
 	address &= UINT32_C(0x3ffffff);
 
+#ifdef ARMUL_DATA_TLB
+	{
+#ifdef HOST_BIGENDIAN
+		ARMword *phy = FastMap_TLBWrite(state,address^3);
+#else
+		ARMword *phy = FastMap_TLBWrite(state,address);
+#endif
+		if(phy)
+		{
+			ARMul_CLEARABORT;
+			*((uint8_t *)phy) = data;
+			FastMap_PhyClobberFunc(state,(ARMword*)(((FastMapUInt)phy)&~((FastMapUInt)3)));
+			return;
+		}
+	}
+#endif
 	entry = FastMap_GetEntryNoWrap(state,address);
 	res = FastMap_DecodeWrite(entry,state->FastMapMode);
 	ARMul_CLEARABORT;
 	if(FASTMAP_RESULT_DIRECT(res))
 	{
+		ARMword *phy;
+#ifdef ARMUL_DATA_TLB
+		FastMap_TLBFill(state,entry,address);
+#endif
 #ifdef HOST_BIGENDIAN
 		address ^= 3;
 #endif
-		ARMword *phy = FastMap_Log2Phy(entry,address);
+		phy = FastMap_Log2Phy(entry,address);
 		*((uint8_t *)phy) = data;
 		FastMap_PhyClobberFunc(state,(ARMword*)(((FastMapUInt)phy)&~((FastMapUInt)3)));
 	}
@@ -11,13 +11,30 @@ static inline FastMapRes FastMap_DecodeRead(const FastMapEntry *entry,FastMapUIn
 static inline FastMapRes FastMap_DecodeWrite(const FastMapEntry *entry,FastMapUInt mode);
 static inline ARMword *FastMap_Log2Phy(const FastMapEntry *entry,ARMword addr);
 #ifdef ARMUL_INSTR_FUNC_CACHE
-static inline ARMEmuFunc *FastMap_Phy2Func(ARMul_State *state,ARMword *addr);
+static inline ARMEmuFuncSlot *FastMap_Phy2Func(ARMul_State *state,ARMword *addr);
 #endif
+#ifdef ARMUL_CODE_PAGE_STATS
+#define CODEPAGE_STAT(STAT,AMT) (state->CodeStats.STAT += (AMT))
+#else
+#define CODEPAGE_STAT(STAT,AMT) ((void)0)
+#endif
+
+#ifdef ARMUL_CODE_PAGES
+static inline CodePage *FastMap_Phy2CodePage(ARMul_State *state,const ARMword *addr);
+#endif
+static inline void FastMap_PhyMarkCode(ARMul_State *state,const ARMword *addr);
 static inline void FastMap_PhyClobberFunc(ARMul_State *state,ARMword *addr);
 static inline void FastMap_PhyClobberFuncRange(ARMul_State *state,ARMword *addr,size_t len);
+static inline FastMapAccessFunc FastMap_GetFunc(const FastMapEntry *entry,ARMul_State *state);
 static inline ARMword FastMap_LoadFunc(const FastMapEntry *entry,ARMul_State *state,ARMword addr);
 static inline void FastMap_StoreFunc(const FastMapEntry *entry,ARMul_State *state,ARMword addr,ARMword data,ARMword flags);
 static inline void FastMap_RebuildMapMode(ARMul_State *state);
+static inline void FastMap_Changed(ARMul_State *state);
+#ifdef ARMUL_DATA_TLB
+static inline ARMword *FastMap_TLBRead(ARMul_State *state,ARMword addr);
+static inline ARMword *FastMap_TLBWrite(ARMul_State *state,ARMword addr);
+static inline void FastMap_TLBFill(ARMul_State *state,const FastMapEntry *entry,ARMword addr);
+#endif
 
 static inline FastMapEntry *FastMap_GetEntry(ARMul_State *state,ARMword addr)
 {
@@ -50,21 +67,69 @@ static inline ARMword *FastMap_Log2Phy(const FastMapEntry *entry,ARMword addr)
 }
 
 #ifdef ARMUL_INSTR_FUNC_CACHE
-static inline ARMEmuFunc *FastMap_Phy2Func(ARMul_State *state,ARMword *addr)
+static inline ARMEmuFuncSlot *FastMap_Phy2Func(ARMul_State *state,ARMword *addr)
 {
-	/* Return ARMEmuFunc * for an address returned by Log2Phy */
-#ifdef FASTMAP_64
+	/* Return ARMEmuFuncSlot * for an address returned by Log2Phy */
+#if defined(ARMUL_INSTR_FUNC_INDEX)
+	/* Shift addr so we access the indices as 16bit data types instead of 32bit */
+	return (ARMEmuFuncSlot*)((((FastMapUInt)addr)>>1)+state->FastMapInstrFuncOfs);
+#elif defined(FASTMAP_64)
 	/* Shift addr so we access ARMEmuFunc *'s as 64bit data types instead of 32bit */
-	return (ARMEmuFunc*)((((FastMapUInt)addr)<<1)+state->FastMapInstrFuncOfs);
+	return (ARMEmuFuncSlot*)((((FastMapUInt)addr)<<1)+state->FastMapInstrFuncOfs);
 #else
-	return (ARMEmuFunc*)(((FastMapUInt)addr)+state->FastMapInstrFuncOfs);
+	return (ARMEmuFuncSlot*)(((FastMapUInt)addr)+state->FastMapInstrFuncOfs);
 #endif
 }
 #endif
 
+#ifdef ARMUL_CODE_PAGES
+static inline CodePage *FastMap_Phy2CodePage(ARMul_State *state,const ARMword *addr)
+{
+	/* Return CodePage * for an address returned by Log2Phy */
+	return &state->CodePages[(((FastMapUInt)addr)-state->CodePageBase)>>CODEPAGE_SHIFT];
+}
+#endif
+
+static inline void FastMap_PhyMarkCode(ARMul_State *state,const ARMword *addr)
+{
+	/* Called whenever a handler is cached for the word at addr */
+#ifdef ARMUL_CODE_PAGES
+	FastMap_Phy2CodePage(state,addr)->HasCode = true;
+#else
+	UNUSED_VAR(state);
+	UNUSED_VAR(addr);
+#endif
+}
+
 static inline void FastMap_PhyClobberFunc(ARMul_State *state,ARMword *addr)
 {
-#ifdef ARMUL_INSTR_FUNC_CACHE
+#ifdef ARMUL_CODE_PAGES
+	CodePage *page = FastMap_Phy2CodePage(state,addr);
+	ARMEmuFuncSlot *func;
+	if(!page->HasCode)
+	{
+		CODEPAGE_STAT(DataStores,1);
+		return;
+	}
+	CODEPAGE_STAT(CodeStores,1);
+	func = FastMap_Phy2Func(state,addr);
+	if(*func != FASTMAP_CLOBBEREDFUNC)
+	{
+		*func = FASTMAP_CLOBBEREDFUNC;
+		CODEPAGE_STAT(CodeWrites,1);
+#ifdef ARMUL_BLOCK_CACHE
+		ARMul_BlockCache_Clobber(state,addr);
+#endif
+	}
+#elif defined(ARMUL_BLOCK_CACHE)
+	ARMEmuFuncSlot *func = FastMap_Phy2Func(state,addr);
+	/* Only words with a cached func can be part of a block */
+	if(*func != FASTMAP_CLOBBEREDFUNC)
+	{
+		*func = FASTMAP_CLOBBEREDFUNC;
+		ARMul_BlockCache_Clobber(state,addr);
+	}
+#elif defined(ARMUL_INSTR_FUNC_CACHE)
 	*(FastMap_Phy2Func(state,addr)) = FASTMAP_CLOBBEREDFUNC;
 #else
 	UNUSED_VAR(state);
@@ -74,8 +139,50 @@ static inline void FastMap_PhyClobberFunc(ARMul_State *state,ARMword *addr)
 
 static inline void FastMap_PhyClobberFuncRange(ARMul_State *state,ARMword *addr,size_t len)
 {
-#ifdef ARMUL_INSTR_FUNC_CACHE
-	ARMEmuFunc *func = FastMap_Phy2Func(state,addr);
+#ifdef ARMUL_CODE_PAGES
+	while (len>0) {
+		/* Deal with the range one page at a time */
+		CodePage *page = FastMap_Phy2CodePage(state,addr);
+		ARMEmuFuncSlot *func;
+		size_t chunk = (((FastMapUInt)addr)-state->CodePageBase) & ((1<<CODEPAGE_SHIFT)-1);
+		chunk = MIN(len,(1<<CODEPAGE_SHIFT)-chunk);
+		len -= chunk;
+		if(!page->HasCode)
+		{
+			CODEPAGE_STAT(DataStores,chunk>>2);
+			addr += chunk>>2;
+			continue;
+		}
+		CODEPAGE_STAT(CodeStores,chunk>>2);
+		func = FastMap_Phy2Func(state,addr);
+		while (chunk>0) {
+			if(*func != FASTMAP_CLOBBEREDFUNC)
+			{
+				*func = FASTMAP_CLOBBEREDFUNC;
+				CODEPAGE_STAT(CodeWrites,1);
+#ifdef ARMUL_BLOCK_CACHE
+				ARMul_BlockCache_Clobber(state,addr);
+#endif
+			}
+			func++;
+			addr++;
+			chunk -= 4;
+		}
+	}
+#elif defined(ARMUL_BLOCK_CACHE)
+	ARMEmuFuncSlot *func = FastMap_Phy2Func(state,addr);
+	while (len>0) {
+		if(*func != FASTMAP_CLOBBEREDFUNC)
+		{
+			*func = FASTMAP_CLOBBEREDFUNC;
+			ARMul_BlockCache_Clobber(state,addr);
+		}
+		func++;
+		addr++;
+		len -= 4;
+	}
+#elif defined(ARMUL_INSTR_FUNC_CACHE)
+	ARMEmuFuncSlot *func = FastMap_Phy2Func(state,addr);
 	while (len>0) {
 		*func++ = FASTMAP_CLOBBEREDFUNC;
 		len -= 4;
@@ -87,21 +194,56 @@ static inline void FastMap_PhyClobberFuncRange(ARMul_State *state,ARMword *addr,
 #endif
 }
 
+static inline FastMapAccessFunc FastMap_GetFunc(const FastMapEntry *entry,ARMul_State *state)
+{
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+	/* Funcs are in a parallel array */
+	return FastMap_AccessFuncs[state->FastMapFuncs[entry-state->FastMap]];
+#else
+	UNUSED_VAR(state);
+	return entry->AccessFunc;
+#endif
+}
+
 static inline ARMword FastMap_LoadFunc(const FastMapEntry *entry,ARMul_State *state,ARMword addr)
 {
 	/* Return load result, assumes it's a func */
-	return (entry->AccessFunc)(state,addr,0,0);
+	return (FastMap_GetFunc(entry,state))(state,addr,0,0);
 }
 
 static inline void FastMap_StoreFunc(const FastMapEntry *entry,ARMul_State *state,ARMword addr,ARMword data,ARMword flags)
 {
 	/* Perform store, assumes it's a func */
-	(entry->AccessFunc)(state,addr,data,flags | FASTMAP_ACCESSFUNC_WRITE);
+	(FastMap_GetFunc(entry,state))(state,addr,data,flags | FASTMAP_ACCESSFUNC_WRITE);
 }
 
 static inline void FastMap_RebuildMapMode(ARMul_State *state)
 {
+#ifdef ARMUL_BLOCK_CACHE
+	/* Next fetch must be checked against the new mode */
+	state->BlockCur = NULL;
+#endif
 	state->FastMapMode = (state->NtransSig?FASTMAP_MODE_MBO|FASTMAP_MODE_SVC:state->OSmode?FASTMAP_MODE_MBO|FASTMAP_MODE_OS:FASTMAP_MODE_MBO|FASTMAP_MODE_USR);
+	FastMap_Changed(state);
+}
+
+static inline void FastMap_Changed(ARMul_State *state)
+{
+	/* Called whenever FastMap entries or the access mode change */
+#ifdef ARMUL_DATA_TLB
+	/* Invalidate all the TLB entries by moving to the next generation */
+	state->FastMapGen += DATATLB_GEN_STEP;
+	if(!state->FastMapGen)
+	{
+		/* Wrapped around, so old tags could match again. Clear them, and skip generation 0 so that tags are never 0 */
+		int i;
+		for(i=0;i<DATATLB_SIZE;i++)
+			state->DataTLB[i].ReadTag = state->DataTLB[i].WriteTag = 0;
+		state->FastMapGen = DATATLB_GEN_STEP;
+	}
+#else
+	UNUSED_VAR(state);
+#endif
 }
 
 /* Macros to evaluate DecodeRead/DecodeWrite results
@@ -110,6 +252,36 @@ static inline void FastMap_RebuildMapMode(ARMul_State *state)
 #define FASTMAP_RESULT_FUNC(res) (((FastMapUInt)(res)) > FASTMAP_MODE_MBO)
 #define FASTMAP_RESULT_ABORT(res) (((res)<<1)==0)
 
+#ifdef ARMUL_DATA_TLB
+static inline ARMword *FastMap_TLBRead(ARMul_State *state,ARMword addr)
+{
+	/* Return physical pointer if addr (already wrapped) is in a page cached as directly readable, else NULL */
+	const DataTLBEntry *tlb = &state->DataTLB[(addr>>12)&(DATATLB_SIZE-1)];
+	if(tlb->ReadTag == (addr>>12)+state->FastMapGen)
+		return (ARMword*)(((FastMapUInt)addr)+tlb->Offset);
+	return NULL;
+}
+
+static inline ARMword *FastMap_TLBWrite(ARMul_State *state,ARMword addr)
+{
+	/* Return physical pointer if addr (already wrapped) is in a page cached as directly writeable, else NULL */
+	const DataTLBEntry *tlb = &state->DataTLB[(addr>>12)&(DATATLB_SIZE-1)];
+	if(tlb->WriteTag == (addr>>12)+state->FastMapGen)
+		return (ARMword*)(((FastMapUInt)addr)+tlb->Offset);
+	return NULL;
+}
+
+static inline void FastMap_TLBFill(ARMul_State *state,const FastMapEntry *entry,ARMword addr)
+{
+	/* Cache the entry for addr, after a DecodeRead/DecodeWrite gave a direct result */
+	DataTLBEntry *tlb = &state->DataTLB[(addr>>12)&(DATATLB_SIZE-1)];
+	ARMword tag = (addr>>12)+state->FastMapGen;
+	tlb->ReadTag = (FASTMAP_RESULT_DIRECT(FastMap_DecodeRead(entry,state->FastMapMode)) ? tag : 0);
+	tlb->WriteTag = (FASTMAP_RESULT_DIRECT(FastMap_DecodeWrite(entry,state->FastMapMode)) ? tag : 0);
+	tlb->Offset = entry->FlagsAndData<<8;
+}
+#endif
+
 /* ------------------- inlined higher-level memory funcs ---------------------- */
 
 #define FASTMAP_INLINE
@@ -26,6 +26,16 @@ typedef struct DiskInfo
   uint64_t	free;		/**< Free space on disk */
 } DiskInfo;
 
+/* What Memory_AllocHuge managed to get */
+typedef enum MemoryBacking {
+  MemoryBacking_Normal          = 0, /* Normal host pages */
+  MemoryBacking_HugeTransparent = 1, /* Normal pages, with the host asked to use huge pages for them */
+  MemoryBacking_HugeExplicit    = 2  /* Reserved huge pages */
+} MemoryBacking;
+
+/* Huge page size Memory_AllocHuge aims for */
+#define MEMORY_HUGE_PAGE_SIZE (2*1024*1024)
+
 /**
  * Directory_Open
  *
@@ -127,6 +137,65 @@ FILE *File_OpenAppData(const char *sName, const char *sMode);
  */
 Directory *Directory_OpenAppDir(const char *sName);
 
+/**
+ * Memory_Alloc
+ *
+ * Allocate a page aligned block of zeroed memory, for use as emulated memory.
+ * Where the host allows it, pages are only given real memory when they are
+ * first touched
+ *
+ * @param uSize Size of block in bytes
+ * @returns Pointer to block or NULL on failure
+ */
+void *Memory_Alloc(size_t uSize);
+
+/**
+ * Memory_AllocHuge
+ *
+ * As Memory_Alloc, but tries to back the block with huge pages, to cut TLB
+ * misses on memory the emulator accesses at random. Where huge pages are
+ * supported, the size is rounded up to a multiple of MEMORY_HUGE_PAGE_SIZE
+ *
+ * @param puSize Size of block in bytes, updated with the size allocated
+ * @param peBacking Set to the type of backing obtained
+ * @returns Pointer to block or NULL on failure
+ */
+void *Memory_AllocHuge(size_t *puSize, MemoryBacking *peBacking);
+
+/**
+ * Memory_Free
+ *
+ * Free a block allocated by Memory_Alloc or Memory_AllocHuge, including
+ * anything File_MapEmu has mapped into it
+ *
+ * @param pBlock Block to free (may be NULL)
+ * @param uSize Size the block was allocated with
+ */
+void Memory_Free(void *pBlock, size_t uSize);
+
+/**
+ * File_MapEmu
+ *
+ * Like File_ReadEmu, but where possible the data is mapped copy-on-write
+ * from the file instead of copied, so that machines (and processes) using
+ * the same file share the same physical pages. pBuffer must be within a
+ * block from Memory_Alloc, and any part of it which lies beyond the end of
+ * the file is left zeroed. Falls back to File_ReadEmu if the host can't map
+ * files, or the file data would need endian swapping.
+ *
+ * Mapped pages which haven't been written to are still backed by the file,
+ * so changing the file in place would change what the guest sees (or, if
+ * it was truncated, crash). Hosts must only map files which can't be
+ * written to (on POSIX, regular files with no write permission bits), and
+ * read anything else
+ *
+ * @param pFile File to read from
+ * @param pBuffer Buffer to write to
+ * @param uCount Number of bytes to read
+ * @returns Number of bytes read
+ */
+size_t File_MapEmu(FILE *pFile,uint8_t *pBuffer,size_t uCount);
+
 /* These next few are implemented in arch/filecommon.c */
 
 /**
@@ -173,4 +173,35 @@ bool Disk_GetInfo(const char *path, DiskInfo *d)
   return false;
 }
 
+void *Memory_Alloc(size_t uSize)
+{
+  /* Over-allocate so the block can be page aligned, and remember where the
+     real allocation starts just before it */
+  uint8_t *pReal = calloc(1, uSize + 4096);
+  uint8_t *pBlock;
+  if (!pReal)
+    return NULL;
+  pBlock = (uint8_t *) ((((uintptr_t) pReal) + 4096) & ~(uintptr_t) 4095);
+  ((void **) pBlock)[-1] = pReal;
+  return pBlock;
+}
+
+void *Memory_AllocHuge(size_t *puSize, MemoryBacking *peBacking)
+{
+  *peBacking = MemoryBacking_Normal;
+  return Memory_Alloc(*puSize);
+}
+
+void Memory_Free(void *pBlock, size_t uSize)
+{
+  UNUSED_VAR(uSize);
+  if (pBlock)
+    free(((void **) pBlock)[-1]);
+}
+
+size_t File_MapEmu(FILE *pFile,uint8_t *pBuffer,size_t uCount)
+{
+  return File_ReadEmu(pFile, pBuffer, uCount);
+}
+
 #endif
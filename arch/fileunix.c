@@ -17,6 +17,11 @@
 #include <sys/statvfs.h>
 #include <sys/types.h>
 #include <dirent.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 /* application includes */
 #include "filecalls.h"
@@ -217,5 +222,104 @@ bool Disk_GetInfo(const char *path, DiskInfo *d)
 	return true;
 }
 
+void *Memory_Alloc(size_t uSize)
+{
+#ifdef HAVE_MMAP
+  /* Anonymous mappings are zero-filled on demand */
+  void *pBlock = mmap(NULL, uSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return (pBlock == MAP_FAILED) ? NULL : pBlock;
+#else
+  /* Over-allocate so the block can be page aligned, and remember where the
+     real allocation starts just before it */
+  uint8_t *pReal = calloc(1, uSize + 4096);
+  uint8_t *pBlock;
+  if (!pReal)
+    return NULL;
+  pBlock = (uint8_t *) ((((uintptr_t) pReal) + 4096) & ~(uintptr_t) 4095);
+  ((void **) pBlock)[-1] = pReal;
+  return pBlock;
+#endif
+}
+
+void *Memory_AllocHuge(size_t *puSize, MemoryBacking *peBacking)
+{
+  size_t uSize = (*puSize + MEMORY_HUGE_PAGE_SIZE - 1) & ~(size_t) (MEMORY_HUGE_PAGE_SIZE - 1);
+  void *pBlock;
+
+  *puSize = uSize;
+#if defined(HAVE_MMAP) && defined(MAP_HUGETLB)
+  /* Explicit huge pages, if the admin has reserved some */
+  pBlock = mmap(NULL, uSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (pBlock != MAP_FAILED) {
+    *peBacking = MemoryBacking_HugeExplicit;
+    return pBlock;
+  }
+#endif
+#if defined(HAVE_MMAP) && defined(MADV_HUGEPAGE)
+  /* Transparent huge pages need a huge page aligned block, so over-allocate
+     and trim */
+  pBlock = mmap(NULL, uSize + MEMORY_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pBlock != MAP_FAILED) {
+    uint8_t *pStart = (uint8_t *) pBlock;
+    uint8_t *pAligned = (uint8_t *) ((((uintptr_t) pStart) + MEMORY_HUGE_PAGE_SIZE - 1) & ~(uintptr_t) (MEMORY_HUGE_PAGE_SIZE - 1));
+    if (pAligned != pStart)
+      munmap(pStart, pAligned - pStart);
+    munmap(pAligned + uSize, (pStart + MEMORY_HUGE_PAGE_SIZE) - pAligned);
+    *peBacking = (madvise(pAligned, uSize, MADV_HUGEPAGE) == 0) ? MemoryBacking_HugeTransparent : MemoryBacking_Normal;
+    return pAligned;
+  }
+#endif
+  pBlock = Memory_Alloc(uSize);
+  *peBacking = MemoryBacking_Normal;
+  return pBlock;
+}
+
+void Memory_Free(void *pBlock, size_t uSize)
+{
+#ifdef HAVE_MMAP
+  if (pBlock)
+    munmap(pBlock, uSize);
+#else
+  UNUSED_VAR(uSize);
+  if (pBlock)
+    free(((void **) pBlock)[-1]);
+#endif
+}
+
+size_t File_MapEmu(FILE *pFile,uint8_t *pBuffer,size_t uCount)
+{
+#if defined(HAVE_MMAP) && !defined(HOST_BIGENDIAN)
+  size_t uPageMask = (size_t) sysconf(_SC_PAGESIZE) - 1;
+  long lPos = ftell(pFile);
+  size_t uMapped = 0;
+  struct stat hStat;
+
+  /* Map as many whole pages as the file and buffer allow, the rest (if
+     any) is read as normal. Pages which haven't been written to stay
+     backed by the file, so if it was truncated or rewritten in place the
+     guest would see the new data (or take a SIGBUS). So only map regular
+     files which nobody has write permission for */
+  if ((lPos >= 0) && !(((size_t) lPos | (size_t) pBuffer) & uPageMask) &&
+      (fstat(fileno(pFile), &hStat) == 0) && S_ISREG(hStat.st_mode) &&
+      !(hStat.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) &&
+      (hStat.st_size > lPos))
+  {
+    size_t uAvail = (size_t) (hStat.st_size - lPos);
+    uMapped = ((uAvail < uCount) ? uAvail : uCount) & ~uPageMask;
+    if (uMapped &&
+        mmap(pBuffer, uMapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             fileno(pFile), (off_t) lPos) == MAP_FAILED)
+    {
+      uMapped = 0;
+    }
+    if (uMapped && (fseek(pFile, lPos + (long) uMapped, SEEK_SET) != 0))
+      return uMapped;
+  }
+  return uMapped + File_ReadEmu(pFile, pBuffer + uMapped, uCount - uMapped);
+#else
+  return File_ReadEmu(pFile, pBuffer, uCount);
+#endif
+}
+
 #endif
 
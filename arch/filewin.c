@@ -174,5 +174,42 @@ bool Disk_GetInfo(const char *path, DiskInfo *d)
 	return true;
 }
 
+void *Memory_Alloc(size_t uSize)
+{
+  /* Committed pages are zero-filled on first access */
+  return VirtualAlloc(NULL, uSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void *Memory_AllocHuge(size_t *puSize, MemoryBacking *peBacking)
+{
+  size_t uLarge = GetLargePageMinimum();
+  size_t uSize = (*puSize + MEMORY_HUGE_PAGE_SIZE - 1) & ~(size_t) (MEMORY_HUGE_PAGE_SIZE - 1);
+  void *pBlock = NULL;
+
+  /* Large pages need SeLockMemoryPrivilege, so this often fails */
+  if (uLarge && !(uSize % uLarge))
+    pBlock = VirtualAlloc(NULL, uSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+  *puSize = uSize;
+  if (pBlock) {
+    *peBacking = MemoryBacking_HugeExplicit;
+    return pBlock;
+  }
+  *peBacking = MemoryBacking_Normal;
+  return Memory_Alloc(uSize);
+}
+
+void Memory_Free(void *pBlock, size_t uSize)
+{
+  UNUSED_VAR(uSize);
+  if (pBlock)
+    VirtualFree(pBlock, 0, MEM_RELEASE);
+}
+
+size_t File_MapEmu(FILE *pFile,uint8_t *pBuffer,size_t uCount)
+{
+  /* Views can't be placed inside an existing allocation, so just read */
+  return File_ReadEmu(pFile, pBuffer, uCount);
+}
+
 #endif
 
@@ -87,9 +87,8 @@ struct HDCStruct {
 /*  struct HDCshape configshape[4]; */
 };
 
-/* The global Hard drive state structure */
-/*struct HDCStruct HDCData;*/
-struct HDCStruct HDC;
+/* The Hard drive state structure */
+#define HDC (*(state->Hdc))
 
 
 
@@ -256,9 +255,9 @@ static void UpdateInterrupt(ARMul_State *state) {
   dbug_ints("HDC-UpdateInterrupt mask=0x%x StatusReg=0x%x &=0x%x DREQ=%d\n",
                  mask,HDC.StatusReg,HDC.StatusReg & mask,HDC.DREQ);
   if ((HDC.StatusReg & mask) || HDC.DREQ) {
-    ioc.IRQStatus |= IRQB_HDIRQ;
+    IOC.IRQStatus |= IRQB_HDIRQ;
   } else {
-    ioc.IRQStatus &= ~IRQB_HDIRQ;
+    IOC.IRQStatus &= ~IRQB_HDIRQ;
   }
   IO_UpdateNirq(state);
 } /* UpdateInterrupt */
@@ -1133,7 +1132,7 @@ static void CheckData_DoNextBufferFull(ARMul_State *state) {
                  HDC.CommandData.ReadData.SCNTH,
                  HDC.CommandData.ReadData.SCNTL);
   } else {
-    static uint8_t tmpbuff[256];
+    uint8_t tmpbuff[256];
     size_t retval;
 
     /* Fill here up! */
@@ -1590,13 +1589,15 @@ uint_fast16_t HDC_Read(ARMul_State *state, uint_fast16_t offset) {
 } /* HDC_Read */
 
 /*---------------------------------------------------------------------------*/
-void HDC_Init(ARMul_State *state) {
+bool HDC_Init(ARMul_State *state) {
   uint_fast8_t currentdrive;
   const char *FileName;
   
-  /* initialise the struct as if it had been calloc'd */
-  memset(&HDC, 0, sizeof(struct HDCStruct));
-  
+  state->Hdc = calloc(1, sizeof(struct HDCStruct));
+  if (!state->Hdc) {
+    ControlPane_Error(false,"Couldn't allocate HDC");
+    return false;
+  }
   
   HDC.StatusReg=0;
   HDC.PBPtr=0;
@@ -1632,5 +1633,22 @@ void HDC_Init(ARMul_State *state) {
   } /* Image opening */
 
   HDC.DREQ=false;
+  return true;
 } /* HDC_Init */
 
+/*---------------------------------------------------------------------------*/
+void HDC_Exit(ARMul_State *state) {
+  uint_fast8_t currentdrive;
+
+  if (!state->Hdc)
+    return;
+
+  for (currentdrive = 0; currentdrive < 4; currentdrive++) {
+    if (HDC.HardFile[currentdrive])
+      fclose(HDC.HardFile[currentdrive]);
+  }
+
+  free(state->Hdc);
+  state->Hdc = NULL;
+} /* HDC_Exit */
+
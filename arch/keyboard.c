@@ -1,6 +1,10 @@
 /* arch/keyboard.c -- a model of the Archimedes keyboard. */
 
+#include <stdlib.h>
+
+#include "ArcemConfig.h"
 #include "armarc.h"
+#include "ControlPane.h"
 #include "dbugsys.h"
 #include "../eventq.h"
 #include "keyboard.h"
@@ -361,7 +365,8 @@ void Keyboard_Poll(ARMul_State *state,CycleCount nowtime)
   int KbdSerialVal;
   EventQ_RescheduleHead(state,nowtime+12500,Keyboard_Poll); /* TODO - Should probably be realtime */
   /* Call host-specific routine */
-  Kbd_PollHostKbd(state);
+  if (!CONFIG.bHeadless)
+    Kbd_PollHostKbd(state);
   /* Keyboard check */
   KbdSerialVal = IOC_ReadKbdTx(state);
   if (KbdSerialVal != -1) {
@@ -376,10 +381,13 @@ void Keyboard_Poll(ARMul_State *state,CycleCount nowtime)
   }
 }
 
-void Kbd_Init(ARMul_State *state)
+bool Kbd_Init(ARMul_State *state)
 {
-  static arch_keyboard kbd;
-  state->Kbd = &kbd;
+  state->Kbd = calloc(1,sizeof(arch_keyboard));
+  if (!state->Kbd) {
+    ControlPane_Error(false,"Couldn't allocate keyboard");
+    return false;
+  }
 
   KBD.KbdState            = KbdState_JustStarted;
   KBD.MouseTransEnable    = false;
@@ -397,5 +405,12 @@ void Kbd_Init(ARMul_State *state)
   KBD.leds_changed        = NULL;
 
   EventQ_Insert(state,ARMul_Time+12500,Keyboard_Poll);
+  return true;
+}
+
+void Kbd_Exit(ARMul_State *state)
+{
+  free(state->Kbd);
+  state->Kbd = NULL;
 }
 
@@ -0,0 +1,143 @@
+/*
+  arch/nulldisplaydev.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Standard display device implementation which renders to an offscreen buffer
+  that is never shown. Used for headless/benchmark runs, so that the emulated
+  machine (and the host) does the same amount of display work as it would when
+  running normally, without needing a host display to be available.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../armdefs.h"
+#include "ArcemConfig.h"
+#include "armarc.h"
+#include "dbugsys.h"
+#include "displaydev.h"
+#include "displaythreads.h"
+#include "ControlPane.h"
+#include "rowkernels.h"
+#include "../eventq.h"
+
+typedef uint32_t SDD_HostColour;
+#define SDD_Name(x) null_##x
+static const int SDD_RowsAtOnce = 1;
+#define SDD_Row SDD_HostColour *
+#define SDD_DirectRows
+#define SDD_DisplayDev Null_DisplayDev
+
+typedef struct {
+  SDD_HostColour *Buffer;
+  int Width;
+} NullHostData;
+
+#define SDD_HostData NullHostData
+
+static SDD_HostColour SDD_Name(Host_GetColour)(ARMul_State *state,unsigned int col)
+{
+  /* Convert to 0x00RRGGBB */
+  UNUSED_VAR(state);
+  return (((col & 0xf)*0x11)<<16) | ((((col>>4) & 0xf)*0x11)<<8) | (((col>>8) & 0xf)*0x11);
+}
+
+static bool SDD_Name(Host_ChangeMode)(ARMul_State *state,int width,int height,int hz);
+
+static void SDD_Name(Host_Shutdown)(ARMul_State *state);
+
+static inline SDD_Row SDD_Name(Host_BeginRow)(ARMul_State *state,int row,int offset);
+
+static inline void SDD_Name(Host_EndRow)(ARMul_State *state,SDD_Row *row)
+{
+  /* nothing */
+  UNUSED_VAR(state);
+  UNUSED_VAR(row);
+}
+
+static inline void SDD_Name(Host_BeginUpdate)(ARMul_State *state,SDD_Row *row,unsigned int count)
+{
+  /* nothing */
+  UNUSED_VAR(state);
+  UNUSED_VAR(row);
+  UNUSED_VAR(count);
+}
+
+static inline void SDD_Name(Host_EndUpdate)(ARMul_State *state,SDD_Row *row)
+{
+  /* nothing */
+  UNUSED_VAR(state);
+  UNUSED_VAR(row);
+}
+
+static inline void SDD_Name(Host_SkipPixels)(ARMul_State *state,SDD_Row *row,unsigned int count)
+{
+  UNUSED_VAR(state);
+  (*row) += count;
+}
+
+static inline void SDD_Name(Host_WritePixel)(ARMul_State *state,SDD_Row *row,SDD_HostColour pix)
+{
+  UNUSED_VAR(state);
+  *(*row)++ = pix;
+}
+
+static inline void SDD_Name(Host_WritePixels)(ARMul_State *state,SDD_Row *row,SDD_HostColour pix,unsigned int count)
+{
+  UNUSED_VAR(state);
+  while(count--) *(*row)++ = pix;
+}
+
+static void SDD_Name(Host_PollDisplay)(ARMul_State *state)
+{
+  /* nothing */
+  UNUSED_VAR(state);
+}
+
+#include "stddisplaydev.c"
+
+static bool SDD_Name(Host_ChangeMode)(ARMul_State *state,int width,int height,int hz)
+{
+  SDD_HostColour *buffer;
+  UNUSED_VAR(hz);
+
+  buffer = realloc(HD.Host.Buffer,sizeof(SDD_HostColour)*width*height);
+  if(!buffer)
+  {
+    warn_vidc("Failed to allocate %dx%d offscreen buffer\n",width,height);
+    return false;
+  }
+  HD.Host.Buffer = buffer;
+  HD.Host.Width = width;
+  memset(buffer,0,sizeof(SDD_HostColour)*width*height);
+
+  HD.Width = width;
+  HD.Height = height;
+  HD.XScale = 1;
+  HD.YScale = 1;
+
+  return true;
+}
+
+static void SDD_Name(Host_Shutdown)(ARMul_State *state)
+{
+  free(HD.Host.Buffer);
+  HD.Host.Buffer = NULL;
+}
+
+static inline SDD_Row SDD_Name(Host_BeginRow)(ARMul_State *state,int row,int offset)
+{
+  return HD.Host.Buffer + row*HD.Host.Width + offset;
+}
+
+const uint32_t *NullDisplayDev_GetBuffer(ARMul_State *state,int *width,int *height)
+{
+  if((DisplayDev_Current != &Null_DisplayDev) || !HD.Host.Buffer)
+    return NULL;
+  SDD_Name(WaitRows)(state);
+  *width = HD.Width;
+  *height = HD.Height;
+  return HD.Host.Buffer;
+}
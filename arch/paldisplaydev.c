@@ -590,7 +590,7 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
   DisplayDev_VSync(state);
 
   NewCR = VIDC.ControlReg;
-  ClockIn = 2*DisplayDev_GetVIDCClockIn();
+  ClockIn = 2*DisplayDev_GetVIDCClockIn(state);
   ClockDivider = ClockDividers[NewCR&3];
 
   /* Work out when to reschedule ourselves */
@@ -604,6 +604,7 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
     /* Handle frame skip */
     if(DC.FrameSkip--)
     {
+      DisplayDev_FramesSkipped++;
       return;
     }
     DC.FrameSkip = DisplayDev_FrameSkip;
@@ -696,7 +697,7 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
           /* Disable */
           DisplayDev_UseUpdateFlags = 0;
           DisplayDev_FrameSkip = DC.Auto_FrameCount/DC.Auto_ForceRefresh;
-          ARMul_RebuildFastMap(state);
+          ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
         }
         DC.Auto_FrameCount = 0;
         DC.Auto_ForceRefresh = 0;
@@ -713,7 +714,7 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
           /* Enable */        
           DisplayDev_UseUpdateFlags = 1;
           DisplayDev_FrameSkip = 0;
-          ARMul_RebuildFastMap(state);
+          ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
           /* Ensure the updateflags get reset */
           DC.ForceRefresh = true;
           DC.FrameSkip = 0;
@@ -807,6 +808,7 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
     if(DisplayDev_UseUpdateFlags)
     {
       PDD_Name(FrameFunc)(state,Height,flags);
+      DisplayDev_FramesRendered++;
     }
     else
     {
@@ -816,10 +818,12 @@ static void PDD_Name(EventFunc)(ARMul_State *state,CycleCount nowtime)
         DC.FrameSkip = DisplayDev_FrameSkip;
 
         PDD_Name(FrameFuncNoFlags)(state,Height,flags);
+        DisplayDev_FramesRendered++;
       }
       else
       {
         DC.FrameSkip--;
+        DisplayDev_FramesSkipped++;
       }
     }
   }
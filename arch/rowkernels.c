@@ -0,0 +1,573 @@
+/*
+  arch/rowkernels.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Row conversion kernels, see rowkernels.h.
+
+  Each kernel is a thin wrapper around a generic inline function, which is
+  given constant host pixel size/bpp/scale arguments so that the compiler can
+  specialise it.
+
+  The SIMD versions work in units of 32 source pixels, i.e. 'bpp' source
+  words, and leave any remainder to the C version. Rather than looking each
+  pixel up in the palette individually, they use per-lane selects (SSE2, for
+  1bpp & 2bpp) or byte shuffles (AVX2 & NEON, for up to 4bpp). For the
+  shuffles, the palette is split into byte planes - one 16 byte table holding
+  byte 0 of each entry, one holding byte 1, etc. Each plane is then indexed
+  with one byte per pixel, and the results interleaved back together. 8bpp
+  has too many palette entries for this, so is always done by the C version.
+*/
+
+#include <string.h>
+
+#include "../armdefs.h"
+#include "rowkernels.h"
+
+#if !defined(HOST_BIGENDIAN) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROWKERNELS_X86
+#include <immintrin.h>
+#define ROWKERNELS_SSE2_ATTR __attribute__((target("sse2")))
+#define ROWKERNELS_AVX2_ATTR __attribute__((target("avx2")))
+#endif
+
+#if !defined(HOST_BIGENDIAN) && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#define ROWKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/* Wrapper for one kernel of a set. ISA selects the generic function, ATTR is
+   any attributes it needs */
+#define ROWKERNEL(ISA,ATTR,HOST,BPP,SCALE) \
+ATTR static void RowKernel_##ISA##_##HOST##_##BPP##_##SCALE(void *out,const ARMword *in,unsigned int count,const void *palette) \
+{ \
+  RowKernels_##ISA(out,in,count,palette,HOST/8,BPP,SCALE); \
+}
+
+/* Wrappers for all the bpps of one host pixel size & scale */
+#define ROWKERNEL_BPPS(ISA,ATTR,HOST,SCALE) \
+ROWKERNEL(ISA,ATTR,HOST,1,SCALE) \
+ROWKERNEL(ISA,ATTR,HOST,2,SCALE) \
+ROWKERNEL(ISA,ATTR,HOST,4,SCALE) \
+ROWKERNEL(ISA,ATTR,HOST,8,SCALE)
+
+/*
+
+  C reference versions
+
+*/
+
+static inline void RowKernels_C(void *out,const ARMword *in,unsigned int count,const void *palette,unsigned int hostbytes,unsigned int bpp,unsigned int scale)
+{
+  const ARMword mask = (1<<bpp)-1;
+  while(count)
+  {
+    ARMword data = *in++;
+    unsigned int n = MIN(count,32/bpp);
+    count -= n;
+    if(hostbytes == 2)
+    {
+      uint16_t *o = (uint16_t *) out;
+      const uint16_t *pal = (const uint16_t *) palette;
+      while(n--)
+      {
+        uint16_t pix = pal[data & mask];
+        data >>= bpp;
+        *o++ = pix;
+        if(scale)
+          *o++ = pix;
+      }
+      out = o;
+    }
+    else
+    {
+      uint32_t *o = (uint32_t *) out;
+      const uint32_t *pal = (const uint32_t *) palette;
+      while(n--)
+      {
+        uint32_t pix = pal[data & mask];
+        data >>= bpp;
+        *o++ = pix;
+        if(scale)
+          *o++ = pix;
+      }
+      out = o;
+    }
+  }
+}
+
+ROWKERNEL_BPPS(C,,16,0)
+ROWKERNEL_BPPS(C,,16,1)
+ROWKERNEL_BPPS(C,,32,0)
+ROWKERNEL_BPPS(C,,32,1)
+
+static const RowKernelSet RowKernels_CSet = {
+  "C",
+  {
+    {
+      {RowKernel_C_16_1_0,RowKernel_C_16_2_0,RowKernel_C_16_4_0,RowKernel_C_16_8_0},
+      {RowKernel_C_16_1_1,RowKernel_C_16_2_1,RowKernel_C_16_4_1,RowKernel_C_16_8_1},
+    },
+    {
+      {RowKernel_C_32_1_0,RowKernel_C_32_2_0,RowKernel_C_32_4_0,RowKernel_C_32_8_0},
+      {RowKernel_C_32_1_1,RowKernel_C_32_2_1,RowKernel_C_32_4_1,RowKernel_C_32_8_1},
+    },
+  },
+};
+
+/*
+
+  SSE2 versions, for 1bpp & 2bpp
+
+  Each lane of a vector holds one host pixel. The source word is copied into
+  every lane, and ANDed with a per-lane mask to get at the bit(s) for that
+  pixel. The masks then move up by a vector's worth of source bits each time.
+
+*/
+
+#ifdef ROWKERNELS_X86
+ROWKERNELS_SSE2_ATTR static inline __m128i RowKernels_SSE2_Pixel(__m128i v,__m128i m,const __m128i *p,const __m128i *d,unsigned int bpp,unsigned int hostbytes)
+{
+  /* d[0] = p[0]^p[1], d[1] = p[2]^p[3] */
+  __m128i sel0, lo, hi, m1, sel1;
+  if(hostbytes == 2)
+    sel0 = _mm_cmpeq_epi16(_mm_and_si128(v,m),m);
+  else
+    sel0 = _mm_cmpeq_epi32(_mm_and_si128(v,m),m);
+  lo = _mm_xor_si128(p[0],_mm_and_si128(sel0,d[0]));
+  if(bpp == 1)
+    return lo;
+  hi = _mm_xor_si128(p[2],_mm_and_si128(sel0,d[1]));
+  m1 = _mm_add_epi32(m,m); /* No carries between lanes, as the masks are always within their lane */
+  if(hostbytes == 2)
+    sel1 = _mm_cmpeq_epi16(_mm_and_si128(v,m1),m1);
+  else
+    sel1 = _mm_cmpeq_epi32(_mm_and_si128(v,m1),m1);
+  return _mm_xor_si128(lo,_mm_and_si128(sel1,_mm_xor_si128(lo,hi)));
+}
+
+ROWKERNELS_SSE2_ATTR static inline void RowKernels_SSE2(void *out,const ARMword *in,unsigned int count,const void *palette,unsigned int hostbytes,unsigned int bpp,unsigned int scale)
+{
+  unsigned int lanes = 16/hostbytes; /* Host pixels per vector */
+  unsigned int step = (lanes>>scale)*bpp; /* Source bits per vector */
+  unsigned int lanebits = 8*hostbytes;
+  unsigned int words = (count*bpp)>>5;
+  unsigned int i, j, k;
+  __m128i p[4], d[2], m0, sh;
+  uint8_t *o = (uint8_t *) out;
+
+  for(i=0;i<(1u<<bpp);i++)
+  {
+    if(hostbytes == 2)
+      p[i] = _mm_set1_epi16((short) ((const uint16_t *) palette)[i]);
+    else
+      p[i] = _mm_set1_epi32((int) ((const uint32_t *) palette)[i]);
+  }
+  d[0] = _mm_xor_si128(p[0],p[1]);
+  d[1] = (bpp == 2 ? _mm_xor_si128(p[2],p[3]) : d[0]);
+
+  /* Mask for lane j is the lowest bit of source pixel j>>scale */
+  if(hostbytes == 2)
+  {
+    uint16_t masks[8];
+    for(j=0;j<8;j++)
+      masks[j] = (uint16_t) (1<<((j>>scale)*bpp));
+    m0 = _mm_loadu_si128((const __m128i *) masks);
+  }
+  else
+  {
+    uint32_t masks[4];
+    for(j=0;j<4;j++)
+      masks[j] = 1u<<((j>>scale)*bpp);
+    m0 = _mm_loadu_si128((const __m128i *) masks);
+  }
+  sh = _mm_cvtsi32_si128((int) step);
+
+  for(i=0;i<words;i++)
+  {
+    ARMword data = in[i];
+    /* For 16bit hosts, each half of the word is done separately */
+    for(k=0;k<32;k+=lanebits)
+    {
+      __m128i v, m = m0;
+      if(hostbytes == 2)
+        v = _mm_set1_epi16((short) (data>>k));
+      else
+        v = _mm_set1_epi32((int) data);
+      for(j=0;j<lanebits;j+=step)
+      {
+        _mm_storeu_si128((__m128i *) o,RowKernels_SSE2_Pixel(v,m,p,d,bpp,hostbytes));
+        o += 16;
+        if(hostbytes == 2)
+          m = _mm_sll_epi16(m,sh);
+        else
+          m = _mm_sll_epi32(m,sh);
+      }
+    }
+  }
+
+  RowKernels_C(o,in+words,count-((words<<5)/bpp),palette,hostbytes,bpp,scale);
+}
+
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,16,1,0)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,16,2,0)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,16,1,1)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,16,2,1)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,32,1,0)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,32,2,0)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,32,1,1)
+ROWKERNEL(SSE2,ROWKERNELS_SSE2_ATTR,32,2,1)
+
+static const RowKernelSet RowKernels_SSE2Set = {
+  "SSE2",
+  {
+    {
+      {RowKernel_SSE2_16_1_0,RowKernel_SSE2_16_2_0,NULL,NULL},
+      {RowKernel_SSE2_16_1_1,RowKernel_SSE2_16_2_1,NULL,NULL},
+    },
+    {
+      {RowKernel_SSE2_32_1_0,RowKernel_SSE2_32_2_0,NULL,NULL},
+      {RowKernel_SSE2_32_1_1,RowKernel_SSE2_32_2_1,NULL,NULL},
+    },
+  },
+};
+
+/*
+
+  AVX2 versions, for 1bpp, 2bpp & 4bpp
+
+  32 pixel indices are built in one vector, pixels 0-15 in the low lane and
+  16-31 in the high lane, and then looked up in the palette byte planes with
+  VPSHUFB. Unpacking only works within each lane, so the results get
+  recombined with VPERM2I128 on the way out.
+
+*/
+
+ROWKERNELS_AVX2_ATTR static inline __m256i RowKernels_AVX2_Indices(const ARMword *in,unsigned int bpp)
+{
+  const __m128i nibble = _mm_set1_epi8(0xf);
+  __m128i i0, i1;
+  if(bpp == 1)
+  {
+    /* Copy byte n of the word into the 8 index bytes for its pixels, and test each one's bit */
+    const __m256i spread = _mm256_setr_epi8(0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,
+                                            2,2,2,2,2,2,2,2,3,3,3,3,3,3,3,3);
+    const __m256i bits = _mm256_set1_epi64x(INT64_C(0x8040201008040201));
+    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32((int) in[0]),spread);
+    return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v,bits),bits),_mm256_set1_epi8(1));
+  }
+  else if(bpp == 2)
+  {
+    /* Split the 8 bytes into nibbles, then the nibbles into pixels */
+    const __m128i twobits = _mm_set1_epi8(3);
+    __m128i b = _mm_loadl_epi64((const __m128i *) in);
+    __m128i n = _mm_unpacklo_epi8(_mm_and_si128(b,nibble),_mm_and_si128(_mm_srli_epi16(b,4),nibble));
+    i0 = _mm_unpacklo_epi8(_mm_and_si128(n,twobits),_mm_and_si128(_mm_srli_epi16(n,2),twobits));
+    i1 = _mm_unpackhi_epi8(_mm_and_si128(n,twobits),_mm_and_si128(_mm_srli_epi16(n,2),twobits));
+  }
+  else
+  {
+    __m128i b = _mm_loadu_si128((const __m128i *) in);
+    i0 = _mm_unpacklo_epi8(_mm_and_si128(b,nibble),_mm_and_si128(_mm_srli_epi16(b,4),nibble));
+    i1 = _mm_unpackhi_epi8(_mm_and_si128(b,nibble),_mm_and_si128(_mm_srli_epi16(b,4),nibble));
+  }
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(i0),i1,1);
+}
+
+ROWKERNELS_AVX2_ATTR static inline uint8_t *RowKernels_AVX2_Store(uint8_t *o,__m256i v,unsigned int hostbytes,unsigned int scale)
+{
+  /* Store 32 bytes of pixels, doubling them up for 2X */
+  __m256i d0, d1;
+  if(!scale)
+  {
+    _mm256_storeu_si256((__m256i *) o,v);
+    return o+32;
+  }
+  if(hostbytes == 2)
+  {
+    d0 = _mm256_unpacklo_epi16(v,v);
+    d1 = _mm256_unpackhi_epi16(v,v);
+  }
+  else
+  {
+    d0 = _mm256_unpacklo_epi32(v,v);
+    d1 = _mm256_unpackhi_epi32(v,v);
+  }
+  _mm256_storeu_si256((__m256i *) o,_mm256_permute2x128_si256(d0,d1,0x20));
+  _mm256_storeu_si256((__m256i *) (o+32),_mm256_permute2x128_si256(d0,d1,0x31));
+  return o+64;
+}
+
+ROWKERNELS_AVX2_ATTR static inline void RowKernels_AVX2(void *out,const ARMword *in,unsigned int count,const void *palette,unsigned int hostbytes,unsigned int bpp,unsigned int scale)
+{
+  uint8_t planes[4][16];
+  __m256i p[4];
+  unsigned int i, k, units = count>>5;
+  uint8_t *o = (uint8_t *) out;
+
+  memset(planes,0,sizeof(planes));
+  for(i=0;i<(1u<<bpp);i++)
+  {
+    uint32_t c = (hostbytes == 2 ? ((const uint16_t *) palette)[i] : ((const uint32_t *) palette)[i]);
+    for(k=0;k<hostbytes;k++)
+      planes[k][i] = (uint8_t) (c>>(8*k));
+  }
+  for(k=0;k<hostbytes;k++)
+    p[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) planes[k]));
+
+  for(i=0;i<units;i++)
+  {
+    __m256i idx = RowKernels_AVX2_Indices(in,bpp);
+    __m256i b0 = _mm256_shuffle_epi8(p[0],idx);
+    __m256i b1 = _mm256_shuffle_epi8(p[1],idx);
+    in += bpp;
+    if(hostbytes == 2)
+    {
+      __m256i lo = _mm256_unpacklo_epi8(b0,b1); /* Pixels 0-7, 16-23 */
+      __m256i hi = _mm256_unpackhi_epi8(b0,b1); /* Pixels 8-15, 24-31 */
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(lo,hi,0x20),hostbytes,scale);
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(lo,hi,0x31),hostbytes,scale);
+    }
+    else
+    {
+      __m256i b2 = _mm256_shuffle_epi8(p[2],idx);
+      __m256i b3 = _mm256_shuffle_epi8(p[3],idx);
+      __m256i lo01 = _mm256_unpacklo_epi8(b0,b1);
+      __m256i hi01 = _mm256_unpackhi_epi8(b0,b1);
+      __m256i lo23 = _mm256_unpacklo_epi8(b2,b3);
+      __m256i hi23 = _mm256_unpackhi_epi8(b2,b3);
+      __m256i q0 = _mm256_unpacklo_epi16(lo01,lo23); /* Pixels 0-3, 16-19 */
+      __m256i q1 = _mm256_unpackhi_epi16(lo01,lo23); /* Pixels 4-7, 20-23 */
+      __m256i q2 = _mm256_unpacklo_epi16(hi01,hi23); /* Pixels 8-11, 24-27 */
+      __m256i q3 = _mm256_unpackhi_epi16(hi01,hi23); /* Pixels 12-15, 28-31 */
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(q0,q1,0x20),hostbytes,scale);
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(q2,q3,0x20),hostbytes,scale);
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(q0,q1,0x31),hostbytes,scale);
+      o = RowKernels_AVX2_Store(o,_mm256_permute2x128_si256(q2,q3,0x31),hostbytes,scale);
+    }
+  }
+
+  RowKernels_C(o,in,count&31,palette,hostbytes,bpp,scale);
+}
+
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,1,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,2,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,4,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,1,1)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,2,1)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,16,4,1)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,1,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,2,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,4,0)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,1,1)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,2,1)
+ROWKERNEL(AVX2,ROWKERNELS_AVX2_ATTR,32,4,1)
+
+static const RowKernelSet RowKernels_AVX2Set = {
+  "AVX2",
+  {
+    {
+      {RowKernel_AVX2_16_1_0,RowKernel_AVX2_16_2_0,RowKernel_AVX2_16_4_0,NULL},
+      {RowKernel_AVX2_16_1_1,RowKernel_AVX2_16_2_1,RowKernel_AVX2_16_4_1,NULL},
+    },
+    {
+      {RowKernel_AVX2_32_1_0,RowKernel_AVX2_32_2_0,RowKernel_AVX2_32_4_0,NULL},
+      {RowKernel_AVX2_32_1_1,RowKernel_AVX2_32_2_1,RowKernel_AVX2_32_4_1,NULL},
+    },
+  },
+};
+#endif
+
+/*
+
+  NEON versions, for 1bpp, 2bpp & 4bpp
+
+  The same byte plane lookups as AVX2, using TBL. The interleaving comes for
+  free with the structure stores.
+
+*/
+
+#ifdef ROWKERNELS_NEON
+static inline uint8_t *RowKernels_NEON_Lookup(uint8_t *o,uint8x16_t idx,const uint8x16_t *p,unsigned int hostbytes,unsigned int scale)
+{
+  /* Look up & store 16 pixels */
+  uint8x16_t b[4];
+  unsigned int k, h;
+  for(k=0;k<hostbytes;k++)
+    b[k] = vqtbl1q_u8(p[k],idx);
+  if(!scale)
+  {
+    if(hostbytes == 2)
+    {
+      uint8x16x2_t s;
+      s.val[0] = b[0];
+      s.val[1] = b[1];
+      vst2q_u8(o,s);
+    }
+    else
+    {
+      uint8x16x4_t s;
+      s.val[0] = b[0];
+      s.val[1] = b[1];
+      s.val[2] = b[2];
+      s.val[3] = b[3];
+      vst4q_u8(o,s);
+    }
+    return o+16*hostbytes;
+  }
+  for(h=0;h<2;h++)
+  {
+    if(hostbytes == 2)
+    {
+      uint8x16x2_t s;
+      s.val[0] = vzipq_u8(b[0],b[0]).val[h];
+      s.val[1] = vzipq_u8(b[1],b[1]).val[h];
+      vst2q_u8(o,s);
+    }
+    else
+    {
+      uint8x16x4_t s;
+      s.val[0] = vzipq_u8(b[0],b[0]).val[h];
+      s.val[1] = vzipq_u8(b[1],b[1]).val[h];
+      s.val[2] = vzipq_u8(b[2],b[2]).val[h];
+      s.val[3] = vzipq_u8(b[3],b[3]).val[h];
+      vst4q_u8(o,s);
+    }
+    o += 16*hostbytes;
+  }
+  return o;
+}
+
+static inline void RowKernels_NEON(void *out,const ARMword *in,unsigned int count,const void *palette,unsigned int hostbytes,unsigned int bpp,unsigned int scale)
+{
+  static const uint8_t spread[2][16] = {
+    {0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1},
+    {2,2,2,2,2,2,2,2,3,3,3,3,3,3,3,3},
+  };
+  static const uint8_t bits[16] = {1,2,4,8,16,32,64,128,1,2,4,8,16,32,64,128};
+  uint8_t planes[4][16];
+  uint8x16_t p[4];
+  unsigned int i, k, units = count>>5;
+  uint8_t *o = (uint8_t *) out;
+
+  memset(planes,0,sizeof(planes));
+  for(i=0;i<(1u<<bpp);i++)
+  {
+    uint32_t c = (hostbytes == 2 ? ((const uint16_t *) palette)[i] : ((const uint32_t *) palette)[i]);
+    for(k=0;k<hostbytes;k++)
+      planes[k][i] = (uint8_t) (c>>(8*k));
+  }
+  for(k=0;k<hostbytes;k++)
+    p[k] = vld1q_u8(planes[k]);
+
+  for(i=0;i<units;i++)
+  {
+    uint8x16_t i0, i1;
+    if(bpp == 1)
+    {
+      uint8x16_t v = vreinterpretq_u8_u32(vdupq_n_u32(in[0]));
+      uint8x16_t one = vdupq_n_u8(1);
+      uint8x16_t b = vld1q_u8(bits);
+      i0 = vandq_u8(vtstq_u8(vqtbl1q_u8(v,vld1q_u8(spread[0])),b),one);
+      i1 = vandq_u8(vtstq_u8(vqtbl1q_u8(v,vld1q_u8(spread[1])),b),one);
+    }
+    else if(bpp == 2)
+    {
+      uint8x8_t b = vld1_u8((const uint8_t *) in);
+      uint8x8x2_t n = vzip_u8(vand_u8(b,vdup_n_u8(0xf)),vshr_n_u8(b,4));
+      uint8x16_t nn = vcombine_u8(n.val[0],n.val[1]);
+      uint8x16x2_t z = vzipq_u8(vandq_u8(nn,vdupq_n_u8(3)),vshrq_n_u8(nn,2));
+      i0 = z.val[0];
+      i1 = z.val[1];
+    }
+    else
+    {
+      uint8x16_t b = vld1q_u8((const uint8_t *) in);
+      uint8x16x2_t z = vzipq_u8(vandq_u8(b,vdupq_n_u8(0xf)),vshrq_n_u8(b,4));
+      i0 = z.val[0];
+      i1 = z.val[1];
+    }
+    in += bpp;
+    o = RowKernels_NEON_Lookup(o,i0,p,hostbytes,scale);
+    o = RowKernels_NEON_Lookup(o,i1,p,hostbytes,scale);
+  }
+
+  RowKernels_C(o,in,count&31,palette,hostbytes,bpp,scale);
+}
+
+ROWKERNEL(NEON,,16,1,0)
+ROWKERNEL(NEON,,16,2,0)
+ROWKERNEL(NEON,,16,4,0)
+ROWKERNEL(NEON,,16,1,1)
+ROWKERNEL(NEON,,16,2,1)
+ROWKERNEL(NEON,,16,4,1)
+ROWKERNEL(NEON,,32,1,0)
+ROWKERNEL(NEON,,32,2,0)
+ROWKERNEL(NEON,,32,4,0)
+ROWKERNEL(NEON,,32,1,1)
+ROWKERNEL(NEON,,32,2,1)
+ROWKERNEL(NEON,,32,4,1)
+
+static const RowKernelSet RowKernels_NEONSet = {
+  "NEON",
+  {
+    {
+      {RowKernel_NEON_16_1_0,RowKernel_NEON_16_2_0,RowKernel_NEON_16_4_0,NULL},
+      {RowKernel_NEON_16_1_1,RowKernel_NEON_16_2_1,RowKernel_NEON_16_4_1,NULL},
+    },
+    {
+      {RowKernel_NEON_32_1_0,RowKernel_NEON_32_2_0,RowKernel_NEON_32_4_0,NULL},
+      {RowKernel_NEON_32_1_1,RowKernel_NEON_32_2_1,RowKernel_NEON_32_4_1,NULL},
+    },
+  },
+};
+#endif
+
+/*
+
+  Selection
+
+*/
+
+const RowKernelSet *RowKernels_Sets[4] = {&RowKernels_CSet};
+
+RowKernel RowKernels[2][2][4] = {
+  {
+    {RowKernel_C_16_1_0,RowKernel_C_16_2_0,RowKernel_C_16_4_0,RowKernel_C_16_8_0},
+    {RowKernel_C_16_1_1,RowKernel_C_16_2_1,RowKernel_C_16_4_1,RowKernel_C_16_8_1},
+  },
+  {
+    {RowKernel_C_32_1_0,RowKernel_C_32_2_0,RowKernel_C_32_4_0,RowKernel_C_32_8_0},
+    {RowKernel_C_32_1_1,RowKernel_C_32_2_1,RowKernel_C_32_4_1,RowKernel_C_32_8_1},
+  },
+};
+
+void RowKernels_Init(void)
+{
+  static bool done = false;
+  int num = 1, i, h, s, b;
+
+  if (done)
+    return;
+  done = true;
+
+#ifdef ROWKERNELS_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("sse2"))
+    RowKernels_Sets[num++] = &RowKernels_SSE2Set;
+  if(__builtin_cpu_supports("avx2"))
+    RowKernels_Sets[num++] = &RowKernels_AVX2Set;
+#endif
+#ifdef ROWKERNELS_NEON
+  RowKernels_Sets[num++] = &RowKernels_NEONSet; /* Always present on ARM64 */
+#endif
+
+  /* Later sets are preferred */
+  for(i=1;i<num;i++)
+    for(h=0;h<2;h++)
+      for(s=0;s<2;s++)
+        for(b=0;b<4;b++)
+          if(RowKernels_Sets[i]->Kernels[h][s][b])
+            RowKernels[h][s][b] = RowKernels_Sets[i]->Kernels[h][s][b];
+}
@@ -0,0 +1,46 @@
+/*
+  arch/rowkernels.h
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Kernels for converting runs of 1/2/4/8bpp VIDC display data into 16 or 32
+  bit host pixels, for display drivers whose rows are plain pixel arrays (see
+  SDD_DirectRows in stddisplaydev.c).
+
+  The C versions are the reference implementations. SIMD versions are used
+  where the CPU supports them (SSE2 & AVX2 on x86, NEON on ARM64), selected by
+  RowKernels_Init.
+*/
+#ifndef ROWKERNELS_H
+#define ROWKERNELS_H
+
+/* Convert 'count' source pixels, starting from bit 0 of in[0], into
+   count<<scale host pixels at 'out'. 'palette' is an array of host pixels,
+   indexed by the source pixel value */
+typedef void (*RowKernel)(void *out,const ARMword *in,unsigned int count,const void *palette);
+
+/* Indices for the kernel tables */
+#define ROWKERNEL_HOST16 0
+#define ROWKERNEL_HOST32 1
+#define ROWKERNEL_1X 0
+#define ROWKERNEL_2X 1
+
+typedef struct {
+  const char *Name;
+  RowKernel Kernels[2][2][4]; /* [host pixel size][scale][log2 bpp], NULL if there's no version for that combination */
+} RowKernelSet;
+
+/* The C set, followed by any SIMD sets which this CPU supports, NULL
+   terminated. Filled in by RowKernels_Init */
+extern const RowKernelSet *RowKernels_Sets[4];
+
+/* The best kernel for each combination. Filled in by RowKernels_Init, and
+   the C versions until then */
+extern RowKernel RowKernels[2][2][4];
+
+/* Choose the kernels for the current CPU. Shared by all machines, so call it
+   before starting any threads */
+extern void RowKernels_Init(void);
+
+#endif
@@ -16,7 +16,7 @@ extern void Sound_Shutdown(ARMul_State *state);
 typedef int16_t SoundData;
 
 extern int Sound_BatchSize; /* How many 16*2 sample batches to attempt to deliver to the platform code at once */
-extern CycleCount Sound_DMARate; /* How many cycles between DMA fetches */
+extern CycleCount Sound_DMARate; /* How many cycles between DMA fetches, for the machine using the host sound system */
 #ifdef SOUND_FUDGERATE_FRAC
 extern uint32_t Sound_FudgeRate; /* New version of Sound_FudgeRate. 8.24 scale factor applied to Sound_DMARate; can be used by host code to fine-tune audio buffer levels */
 #else
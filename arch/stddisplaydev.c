@@ -101,6 +101,26 @@
    SDD_Stats
     - Define this to enable the stats code.
 
+   SDD_DirectRows
+    - Optional. Define this if SDD_Row is a plain SDD_HostColour pointer,
+      SDD_HostColour is a 16 or 32 bit pixel, Host_WritePixel(s) just store
+      through the pointer, and Host_BeginUpdate/Host_EndUpdate do nothing.
+      The row conversion kernels from rowkernels.h (which must be #included)
+      will then be used for most of the display area.
+    - If built with DISPLAY_THREADS, whole frames can also be drawn on worker
+      threads (if CONFIG.iDisplayThreads is set), so displaythreads.h and
+      ArcemConfig.h must be #included too. Hosts must then call
+      SDD_Name(WaitRows) before reading the display buffer anywhere other
+      than from Host_PollDisplay.
+
+   SDD_HostData
+    - Optional. Define this to the type of any per-machine data the host
+      needs; it will be available as HD.Host, zero-initialised.
+
+   void SDD_Name(Host_Shutdown)(ARMul_State *state)
+    - Only needed if SDD_HostData is defined. Called on shutdown, before the
+      HostDisplay struct is freed.
+
 */
 
 
@@ -138,6 +158,8 @@ enum vidstat {
   vidstat_ForceRefreshBPP,
   vidstat_RefreshFlagsVinit,
   vidstat_RefreshFlagsPalette,
+  vidstat_WholeFrames,
+  vidstat_RasterCatchUps,
   vidstat_MAX,
 };
 static uint32_t vidstats[vidstat_MAX];
@@ -158,6 +180,8 @@ static const char *vidstatnames[vidstat_MAX] = {
  "ForceRefreshBPP: Frames where ForceRefresh was set due to BPP change",
  "RefreshFlagsVinit: Frames where RefreshFlags were set due to Vinit change",
  "RefreshFlagsPalette: Palette writes causing RefreshFlags to be set",
+ "WholeFrames: Frames scheduled to be drawn in one go at VSync",
+ "RasterCatchUps: Mid-frame register writes which ended a WholeFrame",
 };
 
 static void vidstats_Dump(const char *c)
@@ -172,6 +196,29 @@ static void vidstats_Dump(const char *c)
 }
 #endif
 
+/* Number of update blocks tracked for each row. A row of 2046 8bpp pixels
+   spans at most 10, if it wraps at Vend. Blocks past this are always redrawn */
+#define SDD_ROWBLOCKS 16
+
+/* Display rows can be handed to worker threads (see displaythreads.h) if the
+   host's Host_* functions just store to plain pixel rows. Not with the stats
+   code, as its counters aren't thread safe */
+#if defined(SDD_DirectRows) && defined(DISPLAY_THREADS) && !defined(SDD_Stats)
+#define SDD_Threads
+#endif
+
+/* Where the display area of a row comes from. Filled in by GetRowSource from
+   the current MEMC & palette state, or for worker threads, from a copy of it
+   taken when the rows are queued */
+struct SDD_Name(RowSource) {
+  const ARMword *RAM; /* MEMC.PhysRam, or a copy of the screen memory */
+  const uint32_t *UpdateFlags; /* MEMC.UpdateFlags, or a copy */
+  const SDD_HostColour *Palette; /* HD.Palette, or a copy */
+  uint32_t Vstart, Vend; /* DMA start & end, in bits, Vend pointing to the bit after the end */
+  int Width; /* Row width in pixels (DC.LastHostWidth) */
+  int Log2BPP, XScale; /* For selecting the row function */
+};
+
 /*
 
   Main struct
@@ -208,6 +255,8 @@ struct SDD_Name(DisplayInfo) {
     uint32_t Vptr; /* DMA pointer, in bits, as offset from start of phys RAM */
     uint_least16_t LastVinit; /* Last Vinit, so we can sync changes with the frame start */
     int FrameSkip; /* Current frame skip counter */
+    bool WholeFrame; /* Set while the rows up to VSync are left for a single RowStart event to draw */
+    int RasterHoldoff; /* Number of frames left to draw row by row following a mid-frame register write */
 
     /* DisplayDev_AutoUpdateFlags logic */
 
@@ -225,7 +274,36 @@ struct SDD_Name(DisplayInfo) {
     SDD_HostColour Palette[256]; /* Host palette */
     SDD_HostColour BorderCols[1024]; /* Last border colour used for each scanline */
     uint32_t RefreshFlags[1024/32]; /* Bit flags of which display scanlines need full refresh due to Vstart/Vend/palette changes */
-    uint32_t UpdateFlags[1024][(512*1024)/UPDATEBLOCKSIZE]; /* Flags for each scanline (8MB of flags - ouch!) */
+    struct {
+      uint32_t Vptr; /* DMA pointer at the start of the row when the flags were copied */
+      uint32_t Flags[SDD_ROWBLOCKS]; /* Copies of MEMC.UpdateFlags for each update block the row covers, in the order they're met */
+    } UpdateFlags[1024]; /* Flags for each scanline */
+
+#ifdef SDD_Threads
+    struct {
+      DisplayThreads *Pool; /* Worker threads, or NULL if rows are drawn by the emulator thread */
+      int NumThreads;
+      bool Queue; /* Set while RowStart is queueing display rows instead of drawing them */
+      bool Busy; /* Set while the workers may be drawing the queued rows */
+      bool NoFlags; /* Whether the rows are for DisplayDev_UseUpdateFlags == 0 */
+      int Count; /* Number of queued rows */
+      uint32_t Lo, Hi; /* Range of screen memory the queued rows read, in bits */
+      struct {
+        int Row; /* Source row */
+        int HostStart, HostEnd; /* Host rows to draw it to */
+        int Flags; /* Row function flags */
+        uint32_t Vptr; /* DMA pointer at the start of the row */
+      } Rows[1024];
+      struct SDD_Name(RowSource) Src; /* Where the rows come from; points to the copies below once the rows are handed to the workers */
+      ARMword *RAM; /* Copy of the screen memory, laid out as per MEMC.PhysRam */
+      uint32_t UpdateFlags[(512*1024)/UPDATEBLOCKSIZE]; /* Copy of MEMC.UpdateFlags */
+      SDD_HostColour Palette[256]; /* Copy of HD.Palette */
+    } Threads;
+#endif
+
+#ifdef SDD_HostData
+    SDD_HostData Host; /* Host-specific data */
+#endif
   } HostDisplay;
 };
 
@@ -328,11 +406,12 @@ static inline void SDD_Name(PaletteUpdate8bpp)(ARMul_State *state,SDD_HostColour
 
 /* Prototype of a function used for updating the display area of a row.
    'drow' is expected to already be pointing to the start of the display area
+   '*vptr' is the DMA pointer, which is advanced past the row
    Returns non-zero if the row was updated
 */
-typedef int (*SDD_Name(RowFunc))(ARMul_State *state,int row,SDD_Row drow,int flags);
+typedef int (*SDD_Name(RowFunc))(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags);
 /* Alternate version for when UpdateFlags are disabled */
-typedef void (*SDD_Name(RowFuncNoFlags))(ARMul_State *state,SDD_Row drow);
+typedef void (*SDD_Name(RowFuncNoFlags))(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow);
 
 
 #define ROWFUNC_FORCE 0x1 /* Force row to be fully redrawn */
@@ -340,6 +419,32 @@ typedef void (*SDD_Name(RowFuncNoFlags))(ARMul_State *state,SDD_Row drow);
 
 #define ROWFUNC_UPDATED 0x4 /* Flag used internally by rowfuncs to indicate whether anything was done */
 
+/* Convert a region of the row using the row kernels, if possible. Returns
+   false if the region needs doing by hand. Available is in bits, as per the
+   rowfuncs */
+static inline bool SDD_Name(RowKernel)(SDD_Row *drow,const ARMword *RAM,uint32_t Vptr,int Available,unsigned int log2bpp,unsigned int scale,const SDD_HostColour *Palette)
+{
+#ifdef SDD_DirectRows
+  unsigned int count = ((unsigned int) Available)>>log2bpp;
+  /* The kernels start from the beginning of a word, which almost every
+     region will (Vstart/Vinit/UpdateFlags are all multiples of 16 bytes) */
+  if(Vptr & 31)
+    return false;
+  (RowKernels[(sizeof(SDD_HostColour) == 4) ? ROWKERNEL_HOST32 : ROWKERNEL_HOST16][scale][log2bpp])(*drow,RAM+(Vptr>>5),count,Palette);
+  *drow += count<<scale;
+  return true;
+#else
+  UNUSED_VAR(drow);
+  UNUSED_VAR(RAM);
+  UNUSED_VAR(Vptr);
+  UNUSED_VAR(Available);
+  UNUSED_VAR(log2bpp);
+  UNUSED_VAR(scale);
+  UNUSED_VAR(Palette);
+  return false;
+#endif
+}
+
 /*
 
   Screen output for 1X horizontal scaling
@@ -348,62 +453,65 @@ typedef void (*SDD_Name(RowFuncNoFlags))(ARMul_State *state,SDD_Row drow);
 
 */
 
-static int SDD_Name(RowFunc1bpp1X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc1bpp1X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,2);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth;
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width;
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       ARMword Bit, Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available);
-      In = RAM+(Vptr>>5);
-      Bit = 1<<(Vptr & 31);
-      Data = *In++;
-      for(i=0;i<Available;i++)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,0,0,Palette))
       {
-        int idx = (Data & Bit)?1:0;
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[idx]);
-        Bit <<= 1;
-        if(!Bit)
+        In = RAM+(Vptr>>5);
+        Bit = 1<<(Vptr & 31);
+        Data = *In++;
+        for(i=0;i<Available;i++)
         {
-          Bit = 1;
-          Data = *In++;
+          int idx = (Data & Bit)?1:0;
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[idx]);
+          Bit <<= 1;
+          if(!Bit)
+          {
+            Bit = 1;
+            Data = *In++;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -415,20 +523,27 @@ static int SDD_Name(RowFunc1bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -440,64 +555,67 @@ static int SDD_Name(RowFunc1bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc2bpp1X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc2bpp1X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,4);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*2; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*2; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available>>1);
-      In = RAM+(Vptr>>5);
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=2)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,1,0,Palette))
       {
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 3]);
-        Data >>= 2;
-        Shift += 2;
-        if(Shift == 32)
+        In = RAM+(Vptr>>5);
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=2)
         {
-          Shift = 0;
-          Data = *In++;
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 3]);
+          Data >>= 2;
+          Shift += 2;
+          if(Shift == 32)
+          {
+            Shift = 0;
+            Data = *In++;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -509,20 +627,27 @@ static int SDD_Name(RowFunc2bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -534,69 +659,72 @@ static int SDD_Name(RowFunc2bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc4bpp1X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc4bpp1X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,16);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*4; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*4; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available>>2);
 
-      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-      In = RAM+(Vptr>>5);      
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=8)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,2,0,Palette))
       {
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
-        Data >>= 4;
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
-        Data >>= 4;
-        Shift += 8;
-        if(Shift == 32)
+        /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+        In = RAM+(Vptr>>5);      
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=8)
         {
-          Shift = 0;
-          Data = *In++;
-        }        
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
+          Data >>= 4;
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
+          Data >>= 4;
+          Shift += 8;
+          if(Shift == 32)
+          {
+            Shift = 0;
+            Data = *In++;
+          }        
+        }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
     }
@@ -607,20 +735,27 @@ static int SDD_Name(RowFunc4bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -632,71 +767,74 @@ static int SDD_Name(RowFunc4bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc8bpp1X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc8bpp1X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate8bpp)(state,Palette);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*8; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*8; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available>>3);
 
-      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-      In = RAM+(Vptr>>5);
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=16)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,3,0,Palette))
       {
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
-        Data >>= 8;
-        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
-        if(Shift)
+        /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+        In = RAM+(Vptr>>5);
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=16)
         {
-          Shift = 0;
-          Data = *In++;
-        }
-        else
-        {
-          Shift = 16;
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
           Data >>= 8;
+          SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
+          if(Shift)
+          {
+            Shift = 0;
+            Data = *In++;
+          }
+          else
+          {
+            Shift = 16;
+            Data >>= 8;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -708,20 +846,27 @@ static int SDD_Name(RowFunc8bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -741,62 +886,65 @@ static int SDD_Name(RowFunc8bpp1X)(ARMul_State *state,int row,SDD_Row drow,int f
 
 */
 
-static int SDD_Name(RowFunc1bpp2X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc1bpp2X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,2);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth;
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width;
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       ARMword Bit, Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available<<1);
-      In = RAM+(Vptr>>5);
-      Bit = 1<<(Vptr & 31);
-      Data = *In++;
-      for(i=0;i<Available;i++)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,0,1,Palette))
       {
-        int idx = (Data & Bit)?1:0;
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[idx],2);
-        Bit <<= 1;
-        if(!Bit)
+        In = RAM+(Vptr>>5);
+        Bit = 1<<(Vptr & 31);
+        Data = *In++;
+        for(i=0;i<Available;i++)
         {
-          Bit = 1;
-          Data = *In++;
+          int idx = (Data & Bit)?1:0;
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[idx],2);
+          Bit <<= 1;
+          if(!Bit)
+          {
+            Bit = 1;
+            Data = *In++;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -808,20 +956,27 @@ static int SDD_Name(RowFunc1bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -833,64 +988,67 @@ static int SDD_Name(RowFunc1bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc2bpp2X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc2bpp2X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,4);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*2; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*2; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available);
-      In = RAM+(Vptr>>5);
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=2)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,1,1,Palette))
       {
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 3],2);
-        Data >>= 2;
-        Shift += 2;
-        if(Shift == 32)
+        In = RAM+(Vptr>>5);
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=2)
         {
-          Shift = 0;
-          Data = *In++;
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 3],2);
+          Data >>= 2;
+          Shift += 2;
+          if(Shift == 32)
+          {
+            Shift = 0;
+            Data = *In++;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -902,20 +1060,27 @@ static int SDD_Name(RowFunc2bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -927,69 +1092,72 @@ static int SDD_Name(RowFunc2bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc4bpp2X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc4bpp2X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,16);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*4; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*4; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available>>1);
 
-      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-      In = RAM+(Vptr>>5);      
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=8)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,2,1,Palette))
       {
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
-        Data >>= 4;
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
-        Data >>= 4;
-        Shift += 8;
-        if(Shift == 32)
+        /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+        In = RAM+(Vptr>>5);      
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=8)
         {
-          Shift = 0;
-          Data = *In++;
-        }        
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
+          Data >>= 4;
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
+          Data >>= 4;
+          Shift += 8;
+          if(Shift == 32)
+          {
+            Shift = 0;
+            Data = *In++;
+          }        
+        }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
     }
@@ -1000,20 +1168,27 @@ static int SDD_Name(RowFunc4bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -1025,71 +1200,74 @@ static int SDD_Name(RowFunc4bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
   return (flags & ROWFUNC_UPDATED);
 }
 
-static int SDD_Name(RowFunc8bpp2X)(ARMul_State *state,int row,SDD_Row drow,int flags)
+static int SDD_Name(RowFunc8bpp2X)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,SDD_Row drow,int flags)
 {
-  int i, Remaining, startRemain;
+  int i, Remaining, startRemain, Slot;
   uint32_t Vptr, Vstart, Vend, startVptr;
   const ARMword *RAM;
   const uint32_t *MEMC_UpdateFlags;
   uint32_t *HD_UpdateFlags;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate8bpp)(state,Palette);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*8; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*8; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
   /* Process the row */
   startVptr = Vptr;
   startRemain = Remaining;
-  MEMC_UpdateFlags = MEMC.UpdateFlags;
-  HD_UpdateFlags = HD.UpdateFlags[row];
+  MEMC_UpdateFlags = src->UpdateFlags;
+  HD_UpdateFlags = HD.UpdateFlags[row].Flags;
+  /* If the row has moved, the flag copies are for different blocks */
+  if(HD.UpdateFlags[row].Vptr != Vptr)
+    flags |= ROWFUNC_FORCE;
+  Slot = 0;
   while(Remaining > 0)
   {
     uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
     /* Note: This is the number of available bits, not pixels */
     int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
       
-    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]))
+    if((flags & ROWFUNC_FORCE) || (HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]))
     {
       const ARMword *In;
       uint32_t Shift;
       ARMword Data;
       VIDEO_STAT(DisplayRedraw,1,1);
       VIDEO_STAT(DisplayRedrawForced,(flags & ROWFUNC_FORCE),1);
-      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[FlagsOffset] != MEMC_UpdateFlags[FlagsOffset]),1);
+      VIDEO_STAT(DisplayRedrawUpdated,(HD_UpdateFlags[Slot] != MEMC_UpdateFlags[FlagsOffset]),1);
       VIDEO_STAT(DisplayBits,1,Available);
       flags |= ROWFUNC_UPDATED;
       /* Process the pixels in this region, stopping at end of row/update block/Vend */
       SDD_Name(Host_BeginUpdate)(state,&drow,Available>>2);
 
-      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-      In = RAM+(Vptr>>5);
-      Shift = (Vptr & 31);
-      Data = (*In++) >> Shift;
-      for(i=0;i<Available;i+=16)
+      if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,3,1,Palette))
       {
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
-        Data >>= 8;
-        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
-        if(Shift)
-        {
-          Shift = 0;
-          Data = *In++;
-        }
-        else
+        /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+        In = RAM+(Vptr>>5);
+        Shift = (Vptr & 31);
+        Data = (*In++) >> Shift;
+        for(i=0;i<Available;i+=16)
         {
-          Shift = 16;
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
           Data >>= 8;
+          SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
+          if(Shift)
+          {
+            Shift = 0;
+            Data = *In++;
+          }
+          else
+          {
+            Shift = 16;
+            Data >>= 8;
+          }
         }
       }
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -1101,20 +1279,27 @@ static int SDD_Name(RowFunc8bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
     Vptr += Available;
     if(Vptr >= Vend)
       Vptr = Vstart;
+    if(++Slot == SDD_ROWBLOCKS)
+    {
+      /* Too many blocks to track, redraw the rest of the row */
+      flags |= ROWFUNC_FORCE;
+      Slot = 0;
+    }
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
         
   /* If we updated anything, copy over the updated flags (Done last in case the same flags block is encountered multiple times in the same row) */
   if((flags & (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS)) == (ROWFUNC_UPDATED | ROWFUNC_UPDATEFLAGS))
   {
     Vptr = startVptr;
     Remaining = startRemain;
-    while(Remaining > 0)
+    HD.UpdateFlags[row].Vptr = startVptr;
+    for(Slot=0;(Remaining > 0) && (Slot < SDD_ROWBLOCKS);Slot++)
     {
       uint32_t FlagsOffset = Vptr/(8*UPDATEBLOCKSIZE);
       int Available = MIN((uint32_t)Remaining,MIN(((FlagsOffset+1)*8*UPDATEBLOCKSIZE)-Vptr,Vend-Vptr));
   
-      HD_UpdateFlags[FlagsOffset] = MEMC_UpdateFlags[FlagsOffset];
+      HD_UpdateFlags[Slot] = MEMC_UpdateFlags[FlagsOffset];
       
       Remaining -= Available;      
       Vptr += Available;
@@ -1134,24 +1319,20 @@ static int SDD_Name(RowFunc8bpp2X)(ARMul_State *state,int row,SDD_Row drow,int f
 
 */
 
-static void SDD_Name(RowFunc1bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc1bpp1XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,2);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth;
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width;
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1165,18 +1346,21 @@ static void SDD_Name(RowFunc1bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayRedraw,1,1);
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
-    In = RAM+(Vptr>>5);
-    Bit = 1<<(Vptr & 31);
-    Data = *In++;
-    for(i=0;i<Available;i++)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,0,0,Palette))
     {
-      int idx = (Data & Bit)?1:0;
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[idx]);
-      Bit <<= 1;
-      if(!Bit)
+      In = RAM+(Vptr>>5);
+      Bit = 1<<(Vptr & 31);
+      Data = *In++;
+      for(i=0;i<Available;i++)
       {
-        Bit = 1;
-        Data = *In++;
+        int idx = (Data & Bit)?1:0;
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[idx]);
+        Bit <<= 1;
+        if(!Bit)
+        {
+          Bit = 1;
+          Data = *In++;
+        }
       }
     }
     Remaining -= Available;      
@@ -1184,28 +1368,24 @@ static void SDD_Name(RowFunc1bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc2bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc2bpp1XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,4);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*2; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*2; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1221,18 +1401,21 @@ static void SDD_Name(RowFunc2bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayRedraw,1,1);
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
-    In = RAM+(Vptr>>5);
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=2)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,1,0,Palette))
     {
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 3]);
-      Data >>= 2;
-      Shift += 2;
-      if(Shift == 32)
+      In = RAM+(Vptr>>5);
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=2)
       {
-        Shift = 0;
-        Data = *In++;
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 3]);
+        Data >>= 2;
+        Shift += 2;
+        if(Shift == 32)
+        {
+          Shift = 0;
+          Data = *In++;
+        }
       }
     }
 
@@ -1241,28 +1424,24 @@ static void SDD_Name(RowFunc2bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc4bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc4bpp1XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,16);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*4; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*4; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1279,22 +1458,25 @@ static void SDD_Name(RowFunc4bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
 
-    /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-    In = RAM+(Vptr>>5);      
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=8)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,2,0,Palette))
     {
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
-      Data >>= 4;
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
-      Data >>= 4;
-      Shift += 8;
-      if(Shift == 32)
+      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+      In = RAM+(Vptr>>5);      
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=8)
       {
-        Shift = 0;
-        Data = *In++;
-      }        
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
+        Data >>= 4;
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xf]);
+        Data >>= 4;
+        Shift += 8;
+        if(Shift == 32)
+        {
+          Shift = 0;
+          Data = *In++;
+        }        
+      }
     }
 
     Remaining -= Available;      
@@ -1302,28 +1484,24 @@ static void SDD_Name(RowFunc4bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc8bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc8bpp1XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate8bpp)(state,Palette);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*8; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*8; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1340,24 +1518,27 @@ static void SDD_Name(RowFunc8bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
 
-    /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-    In = RAM+(Vptr>>5);
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=16)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,3,0,Palette))
     {
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
-      Data >>= 8;
-      SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
-      if(Shift)
-      {
-        Shift = 0;
-        Data = *In++;
-      }
-      else
+      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+      In = RAM+(Vptr>>5);
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=16)
       {
-        Shift = 16;
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
         Data >>= 8;
+        SDD_Name(Host_WritePixel)(state,&drow,Palette[Data & 0xff]);
+        if(Shift)
+        {
+          Shift = 0;
+          Data = *In++;
+        }
+        else
+        {
+          Shift = 16;
+          Data >>= 8;
+        }
       }
     }
 
@@ -1366,7 +1547,7 @@ static void SDD_Name(RowFunc8bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
@@ -1378,24 +1559,20 @@ static void SDD_Name(RowFunc8bpp1XNoFlags)(ARMul_State *state,SDD_Row drow)
 
 */
 
-static void SDD_Name(RowFunc1bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc1bpp2XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,2);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth;
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width;
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1409,18 +1586,21 @@ static void SDD_Name(RowFunc1bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayRedraw,1,1);
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
-    In = RAM+(Vptr>>5);
-    Bit = 1<<(Vptr & 31);
-    Data = *In++;
-    for(i=0;i<Available;i++)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,0,1,Palette))
     {
-      int idx = (Data & Bit)?1:0;
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[idx],2);
-      Bit <<= 1;
-      if(!Bit)
+      In = RAM+(Vptr>>5);
+      Bit = 1<<(Vptr & 31);
+      Data = *In++;
+      for(i=0;i<Available;i++)
       {
-        Bit = 1;
-        Data = *In++;
+        int idx = (Data & Bit)?1:0;
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[idx],2);
+        Bit <<= 1;
+        if(!Bit)
+        {
+          Bit = 1;
+          Data = *In++;
+        }
       }
     }
 
@@ -1429,28 +1609,24 @@ static void SDD_Name(RowFunc1bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc2bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc2bpp2XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,4);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*2; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*2; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1466,18 +1642,21 @@ static void SDD_Name(RowFunc2bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayRedraw,1,1);
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
-    In = RAM+(Vptr>>5);
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=2)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,1,1,Palette))
     {
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 3],2);
-      Data >>= 2;
-      Shift += 2;
-      if(Shift == 32)
+      In = RAM+(Vptr>>5);
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=2)
       {
-        Shift = 0;
-        Data = *In++;
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 3],2);
+        Data >>= 2;
+        Shift += 2;
+        if(Shift == 32)
+        {
+          Shift = 0;
+          Data = *In++;
+        }
       }
     }
 
@@ -1486,28 +1665,24 @@ static void SDD_Name(RowFunc2bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc4bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc4bpp2XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate)(state,Palette,16);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*4; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*4; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1524,22 +1699,25 @@ static void SDD_Name(RowFunc4bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
 
-    /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-    In = RAM+(Vptr>>5);      
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=8)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,2,1,Palette))
     {
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
-      Data >>= 4;
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
-      Data >>= 4;
-      Shift += 8;
-      if(Shift == 32)
+      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+      In = RAM+(Vptr>>5);      
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=8)
       {
-        Shift = 0;
-        Data = *In++;
-      }        
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
+        Data >>= 4;
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xf],2);
+        Data >>= 4;
+        Shift += 8;
+        if(Shift == 32)
+        {
+          Shift = 0;
+          Data = *In++;
+        }        
+      }
     }
 
     Remaining -= Available;      
@@ -1547,28 +1725,24 @@ static void SDD_Name(RowFunc4bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
-static void SDD_Name(RowFunc8bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
+static void SDD_Name(RowFunc8bpp2XNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,SDD_Row drow)
 {
   int i, Remaining;
   uint32_t Vptr, Vstart, Vend;
   const ARMword *RAM;
-  SDD_HostColour *Palette = HD.Palette;
-  /* Handle palette updates */
-  SDD_Name(PaletteUpdate8bpp)(state,Palette);
+  const SDD_HostColour *Palette = src->Palette;
 
-  Vptr = DC.Vptr;
-  Vstart = MEMC.Vstart<<7;
-  Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
-  RAM = MEMC.PhysRam;
-  Remaining = DC.LastHostWidth*8; /* Scale up to account for everything else counting in bits */
+  Vptr = *vptr;
+  Vstart = src->Vstart;
+  Vend = src->Vend;
+  RAM = src->RAM;
+  Remaining = src->Width*8; /* Scale up to account for everything else counting in bits */
 
-  /* Sanity checks to avoid looping forever */
-  if(Vend == Vstart)
-    Vend = Vstart+128;
+  /* Sanity check to avoid looping forever */
   if(Vptr >= Vend)
     Vptr = Vstart;
 
@@ -1585,24 +1759,27 @@ static void SDD_Name(RowFunc8bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     VIDEO_STAT(DisplayBits,1,Available);
     /* Process the pixels in this region, stopping at end of row/Vend */
 
-    /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
-    In = RAM+(Vptr>>5);
-    Shift = (Vptr & 31);
-    Data = (*In++) >> Shift;
-    for(i=0;i<Available;i+=16)
+    if(!SDD_Name(RowKernel)(&drow,RAM,Vptr,Available,3,1,Palette))
     {
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
-      Data >>= 8;
-      SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
-      if(Shift)
-      {
-        Shift = 0;
-        Data = *In++;
-      }
-      else
+      /* Display will always be a multiple of 2 pixels wide, so we can simplify things a bit compared to 1/2bpp case */
+      In = RAM+(Vptr>>5);
+      Shift = (Vptr & 31);
+      Data = (*In++) >> Shift;
+      for(i=0;i<Available;i+=16)
       {
-        Shift = 16;
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
         Data >>= 8;
+        SDD_Name(Host_WritePixels)(state,&drow,Palette[Data & 0xff],2);
+        if(Shift)
+        {
+          Shift = 0;
+          Data = *In++;
+        }
+        else
+        {
+          Shift = 16;
+          Data >>= 8;
+        }
       }
     }
 
@@ -1611,7 +1788,7 @@ static void SDD_Name(RowFunc8bpp2XNoFlags)(ARMul_State *state,SDD_Row drow)
     if(Vptr >= Vend)
       Vptr = Vstart;
   }
-  DC.Vptr = Vptr;
+  *vptr = Vptr;
   SDD_Name(Host_EndUpdate)(state,&drow);
 }
 
@@ -1672,14 +1849,102 @@ static const SDD_Name(RowFunc) SDD_Name(RowFuncs)[2][4] = {
  }
 };
 
+static void SDD_Name(GetRowSource)(ARMul_State *state,struct SDD_Name(RowSource) *src)
+{
+  int log2bpp = (DC.VIDC_CR&0xc)>>2;
+  /* Handle palette updates */
+  if(log2bpp == 3)
+    SDD_Name(PaletteUpdate8bpp)(state,HD.Palette);
+  else
+    SDD_Name(PaletteUpdate)(state,HD.Palette,1<<(1<<log2bpp));
+
+  src->RAM = MEMC.PhysRam;
+  src->UpdateFlags = MEMC.UpdateFlags;
+  src->Palette = HD.Palette;
+  src->Vstart = MEMC.Vstart<<7;
+  src->Vend = (MEMC.Vend+1)<<7; /* Point to pixel after end */
+  /* Sanity check to avoid looping forever */
+  if(src->Vend == src->Vstart)
+    src->Vend = src->Vstart+128;
+  src->Width = DC.LastHostWidth;
+  src->Log2BPP = log2bpp;
+  src->XScale = HD.XScale;
+}
+
+#ifdef SDD_Threads
+static void SDD_Name(QueueRow)(ARMul_State *state,int row,int hoststart,int hostend,int rowflags)
+{
+  /* Record a display row for the worker threads to draw, and step DC.Vptr
+     past it the same way the row function would. Also keeps track of the
+     range of memory the rows read, for StartRows to copy */
+  const struct SDD_Name(RowSource) *src = &HD.Threads.Src;
+  uint32_t Vptr = DC.Vptr;
+  int Remaining = src->Width<<src->Log2BPP;
+  int i = HD.Threads.Count++;
+  HD.Threads.Rows[i].Row = row;
+  HD.Threads.Rows[i].HostStart = hoststart;
+  HD.Threads.Rows[i].HostEnd = hostend;
+  HD.Threads.Rows[i].Flags = rowflags;
+  HD.Threads.Rows[i].Vptr = Vptr;
+  if(Vptr >= src->Vend)
+    Vptr = src->Vstart;
+  while(Remaining > 0)
+  {
+    int Available = MIN((uint32_t)Remaining,src->Vend-Vptr);
+    HD.Threads.Lo = MIN(HD.Threads.Lo,Vptr);
+    HD.Threads.Hi = MAX(HD.Threads.Hi,Vptr+Available);
+    Remaining -= Available;
+    Vptr += Available;
+    if(Vptr >= src->Vend)
+      Vptr = src->Vstart;
+  }
+  DC.Vptr = Vptr;
+}
+#endif
+
+static void SDD_Name(DisplayArea)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int row,int hoststart,int hostend,int rowflags)
+{
+  /* Draw the display area of a row to host rows hoststart to hostend-1 */
+  const SDD_Name(RowFunc) *rf = &SDD_Name(RowFuncs)[src->XScale-1][src->Log2BPP];
+  SDD_Row drow = SDD_Name(Host_BeginRow)(state,hoststart++,HD.XOffset);
+  if(hoststart == hostend)
+  {
+    if((*rf)(state,src,vptr,row,drow,rowflags | ROWFUNC_UPDATEFLAGS))
+    {
+      VIDEO_STAT(DisplayRowRedraw,1,1);
+    }
+    SDD_Name(Host_EndRow)(state,&drow);
+  }
+  else
+  {
+    /* Remember current Vptr */
+    uint32_t Vptr = *vptr;
+    int updated = (*rf)(state,src,vptr,row,drow,rowflags);
+    SDD_Name(Host_EndRow)(state,&drow);
+    if(updated)
+    {
+      VIDEO_STAT(DisplayRowRedraw,1,1);
+      /* Call the same func again on the same source data to update the copies of this scanline */
+      while(hoststart < hostend)
+      {
+        *vptr = Vptr;
+        drow = SDD_Name(Host_BeginRow)(state,hoststart++,HD.XOffset);
+        if(hoststart == hostend)
+          rowflags |= ROWFUNC_UPDATEFLAGS;
+        (*rf)(state,src,vptr,row,drow,rowflags);
+        SDD_Name(Host_EndRow)(state,&drow);
+      }
+    }
+  }
+}
+
 static void SDD_Name(DisplayRow)(ARMul_State *state,int row)
 {
   int rowflags;
   SDD_HostColour col;
   bool colourChanged;
   uint32_t flags, bit;
-  SDD_Row drow;
-  const SDD_Name(RowFunc) *rf;
+  struct SDD_Name(RowSource) src;
   /* Render a display row */
   int hoststart = (row-(VIDC.Vert_DisplayStart+1))*HD.YScale+HD.YOffset;
   int hostend = hoststart + HD.YScale;
@@ -1705,7 +1970,7 @@ static void SDD_Name(DisplayRow)(ARMul_State *state,int row)
     for(i=hoststart;i<hostend;i++)
     {
       int displaywidth, rightborder;
-      drow = SDD_Name(Host_BeginRow)(state,i,0);
+      SDD_Row drow = SDD_Name(Host_BeginRow)(state,i,0);
       SDD_Name(Host_BeginUpdate)(state,&drow,HD.XOffset);
       SDD_Name(Host_WritePixels)(state,&drow,col,HD.XOffset);
       SDD_Name(Host_EndUpdate)(state,&drow);
@@ -1730,37 +1995,15 @@ static void SDD_Name(DisplayRow)(ARMul_State *state,int row)
     HD.RefreshFlags[row>>5] = (flags &~ bit);
   }
 
-  drow = SDD_Name(Host_BeginRow)(state,hoststart++,HD.XOffset);
-  rf = &SDD_Name(RowFuncs)[HD.XScale-1][(DC.VIDC_CR&0xc)>>2];
-  if(hoststart == hostend)
-  {
-    if((*rf)(state,row,drow,rowflags | ROWFUNC_UPDATEFLAGS))
-    {
-      VIDEO_STAT(DisplayRowRedraw,1,1);
-    }
-    SDD_Name(Host_EndRow)(state,&drow);
-  }
-  else
+#ifdef SDD_Threads
+  if(HD.Threads.Queue)
   {
-    /* Remember current Vptr */
-    uint32_t Vptr = DC.Vptr;
-    int updated = (*rf)(state,row,drow,rowflags);
-    SDD_Name(Host_EndRow)(state,&drow);
-    if(updated)
-    {
-      VIDEO_STAT(DisplayRowRedraw,1,1);
-      /* Call the same func again on the same source data to update the copies of this scanline */
-      while(hoststart < hostend)
-      {
-        DC.Vptr = Vptr;
-        drow = SDD_Name(Host_BeginRow)(state,hoststart++,HD.XOffset);
-        if(hoststart == hostend)
-          rowflags |= ROWFUNC_UPDATEFLAGS;
-        (*rf)(state,row,drow,rowflags);
-        SDD_Name(Host_EndRow)(state,&drow);
-      }
-    }
+    SDD_Name(QueueRow)(state,row,hoststart,hostend,rowflags);
+    return;
   }
+#endif
+  SDD_Name(GetRowSource)(state,&src);
+  SDD_Name(DisplayArea)(state,&src,&DC.Vptr,row,hoststart,hostend,rowflags);
 }
 
 static const SDD_Name(RowFuncNoFlags) SDD_Name(RowFuncsNoFlags)[2][4] = {
@@ -1778,12 +2021,27 @@ static const SDD_Name(RowFuncNoFlags) SDD_Name(RowFuncsNoFlags)[2][4] = {
  }
 };
 
+static void SDD_Name(DisplayAreaNoFlags)(ARMul_State *state,const struct SDD_Name(RowSource) *src,uint32_t *vptr,int hoststart,int hostend)
+{
+  /* Draw the display area of a row to host rows hoststart to hostend-1 */
+  const SDD_Name(RowFuncNoFlags) *rf = &SDD_Name(RowFuncsNoFlags)[src->XScale-1][src->Log2BPP];
+  /* Remember current Vptr */
+  uint32_t Vptr = *vptr;
+  do
+  {
+    SDD_Row drow;
+    *vptr = Vptr;
+    drow = SDD_Name(Host_BeginRow)(state,hoststart,HD.XOffset);
+    (*rf)(state,src,vptr,drow);
+    SDD_Name(Host_EndRow)(state,&drow);
+  } while(++hoststart < hostend);
+}
+
 static void SDD_Name(DisplayRowNoFlags)(ARMul_State *state,int row)
 {
   SDD_HostColour col;
   bool colourChanged;
-  const SDD_Name(RowFuncNoFlags) *rf;
-  uint32_t Vptr;
+  struct SDD_Name(RowSource) src;
   /* Render a display row */
   int hoststart = (row-(VIDC.Vert_DisplayStart+1))*HD.YScale+HD.YOffset;
   int hostend = hoststart + HD.YScale;
@@ -1824,25 +2082,123 @@ static void SDD_Name(DisplayRowNoFlags)(ARMul_State *state,int row)
 
   /* Display area */
 
-  rf = &SDD_Name(RowFuncsNoFlags)[HD.XScale-1][(DC.VIDC_CR&0xc)>>2];
-  /* Remember current Vptr */
-  Vptr = DC.Vptr;
-  do
+#ifdef SDD_Threads
+  if(HD.Threads.Queue)
   {
-    SDD_Row drow;
-    DC.Vptr = Vptr;
-    drow = SDD_Name(Host_BeginRow)(state,hoststart,HD.XOffset);
-    (*rf)(state,drow);
-    SDD_Name(Host_EndRow)(state,&drow);
-  } while(++hoststart < hostend);
+    SDD_Name(QueueRow)(state,row,hoststart,hostend,0);
+    return;
+  }
+#endif
+  SDD_Name(GetRowSource)(state,&src);
+  SDD_Name(DisplayAreaNoFlags)(state,&src,&DC.Vptr,hoststart,hostend);
+}
+
+/*
+
+  Worker threads
+
+  When a whole frame is drawn in one go (see below), the display rows are
+  queued up instead, along with the flags & DMA pointer each one starts with.
+  StartRows then copies the screen memory, UpdateFlags and palette that the
+  rows use, and hands them to the workers. The emulator carries on while
+  they're being drawn, and only waits for them (in WaitRows) when it next
+  needs the host display or HD.UpdateFlags - at the start of the next frame,
+  or when the host wants to read the display buffer.
+
+  Between StartRows and WaitRows the workers own the display area of the
+  queued host rows and their HD.UpdateFlags entries. The borders are still
+  drawn by the emulator thread, which doesn't touch anything else the workers
+  use until WaitRows (HD.XOffset & the host rows only change with the mode).
+
+*/
+
+#ifdef SDD_Threads
+static void SDD_Name(ThreadRows)(void *arg,int first,int count)
+{
+  ARMul_State *state = (ARMul_State *) arg;
+  const struct SDD_Name(RowSource) *src = &HD.Threads.Src;
+  while(count--)
+  {
+    uint32_t Vptr = HD.Threads.Rows[first].Vptr;
+    if(HD.Threads.NoFlags)
+      SDD_Name(DisplayAreaNoFlags)(state,src,&Vptr,HD.Threads.Rows[first].HostStart,HD.Threads.Rows[first].HostEnd);
+    else
+      SDD_Name(DisplayArea)(state,src,&Vptr,HD.Threads.Rows[first].Row,HD.Threads.Rows[first].HostStart,HD.Threads.Rows[first].HostEnd,HD.Threads.Rows[first].Flags);
+    first++;
+  }
+}
+
+static void SDD_Name(StartRows)(ARMul_State *state)
+{
+  struct SDD_Name(RowSource) *src = &HD.Threads.Src;
+  uint32_t lo, hi;
+  if(!HD.Threads.Count)
+    return;
+  if(HD.Threads.Hi > (512*1024)*8)
+  {
+    /* The rows run off the end of the low 512K, which isn't worth copying
+       for. Just draw them from the live state */
+    SDD_Name(ThreadRows)(state,0,HD.Threads.Count);
+    return;
+  }
+  /* Copy the words the rows read, plus the one after (the by-hand loops
+     can load it without using it) */
+  lo = HD.Threads.Lo>>5;
+  hi = (HD.Threads.Hi+31)>>5;
+  memcpy(HD.Threads.RAM+lo,MEMC.PhysRam+lo,(hi-lo+1)*sizeof(ARMword));
+  if(!HD.Threads.NoFlags)
+  {
+    lo = HD.Threads.Lo/(8*UPDATEBLOCKSIZE);
+    hi = (HD.Threads.Hi+(8*UPDATEBLOCKSIZE)-1)/(8*UPDATEBLOCKSIZE);
+    memcpy(HD.Threads.UpdateFlags+lo,MEMC.UpdateFlags+lo,(hi-lo)*sizeof(uint32_t));
+  }
+  memcpy(HD.Threads.Palette,HD.Palette,sizeof(HD.Palette));
+  src->RAM = HD.Threads.RAM;
+  src->UpdateFlags = HD.Threads.UpdateFlags;
+  src->Palette = HD.Threads.Palette;
+
+  /* Aim for a few batches per thread, so they finish at about the same time */
+  DisplayThreads_Start(HD.Threads.Pool,SDD_Name(ThreadRows),state,HD.Threads.Count,(HD.Threads.Count+HD.Threads.NumThreads*4-1)/(HD.Threads.NumThreads*4));
+  HD.Threads.Busy = true;
+  DisplayDev_ThreadFrames++;
+}
+#endif
+
+/* Wait for any rows that are being drawn by the worker threads. Hosts must
+   call this before reading the display buffer anywhere other than from
+   Host_PollDisplay */
+static inline void SDD_Name(WaitRows)(ARMul_State *state)
+{
+#ifdef SDD_Threads
+  if(HD.Threads.Busy)
+  {
+    if(DisplayThreads_Wait(HD.Threads.Pool))
+      DisplayDev_ThreadWaits++;
+    HD.Threads.Busy = false;
+  }
+#else
+  UNUSED_VAR(state);
+#endif
 }
 
 /*
 
   EventQ funcs
 
+  Normally a RowStart event fires every SDD_RowsAtOnce rows. But most frames
+  don't touch the VIDC/DAG registers while the display is being drawn, so
+  (unless there have been RasterWrites recently) FrameStart leaves all the
+  rows up to VSync for a single RowStart event. If a register does change
+  mid-frame, RasterWrite draws the rows the beam has passed before the new
+  value takes effect, and goes back to row by row updates.
+
+  If there are worker threads, the display rows of a whole frame are queued
+  for them instead of being drawn by RowStart, and FrameStart waits for them.
+
 */
 
+#define RASTER_HOLDOFF 50 /* Frames to draw row by row after a mid-frame register write, before trying WholeFrame again */
+
 static void SDD_Name(FrameEnd)(ARMul_State *state,CycleCount nowtime); /* Trigger vsync interrupt */
 static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime); /* End of vsync, prepare for new frame */
 static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime); /* Fill in a display/border row */
@@ -1870,7 +2226,7 @@ static void SDD_Name(Flyback)(ARMul_State *state)
     };
   
     const uint_fast16_t NewCR = VIDC.ControlReg;
-    const uint32_t ClockIn = 2*DisplayDev_GetVIDCClockIn();
+    const uint32_t ClockIn = 2*DisplayDev_GetVIDCClockIn(state);
     const uint_fast8_t ClockDivider = ClockDividers[NewCR&3]; 
   
     /* Calculate new line rate */
@@ -1914,9 +2270,27 @@ static void SDD_Name(SkipFrame)(ARMul_State *state,CycleCount nowtime)
 {
   /* Work out which scanline VSync is due on */
   int vsync = MAX(VIDC.Vert_DisplayStart,VIDC.Vert_DisplayEnd);
+  DisplayDev_FramesSkipped++;
   SDD_Name(Reschedule)(state,nowtime,SDD_Name(DisplayEnd),vsync+1,false);
 }
 
+static int SDD_Name(FirstRow)(ARMul_State *state)
+{
+  /* Work out which row the first RowStart event of the frame should draw up to */
+  int vsync = MAX(VIDC.Vert_DisplayStart,VIDC.Vert_DisplayEnd);
+  if(DC.RasterHoldoff || !DC.DMAEn || (vsync >= VIDC.Vert_Cycle))
+  {
+    /* Row by row. Without DMA, VSync is triggered by the first row below the
+       display start, so that case is left alone */
+    if(DC.RasterHoldoff)
+      DC.RasterHoldoff--;
+    return VIDC.Vert_BorderStart+1;
+  }
+  VIDEO_STAT(WholeFrames,1,1);
+  DC.WholeFrame = true;
+  return vsync+1;
+}
+
 static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
 {
   bool newDMAEn;
@@ -1931,15 +2305,20 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
   };
 
   const uint_fast16_t NewCR = VIDC.ControlReg;
-  const uint32_t ClockIn = 2*DisplayDev_GetVIDCClockIn();
+  const uint32_t ClockIn = 2*DisplayDev_GetVIDCClockIn(state);
   const uint_fast8_t ClockDivider = ClockDividers[NewCR&3];
 
+  /* The last frame's rows must be finished before the host sees it, or
+     anything about the mode changes */
+  SDD_Name(WaitRows)(state);
+
   /* Calculate new line rate */
   DC.LineRate = (uint32_t) ((((uint64_t) ARMul_EmuRate)*(VIDC.Horiz_Cycle*2+2))*ClockDivider/ClockIn);
   if(DC.LineRate < 100)
     DC.LineRate = 100; /* Clamp to safe minimum value */
 
   DC.FLYBK = false;
+  DC.WholeFrame = false;
 
   if(DisplayDev_UseUpdateFlags)
   {
@@ -2056,7 +2435,7 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
           /* Disable */
           DisplayDev_UseUpdateFlags = 0;
           DisplayDev_FrameSkip = DC.Auto_FrameCount/DC.Auto_ForceRefresh;
-          ARMul_RebuildFastMap(state);
+          ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
         }
         DC.Auto_FrameCount = 0;
         DC.Auto_ForceRefresh = 0;
@@ -2073,7 +2452,7 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
           /* Enable */        
           DisplayDev_UseUpdateFlags = 1;
           DisplayDev_FrameSkip = 0;
-          ARMul_RebuildFastMap(state);
+          ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
           /* Ensure the updateflags get reset */
           DC.ForceRefresh = true;
           DC.FrameSkip = 0;
@@ -2094,8 +2473,8 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
 
   if(DisplayDev_UseUpdateFlags)
   {
-    /* Schedule for first border row */
-    SDD_Name(Reschedule)(state,nowtime,SDD_Name(RowStart),VIDC.Vert_BorderStart+1,false);
+    /* Schedule for first border row, or VSync */
+    SDD_Name(Reschedule)(state,nowtime,SDD_Name(RowStart),SDD_Name(FirstRow)(state),false);
   }
   else
   {
@@ -2106,8 +2485,8 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
       DC.FrameSkip = DisplayDev_FrameSkip;
       HD.RefreshFlags[0] = 0;
 
-      /* Schedule for first border row */
-      SDD_Name(Reschedule)(state,nowtime,SDD_Name(RowStart),VIDC.Vert_BorderStart+1,false);
+      /* Schedule for first border row, or VSync */
+      SDD_Name(Reschedule)(state,nowtime,SDD_Name(RowStart),SDD_Name(FirstRow)(state),false);
     }
     else
     {
@@ -2116,6 +2495,7 @@ static void SDD_Name(FrameStart)(ARMul_State *state,CycleCount nowtime)
       return;
     }
   }      
+  DisplayDev_FramesRendered++;
   
   /* Update host */
   SDD_Name(Host_PollDisplay)(state);
@@ -2134,12 +2514,11 @@ static void SDD_Name(FrameEnd)(ARMul_State *state,CycleCount nowtime)
   EventQ_Reschedule(state,nowtime+DC.NextRow*DC.LineRate,SDD_Name(FrameStart),EventQ_Find2(state,SDD_Name(FrameEnd)));
 }
 
-static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime)
+static int SDD_Name(DrawRows)(ARMul_State *state,int stop,bool *flybk)
 {
-  int nextrow;
-  int stop = DC.NextRow;
+  /* Draw the rows from DC.LastRow up to stop. Returns the row it got to,
+     which is less than stop if the end of the screen was reached */
   bool dmaen = DC.DMAEn;
-  bool flybk = false;
   int row = DC.LastRow;
   if(row < VIDC.Vert_BorderStart+1)
     row = VIDC.Vert_BorderStart+1; /* Skip pre-border rows */
@@ -2171,7 +2550,7 @@ static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime)
     else if(row < (VIDC.Vert_BorderEnd+1))
     {
       /* Border again */
-      flybk = true;
+      *flybk = true;
       if (DC.ModeSupported)
       {
         SDD_Name(BorderRow)(state,row);
@@ -2180,12 +2559,46 @@ static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime)
     else
     {
       /* Reached end of screen */
-      SDD_Name(Reschedule)(state,nowtime,SDD_Name(FrameEnd),VIDC.Vert_Cycle+1,flybk);
-      return;
+      break;
     }
     VIDEO_STAT(DisplayRows,1,1);
     row++;
   }
+  return row;
+}
+
+static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime)
+{
+  int nextrow;
+  int stop = DC.NextRow;
+  bool flybk = false;
+  int row;
+#ifdef SDD_Threads
+  HD.Threads.Queue = (DC.WholeFrame && HD.Threads.Pool);
+  if(HD.Threads.Queue)
+  {
+    HD.Threads.Count = 0;
+    HD.Threads.Lo = UINT32_MAX;
+    HD.Threads.Hi = 0;
+    HD.Threads.NoFlags = !DisplayDev_UseUpdateFlags;
+    SDD_Name(GetRowSource)(state,&HD.Threads.Src);
+  }
+#endif
+  DC.WholeFrame = false;
+  row = SDD_Name(DrawRows)(state,stop,&flybk);
+#ifdef SDD_Threads
+  if(HD.Threads.Queue)
+  {
+    HD.Threads.Queue = false;
+    SDD_Name(StartRows)(state);
+  }
+#endif
+  if(row < stop)
+  {
+    /* Reached end of screen */
+    SDD_Name(Reschedule)(state,nowtime,SDD_Name(FrameEnd),VIDC.Vert_Cycle+1,flybk);
+    return;
+  }
   /* If we've just drawn the last display row, it's time for a vsync */
   if((stop >= (VIDC.Vert_DisplayStart+1)) && (stop >= (VIDC.Vert_DisplayEnd+1)))
   {
@@ -2198,6 +2611,47 @@ static void SDD_Name(RowStart)(ARMul_State *state,CycleCount nowtime)
   SDD_Name(Reschedule)(state,nowtime,SDD_Name(RowStart),nextrow,flybk);
 }
 
+static void SDD_Name(RasterWrite)(ARMul_State *state)
+{
+  /* A register which affects the rows is about to change. If the frame is
+     being left for one RowStart event, draw the rows the beam has already
+     passed with the old value, and go back to drawing row by row */
+  int idx, row, stop;
+  CycleDiff left;
+  bool flybk = false;
+  if(DC.FLYBK)
+    return; /* VSync has happened, the frame is already drawn up to here */
+  DC.RasterHoldoff = RASTER_HOLDOFF;
+  if(!DC.WholeFrame)
+    return;
+  DC.WholeFrame = false;
+  VIDEO_STAT(RasterCatchUps,1,1);
+  idx = EventQ_Find(state,SDD_Name(RowStart));
+  if(idx < 0)
+    return;
+  /* The event is due when the beam reaches DC.NextRow */
+  stop = DC.NextRow;
+  row = stop;
+  left = (CycleDiff) (state->EventQ[idx].Time-ARMul_Time);
+  if(left > 0)
+    row -= (int) ((left+(CycleDiff) DC.LineRate-1)/(CycleDiff) DC.LineRate);
+  if(row > DC.LastRow)
+  {
+    DC.LastRow = SDD_Name(DrawRows)(state,row,&flybk);
+    if(flybk)
+      SDD_Name(Flyback)(state);
+  }
+  if(row < DC.LastRow)
+    row = DC.LastRow;
+  /* Bring the event forward to the next row */
+  row += SDD_RowsAtOnce;
+  if(row < stop)
+  {
+    DC.NextRow = row;
+    EventQ_Reschedule(state,state->EventQ[idx].Time-((CycleCount) (stop-row))*DC.LineRate,SDD_Name(RowStart),idx);
+  }
+}
+
 /*
 
   VIDC/IOEB write handler
@@ -2221,6 +2675,7 @@ static void SDD_Name(VIDCPutVal)(ARMul_State *state,ARMword address, ARMword dat
     Phy = (val & 0x1fff);
     if(VIDC.Palette[Log] != Phy)
     {
+      SDD_Name(RasterWrite)(state);
       VIDC.Palette[Log] = Phy;
       if(!(DC.DirtyPalette & (1<<Log)))
       {
@@ -2243,6 +2698,7 @@ static void SDD_Name(VIDCPutVal)(ARMul_State *state,ARMword address, ARMword dat
       val &= 0x1fff;
       if(VIDC.BorderCol != val)
       {
+        SDD_Name(RasterWrite)(state);
         VIDC.BorderCol = val;
         HD.BorderCol = SDD_Name(Host_GetColour)(state,val);
       }
@@ -2318,6 +2774,8 @@ static void SDD_Name(VIDCPutVal)(ARMul_State *state,ARMword address, ARMword dat
 
     case 0xa0:
       dbug_vidc("VIDC Vert cycle register val=%"PRId32"\n",val>>14);
+      if(VIDC.Vert_Cycle != ((val>>14) & 0x3ff))
+        SDD_Name(RasterWrite)(state);
       VideoRelUpdateAndForce(DC.ModeChanged,VIDC.Vert_Cycle,(val>>14) & 0x3ff);
       break;
 
@@ -2328,21 +2786,29 @@ static void SDD_Name(VIDCPutVal)(ARMul_State *state,ARMword address, ARMword dat
 
     case 0xa8:
       dbug_vidc("VIDC Vert border start register val=%"PRId32"\n",val>>14);
+      if(VIDC.Vert_BorderStart != ((val>>14) & 0x3ff))
+        SDD_Name(RasterWrite)(state);
       VideoRelUpdateAndForce(DC.ModeChanged,VIDC.Vert_BorderStart,((val>>14) & 0x3ff));
       break;
 
     case 0xac:
       dbug_vidc("VIDC Vert display start register val=%"PRId32"\n",val>>14);
+      if(VIDC.Vert_DisplayStart != ((val>>14) & 0x3ff))
+        SDD_Name(RasterWrite)(state);
       VideoRelUpdateAndForce(DC.ModeChanged,VIDC.Vert_DisplayStart,((val>>14) & 0x3ff));
       break;
 
     case 0xb0:
       dbug_vidc("VIDC Vert display end register val=%"PRId32"\n",val>>14);
+      if(VIDC.Vert_DisplayEnd != ((val>>14) & 0x3ff))
+        SDD_Name(RasterWrite)(state);
       VideoRelUpdateAndForce(DC.ModeChanged,VIDC.Vert_DisplayEnd,(val>>14) & 0x3ff);
       break;
 
     case 0xb4:
       dbug_vidc("VIDC Vert border end register val=%"PRId32"\n",val>>14);
+      if(VIDC.Vert_BorderEnd != ((val>>14) & 0x3ff))
+        SDD_Name(RasterWrite)(state);
       VideoRelUpdateAndForce(DC.ModeChanged,VIDC.Vert_BorderEnd,((val>>14) & 0x3ff));
       break;
 
@@ -2418,6 +2884,23 @@ static bool SDD_Name(Init)(ARMul_State *state,const struct Vidc_Regs *Vidc)
   memset(HOSTDISPLAY.RefreshFlags,0xff,sizeof(HOSTDISPLAY.RefreshFlags));
   memset(HOSTDISPLAY.UpdateFlags,0,sizeof(HOSTDISPLAY.UpdateFlags)); /* Initial value in MEMC.UpdateFlags is 1 */   
 
+#ifdef SDD_Threads
+  if(CONFIG.iDisplayThreads > 0)
+  {
+    HD.Threads.RAM = (ARMword *) calloc((512*1024)/4+1,sizeof(ARMword));
+    if(HD.Threads.RAM)
+      HD.Threads.Pool = DisplayThreads_Create(CONFIG.iDisplayThreads);
+    if(HD.Threads.Pool)
+      HD.Threads.NumThreads = CONFIG.iDisplayThreads;
+    else
+    {
+      warn_vidc("Failed to start display threads, drawing rows on the emulator thread\n");
+      free(HD.Threads.RAM);
+      HD.Threads.RAM = NULL;
+    }
+  }
+#endif
+
   /* Schedule first update event */
   EventQ_Insert(state,ARMul_Time+100,SDD_Name(FrameStart));
 
@@ -2439,6 +2922,13 @@ static void SDD_Name(Shutdown)(ARMul_State *state)
   {
     ControlPane_Error(true,"Couldn't find SDD event func!");
   }
+#ifdef SDD_Threads
+  DisplayThreads_Destroy(HD.Threads.Pool);
+  free(HD.Threads.RAM);
+#endif
+#ifdef SDD_HostData
+  SDD_Name(Host_Shutdown)(state);
+#endif
   free(state->Display);
   state->Display = NULL;
 }
@@ -2452,6 +2942,7 @@ static void SDD_Name(DAGWrite)(ARMul_State *state,uint_fast8_t reg,uint_fast16_t
   {
   case 1: /* Vstart */
   case 2: /* Vend */
+    SDD_Name(RasterWrite)(state);
     memset(HD.RefreshFlags,0xff,sizeof(HD.RefreshFlags));
     break;
   }
@@ -2475,4 +2966,7 @@ const DisplayDev SDD_DisplayDev = {
 #undef ROWFUNC_FORCE
 #undef ROWFUNC_UPDATEFLAGS
 #undef ROWFUNC_UPDATED
+#undef RASTER_HOLDOFF
+#undef SDD_ROWBLOCKS
+#undef SDD_Threads
 
@@ -71,7 +71,8 @@ bool ARMul_CoProInit(ARMul_State *state) {
     for (i = 0; i < 16; i++) {
       /* Call all the initialisation routines */
      if (state->CoPro[i]->CPInit) {
-       (state->CoPro[i]->CPInit)(state);
+       if (!(state->CoPro[i]->CPInit)(state))
+         return false;
      }
    }
    return true;
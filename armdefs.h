@@ -19,18 +19,72 @@
 #ifndef ARMDEFS_HEADER
 #define ARMDEFS_HEADER
 
+#include <stdlib.h>
+#include <time.h>
+
 #include "c99.h"
 
 /* Control caching of instruction handler functions */
 #define ARMUL_INSTR_FUNC_CACHE
 
+/* Make the instruction handler cache hold 16bit indices into a table of
+   handlers, instead of full function pointers. Requires
+   ARMUL_INSTR_FUNC_CACHE */
+#define ARMUL_INSTR_FUNC_INDEX
+
+/* Store the FastMap access funcs as 8bit indices in a separate array, so
+   each FastMap entry is a single word and the hot part of the table is half
+   the size */
+#define ARMUL_FASTMAP_FUNC_INDEX
+
+/* Keep a small direct-mapped TLB of recently used data pages, so that
+   loads/stores which keep hitting the same pages can skip the FastMap
+   lookup and access checks */
+#define ARMUL_DATA_TLB
+
+/* Track which physical pages contain decoded instructions, so that stores to
+   pages which have never been executed can skip clobbering the instruction
+   func cache. Requires ARMUL_INSTR_FUNC_CACHE */
+#define ARMUL_CODE_PAGES
+
+/* Count how many stores hit pages with and without code, and report the
+   totals via dbug when the memory is freed. This puts a counter update back
+   on every store, so it's only for profiling. Requires ARMUL_CODE_PAGES */
+/* #define ARMUL_CODE_PAGE_STATS */
+
+/* Cache straight-line runs of decoded instructions as basic blocks, so the
+   main loop can skip the FastMap lookup for each sequential fetch. Requires
+   ARMUL_INSTR_FUNC_CACHE */
+#define ARMUL_BLOCK_CACHE
+
+/* Run blocks with threaded code, where each handler is a label inside one
+   big function and jumps straight to the next instruction's handler with
+   GCC's computed goto, instead of being called through a function pointer.
+   Compilers without labels as values (e.g. MSVC) keep using the handler
+   functions. Requires ARMUL_BLOCK_CACHE and ARMUL_INSTR_FUNC_INDEX */
+#if defined(__GNUC__) && !defined(PROFILE_ENABLED)
+#define ARMUL_COMPUTED_GOTO
+#endif
+
+/* Spot blocks which are idle loops (e.g. polling a memory location which
+   only an IRQ handler will change) and skip straight to the next event.
+   Requires ARMUL_BLOCK_CACHE */
+#define ARMUL_IDLE_DETECT
+
+/* Only check the EventQ and the IRQ/FIQ state once the cycle count reaches
+   state->Deadline, instead of before every instruction */
+#define ARMUL_EVENT_DEADLINE
+
+/* Defer calculating the NZCV flags for ADDS/SUBS/CMP/CMN until something
+   needs to look at them */
+#define ARMUL_LAZY_FLAGS
+
 /* Support coprocessors for ARM3 cache control */
 #define ARMUL_COPRO_SUPPORT
 
 typedef uint32_t ARMword; /* must be 32 bits wide */
 
 typedef struct ARMul_State ARMul_State;
-extern ARMul_State statestr;
 
 typedef void (*ARMEmuFunc)(ARMul_State *state, ARMword instr);
 
@@ -94,6 +148,8 @@ typedef enum ARMBank {
    The first word contains the access flags and memory pointer
    The second word contains the read/write func pointer (combined function
    under the assumption that MMIO read/write will be infrequent) 
+   With ARMUL_FASTMAP_FUNC_INDEX the func pointer is instead kept as a byte
+   in state->FastMapFuncs, leaving just the first word in the FastMap itself
 */
 
 #ifndef FASTMAP_64
@@ -132,17 +188,133 @@ typedef uintptr_t FastMapUInt;
 #define FASTMAP_ACCESSFUNC_STATECHANGE 0x04UL /* Only relevant for writes */
 
 #ifdef ARMUL_INSTR_FUNC_CACHE
+#ifdef ARMUL_INSTR_FUNC_INDEX
+typedef uint16_t ARMEmuFuncSlot; /* Index into the handler table, see armemu.c */
+#else
+typedef ARMEmuFunc ARMEmuFuncSlot;
+#endif
 #define FASTMAP_CLOBBEREDFUNC 0 /* Value written when a func gets clobbered */
 #endif
 
+#if defined(ARMUL_INSTR_FUNC_INDEX) && !defined(ARMUL_INSTR_FUNC_CACHE)
+#error "ARMUL_INSTR_FUNC_INDEX requires ARMUL_INSTR_FUNC_CACHE"
+#endif
+
+#if defined(ARMUL_CODE_PAGES) && !defined(ARMUL_INSTR_FUNC_CACHE)
+#error "ARMUL_CODE_PAGES requires ARMUL_INSTR_FUNC_CACHE"
+#endif
+
+#if defined(ARMUL_CODE_PAGE_STATS) && !defined(ARMUL_CODE_PAGES)
+#error "ARMUL_CODE_PAGE_STATS requires ARMUL_CODE_PAGES"
+#endif
+
+#if defined(ARMUL_BLOCK_CACHE) && !defined(ARMUL_INSTR_FUNC_CACHE)
+#error "ARMUL_BLOCK_CACHE requires ARMUL_INSTR_FUNC_CACHE"
+#endif
+
+#if defined(ARMUL_COMPUTED_GOTO) && (!defined(ARMUL_BLOCK_CACHE) || !defined(ARMUL_INSTR_FUNC_INDEX))
+#error "ARMUL_COMPUTED_GOTO requires ARMUL_BLOCK_CACHE and ARMUL_INSTR_FUNC_INDEX"
+#endif
+
+#if defined(ARMUL_IDLE_DETECT) && !defined(ARMUL_BLOCK_CACHE)
+#error "ARMUL_IDLE_DETECT requires ARMUL_BLOCK_CACHE"
+#endif
+
 typedef FastMapInt FastMapRes; /* Result of a DecodeRead/DecodeWrite function */
 
 typedef ARMword (*FastMapAccessFunc)(ARMul_State *state,ARMword addr,ARMword data,ARMword flags);
 
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+typedef struct {
+  FastMapUInt FlagsAndData;
+} FastMapEntry;
+
+typedef uint8_t FastMapFuncIndex; /* Index into FastMap_AccessFuncs */
+
+/* All the access funcs used by the FastMap, see arch/armarc.c */
+extern const FastMapAccessFunc FastMap_AccessFuncs[];
+#else
 typedef struct {
   FastMapUInt FlagsAndData;
   FastMapAccessFunc AccessFunc;
 } FastMapEntry;
+#endif
+
+#ifdef ARMUL_DATA_TLB
+#define DATATLB_SIZE 64 /* Must be a power of two */
+
+/* Tags are the page number plus state->FastMapGen, which is stepped by
+   DATATLB_GEN_STEP whenever the FastMap or the access mode changes. So any
+   change to the map invalidates every entry at once. A tag of 0 never
+   matches */
+#define DATATLB_GEN_STEP (FASTMAP_SIZE)
+
+typedef struct {
+  ARMword ReadTag;           /* Tag if the page is directly readable, else 0 */
+  ARMword WriteTag;          /* Tag if the page is directly writeable, else 0 */
+  FastMapUInt Offset;        /* Logical address -> host pointer offset, as for FastMap_Log2Phy */
+} DataTLBEntry;
+#endif
+
+/***************************************************************************\
+*                               Code pages                                  *
+\***************************************************************************/
+
+#ifdef ARMUL_CODE_PAGES
+/* One entry per 4K of the RAM/ROM chunk. HasCode is set when any word in the
+   page gets a handler cached for it, and is never cleared.
+
+   Stores to pages without HasCode set never touch the func cache. */
+
+#define CODEPAGE_SHIFT 12
+
+typedef struct {
+  bool HasCode;              /* Whether any word in this page has been decoded */
+} CodePage;
+#endif
+
+#ifdef ARMUL_CODE_PAGE_STATS
+typedef struct {
+  uint64_t DataStores;       /* Words stored to pages without code, skipped */
+  uint64_t CodeStores;       /* Words stored to pages with code */
+  uint64_t CodeWrites;       /* Words stored over a cached handler */
+} CodePageStats;
+#endif
+
+/***************************************************************************\
+*                           Basic block cache                               *
+\***************************************************************************/
+
+#ifdef ARMUL_BLOCK_CACHE
+/* A basic block is a copy of up to BLOCK_MAXLEN sequential instructions,
+   along with their decoded handlers. Blocks never cross a 4K page, and are
+   indexed by the physical (host) address of their first instruction.
+
+   Any write to a word which has a cached handler goes via
+   FastMap_PhyClobberFunc, which also discards any blocks that cover that word.
+   Since every word in a block is guaranteed to have a cached handler, stores
+   to plain data are unaffected. */
+
+#define BLOCK_MAXLEN 16
+#define BLOCKCACHE_SIZE 2048 /* Must be power of 2 */
+
+typedef struct {
+  ARMword instr;
+#ifdef ARMUL_COMPUTED_GOTO
+  ARMEmuFuncSlot slot;       /* Picks the handler label, see ARMul_ThreadBlock */
+#endif
+  ARMEmuFunc func;
+} BlockOp;
+
+typedef struct {
+  const ARMword *Phys;       /* Physical address of first instruction, NULL if block is free */
+  uint_fast8_t Len;          /* Number of valid entries in Ops */
+#ifdef ARMUL_IDLE_DETECT
+  bool IdleLoop;             /* Block is a loop which can't exit until memory is changed */
+#endif
+  BlockOp Ops[BLOCK_MAXLEN];
+} BasicBlock;
+#endif
 
 /***************************************************************************\
 *                               Event queue                                 *
@@ -188,7 +360,9 @@ typedef struct {
           arch/keyboard.c - One entry for keyboard/mouse polling
           arch/archio.c - One entry for IOC timers
           arch/archio.c - One entry for FDC & HDC updates
-        = 5 total
+          arch/bench.c - One entry for benchmark timing (optional)
+          arcem.c - One entry for the Arcem_Run cycle limit (optional)
+        = 7 total
 */
 
 /***************************************************************************\
@@ -206,18 +380,35 @@ typedef struct arch_keyboard arch_keyboard;
 typedef struct Vidc_Regs Vidc_Regs;
 typedef struct ArcemConfig_s ArcemConfig;
 typedef struct ARMul_CoPro ARMul_CoPro;
+typedef struct DisplayDev DisplayDev;
 
 #define Exception_IRQ (UINT32_C(1) << 27)
 #define Exception_FIQ (UINT32_C(1) << 26)
+#define Exception_Exit (UINT32_C(1) << 0) /* Not a real pin; returned by the event check so the main loop notices ARMul_Exit/ARMul_Stop */
+
+/* Reasons for ARMul_DoProg to return, see ARMul_Stop */
+#define ARMul_Stop_Exit   1 /* ARMul_Exit was called */
+#define ARMul_Stop_Cycles 2 /* A cycle limit was reached */
+#define ARMul_Stop_VSync  4 /* A frame ended, if enabled in StopMask */
 
 struct ARMul_State {
    /* Most common stuff, current register file first to ease indexing */
    ARMword Reg[16];           /* the current register file */
    CycleCount NumCycles;      /* Number of cycles */
+   uint64_t NumInstrs;        /* Number of instructions executed (including those which failed their condition code) */
+#ifdef ARMUL_EVENT_DEADLINE
+   CycleCount Deadline;       /* Cycle count at which the EventQ and Exception must next be checked */
+#endif
    ARMStartIns NextInstr;     /* Pipeline state */
+#ifdef ARMUL_LAZY_FLAGS
+   uint_least8_t FlagsOp;     /* Pending flag calculation, see armemu.h */
+   ARMword FlagsA, FlagsB, FlagsRes; /* Operands and result of the pending calculation */
+#endif
    ARMBank Bank;              /* the current register bank */
    uint_least8_t ExitCode;    /* return code used when terminating the emulator */
    bool KillEmulator;         /* global used to terminate the emulator */
+   uint_least8_t StopMask;    /* Which optional ARMul_Stop_ reasons are enabled */
+   uint_least8_t StopReason;  /* ARMul_Stop_ reasons for the last ARMul_DoProg return */
    bool OSmode;               /* MEMC USR/OS flag, somewhat redundant with FastMapMode */
    bool NtransSig;            /* MEMC USR/SVC flag, somewhat redundant with FastMapMode */
    bool abortSig;             /* Abort state */
@@ -232,25 +423,77 @@ struct ARMul_State {
    /* Fastmap stuff */
    FastMapUInt FastMapMode;   /* Current access mode flags */
 #ifdef ARMUL_INSTR_FUNC_CACHE
-   FastMapUInt FastMapInstrFuncOfs; /* Offset between the RAM/ROM data and the ARMEmuFunc data */
+   FastMapUInt FastMapInstrFuncOfs; /* Offset between the RAM/ROM data and the ARMEmuFuncSlot data */
 #endif
    FastMapEntry *FastMap;
+#ifdef ARMUL_FASTMAP_FUNC_INDEX
+   FastMapFuncIndex *FastMapFuncs; /* Access func index for each FastMap entry */
+#endif
+#ifdef ARMUL_DATA_TLB
+   ARMword FastMapGen;        /* Generation count for DataTLB tags */
+   DataTLBEntry DataTLB[DATATLB_SIZE];
+#endif
+
+#ifdef ARMUL_CODE_PAGES
+   CodePage *CodePages;       /* Per-page code flags for the RAM/ROM data */
+   FastMapUInt CodePageBase;  /* Address of the RAM/ROM data */
+#endif
+#ifdef ARMUL_CODE_PAGE_STATS
+   CodePageStats CodeStats;
+#endif
+
+#ifdef ARMUL_BLOCK_CACHE
+   /* Basic block cache */
+   BasicBlock *BlockCache;
+   BasicBlock *BlockCur;      /* Block currently being executed, NULL if block execution must stop */
+#endif
+#ifdef ARMUL_IDLE_DETECT
+   bool IdleDetect;           /* Whether idle loops get skipped */
+#endif
 
    /* Event queue */
    EventQ_Entry EventQ[EVENTQ_SIZE];
    uint_least8_t NumEvents;
 
    /* Enabled CPU features */
-   bool HasSWP, HasCP15;
+   bool HasCP15;
+   ARMEmuFunc (*EmuDecode)(ARMword instr); /* Decoder for the processor model, see ARMul_EmulateSetModel */
+#ifdef ARMUL_INSTR_FUNC_INDEX
+   const ARMEmuFuncSlot *EmuFuncKeys;      /* Decode key -> handler slot table for the processor model */
+#endif
 
    /* Less common stuff */   
    ARMword instr, pc;         /* saved register state */
    ARMword loaded, decoded;   /* saved pipeline state */
    ARMword RegBank[4][16];    /* all the registers */
+   uint64_t EventDispatches;  /* Number of EventQ callbacks run */
+
+   /* Emulated hardware. Each machine has its own copy, so several machines
+      can be run at once (on different threads) */
+   struct MEMCStruct *Memc;   /* MEMC regs & memory, see arch/armarc.h */
+   struct IOCStruct *Ioc;     /* IOC regs, see arch/archio.h */
+   struct FDCStruct *Fdc;     /* Floppy controller, private to arch/fdc1772.c */
+   struct HDCStruct *Hdc;     /* Hard disc controller, private to arch/hdc63463.c */
+   struct I2CStruct *I2c;     /* CMOS RAM, private to arch/i2c.c */
+   struct SoundStruct *Sound; /* Sound DMA & mixer, private to arch/newsound.c */
+   struct BenchStruct *Bench; /* Benchmark counters, private to arch/bench.c */
+
+   /* Display device settings, see arch/displaydev.h */
+   const DisplayDev *DisplayDevice;
+   bool DisplayUseUpdateFlags, DisplayAutoUpdateFlags;
+   int DisplayFrameSkip;
+   uint64_t DisplayFramesRendered, DisplayFramesSkipped;
+   uint64_t DisplayThreadFrames, DisplayThreadWaits;
+
+   /* EmuRate, see EmuRate_Update() */
+   uint32_t EmuRate;
+   CycleCount EmuRateLastCycle;
+   clock_t EmuRateLastTime;
 
 #ifdef ARMUL_COPRO_SUPPORT
    /* Rare stuff */
    const ARMul_CoPro *CoPro[16]; /* coprocessor interface */
+   struct CP15Struct *Cp15;   /* ARM3 cache control regs, private to arch/cp15.c */
 #endif
  };
 
@@ -259,18 +502,17 @@ extern void *state_alloc(int s);
 extern void state_free(void *p);
 #else
 /* If you need special allocation for the state rather than
- * using the usual static global, you can override these functions
- * and provide your own.
+ * using the usual heap, you can override these functions
+ * and provide your own. The state must be zero-initialised.
  */
 static inline void *state_alloc(int s)
 {
-	UNUSED_VAR(s);
-	return &statestr;
+	return calloc(1,s);
 }
 
 static inline void state_free(void *p)
 {
-	UNUSED_VAR(p);
+	free(p);
 }
 #endif
  
@@ -283,6 +525,7 @@ ARMul_State *ARMul_NewState(ArcemConfig *pConfig);
 void ARMul_FreeState(ARMul_State *state);
 void ARMul_Reset(ARMul_State *state);
 void ARMul_Exit(ARMul_State *state, uint_least8_t exit_code);
+void ARMul_Stop(ARMul_State *state, uint_least8_t reason);
 int ARMul_DoProg(ARMul_State *state);
 
 /***************************************************************************\
@@ -291,6 +534,18 @@ int ARMul_DoProg(ARMul_State *state);
 
 #define ARMul_Time (state->NumCycles)
 
+/* Anything which might cause an event or IRQ/FIQ to become due earlier than
+   the main loop expects (new events, changes to Exception or the R15 IF
+   bits) must call this. The block loops keep their own copy of the deadline,
+   so this also stops the current block */
+#if defined(ARMUL_EVENT_DEADLINE) && defined(ARMUL_BLOCK_CACHE)
+#define ARMul_ForceEventCheck(state) ((state)->Deadline = (state)->NumCycles, (state)->BlockCur = NULL)
+#elif defined(ARMUL_EVENT_DEADLINE)
+#define ARMul_ForceEventCheck(state) ((state)->Deadline = (state)->NumCycles)
+#else
+#define ARMul_ForceEventCheck(state) ((void) (state))
+#endif
+
 /***************************************************************************\
 *                          Useful support routines                          *
 \***************************************************************************/
@@ -321,12 +576,22 @@ extern void ARMul_Abort(ARMul_State *state, ARMword address);
 extern bool ARMul_MemoryInit(ARMul_State *state);
 extern void ARMul_MemoryExit(ARMul_State *state);
 
+#ifdef ARMUL_BLOCK_CACHE
+/* Discard any cached blocks which contain the given physical word */
+extern void ARMul_BlockCache_Clobber(ARMul_State *state,const ARMword *addr);
+#endif
+
 /***************************************************************************\
 *                               ARM Support                                 *
 \***************************************************************************/
 
 /* An estimate of how many cycles the host is executing per second */
-extern uint32_t ARMul_EmuRate;
+#define ARMul_EmuRate (state->EmuRate)
+
+/* CPU time used by the calling thread, in clock() units. Used for the EmuRate
+   calculations, since clock() counts the CPU time of every machine running in
+   the process */
+clock_t ARMul_HostClock(void);
 
 /* Reset the EmuRate code, to cope with situations where the emulator has just been resumed after being suspended for a period of time (i.e. > 1 second) */
 void EmuRate_Reset(ARMul_State *state);
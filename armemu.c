@@ -20,24 +20,69 @@
 #include "armdefs.h"
 #include "armemu.h"
 #include "armcopro.h"
+#include <string.h>
 #include <time.h>
 #include "prof.h"
 #include "arch/archio.h"
 #include "arch/fastmap.h"
 #include "arch/ControlPane.h"
 
-ARMul_State statestr;
-
+#ifdef ARMUL_BLOCK_CACHE
+typedef BlockOp PipelineEntry; /* Same layout, so blocks can be copied straight into the pipeline */
+#else
 typedef struct {
   ARMword instr;
 #ifdef ARMUL_INSTR_FUNC_CACHE
   ARMEmuFunc func;
 #endif
 } PipelineEntry;
+#endif
 
 static const PipelineEntry abortpipe;
 
-static ARMEmuFunc ARMul_Emulate_DecodeInstr(ARMword instr);
+/* Processor models with different instruction sets, each of which gets its
+   own decoder. ARM250 & ARM3 only differ by CP15, which is a coprocessor */
+#define EMUMODEL_ARM2   0 /* No SWP */
+#define EMUMODEL_ARM250 1
+#define EMUMODEL_COUNT  2
+
+static ARMEmuFunc ARMul_Emulate_DecodeARM2(ARMword instr);
+static ARMEmuFunc ARMul_Emulate_DecodeARM250(ARMword instr);
+
+static ARMEmuFunc (*const ARMul_EmuDecoders[EMUMODEL_COUNT])(ARMword instr) = {
+  ARMul_Emulate_DecodeARM2,
+  ARMul_Emulate_DecodeARM250,
+};
+
+#define ARMul_Emulate_DecodeInstr(state,instr) ((state)->EmuDecode(instr))
+
+#ifdef ARMUL_INSTR_FUNC_INDEX
+/* The decoder only looks at bits 20-27, bits 4-7, and whether Rd is the PC,
+   so those 13 bits are enough to pick the handler for any instruction */
+#define EMUFUNC_KEY(instr) ((((instr)>>15) & 0x1fe0) | (((instr)>>3) & 0x1e) | ((((instr)>>12) & 15) == 15))
+/* Construct an instruction which produces a key */
+#define EMUFUNC_KEY_INSTR(key) ((((key) & 0x1fe0) << 15) | (((key) & 0x1e) << 3) | (((key) & 1) ? 0xf000 : 0))
+#define EMUFUNC_KEYS 8192
+#define EMUFUNC_MAX 512 /* Max number of distinct handlers */
+
+/* Entry 0 is FASTMAP_CLOBBEREDFUNC, so never used for a real handler */
+static ARMEmuFunc ARMul_EmuFuncTable[EMUFUNC_MAX];
+static ARMEmuFuncSlot ARMul_EmuFuncKeyTable[EMUMODEL_COUNT][EMUFUNC_KEYS];
+
+#define ARMul_Emulate_DecodeSlot(state,instr) ((state)->EmuFuncKeys[EMUFUNC_KEY(instr)])
+#define ARMul_EmuFuncFromSlot(slot) (ARMul_EmuFuncTable[slot])
+
+#ifdef ARMUL_COMPUTED_GOTO
+/* Address of the label for each handler slot, inside ARMul_ThreadBlock */
+typedef const void *ARMul_EmuLabel;
+static ARMul_EmuLabel ARMul_EmuLabelTable[EMUFUNC_MAX];
+
+static int ARMul_ThreadBlock(ARMul_State *state,const BasicBlock *blk,const BlockOp *op,const BlockOp *last,ARMword r15,BlockOp *pipe);
+#endif
+#else
+#define ARMul_Emulate_DecodeSlot(state,instr) ARMul_Emulate_DecodeInstr(state,instr)
+#define ARMul_EmuFuncFromSlot(slot) (slot)
+#endif
 
 /***************************************************************************\
 *                   Load Instruction                                        *
@@ -60,23 +105,24 @@ ARMul_LoadInstr(ARMul_State *state,ARMword addr, PipelineEntry *p)
     ARMword *data = FastMap_Log2Phy(entry,addr);
     ARMword instr = *data;
 #ifdef ARMUL_INSTR_FUNC_CACHE
-    ARMEmuFunc *pfunc = FastMap_Phy2Func(state,data);
-    ARMEmuFunc temp = *pfunc;
+    ARMEmuFuncSlot *pfunc = FastMap_Phy2Func(state,data);
+    ARMEmuFuncSlot temp = *pfunc;
     if(temp == FASTMAP_CLOBBEREDFUNC)
     {
       /* Decode the instruction */
-      temp = *pfunc = ARMul_Emulate_DecodeInstr(instr);
+      temp = *pfunc = ARMul_Emulate_DecodeSlot(state,instr);
+      FastMap_PhyMarkCode(state,data);
     }
 #if 0
-    else if(temp != ARMul_Emulate_DecodeInstr(instr))
+    else if(ARMul_EmuFuncFromSlot(temp) != ARMul_Emulate_DecodeInstr(state,instr))
     {
       warn("LoadInstr: %08x maps to entry %08x res %08x (mode %08x pc %08x)\n",addr,entry,res,MEMC.FastMapMode,state->Reg[15]);
       warn("-> data %08x pfunc %08x instr %08x func %08x using ofs %08x\n",data,pfunc,instr,temp,MEMC.FastMapInstrFuncOfs);
-      warn("But should be %08x!\n",ARMul_Emulate_DecodeInstr(instr));
+      warn("But should be %08x!\n",ARMul_Emulate_DecodeInstr(state,instr));
       ControlPane_Error(true,"AMul_LoadInstr failure");
     }
 #endif
-    p->func = temp;
+    p->func = ARMul_EmuFuncFromSlot(temp);
 #endif
     p->instr = instr;
   }
@@ -86,7 +132,7 @@ ARMul_LoadInstr(ARMul_State *state,ARMword addr, PipelineEntry *p)
     ARMword instr = FastMap_LoadFunc(entry,state,addr);
     p->instr = instr;
 #ifdef ARMUL_INSTR_FUNC_CACHE
-    p->func = ARMul_Emulate_DecodeInstr(instr);
+    p->func = ARMul_Emulate_DecodeInstr(state,instr);
 #endif
   }
   else
@@ -122,20 +168,21 @@ ARMul_LoadInstrTriplet(ARMul_State *state,ARMword addr,PipelineEntry *p)
   {
     ARMword *data = FastMap_Log2Phy(entry,addr);
 #ifdef ARMUL_INSTR_FUNC_CACHE
-    ARMEmuFunc *pfunc = FastMap_Phy2Func(state,data);
+    ARMEmuFuncSlot *pfunc = FastMap_Phy2Func(state,data);
 #endif
     int i;
     for(i=0;i<3;i++)
     {
       ARMword instr = *data;
 #ifdef ARMUL_INSTR_FUNC_CACHE
-      ARMEmuFunc temp = *pfunc;
+      ARMEmuFuncSlot temp = *pfunc;
       if(temp == FASTMAP_CLOBBEREDFUNC)
       {
         /* Decode the instruction */
-        temp = *pfunc = ARMul_Emulate_DecodeInstr(instr);
+        temp = *pfunc = ARMul_Emulate_DecodeSlot(state,instr);
+        FastMap_PhyMarkCode(state,data);
       }
-      p->func = temp;
+      p->func = ARMul_EmuFuncFromSlot(temp);
       pfunc++;
 #endif
       p->instr = instr;
@@ -183,7 +230,7 @@ ARMul_Align(ARMword address, ARMword data)
 \***************************************************************************/
 
 static inline void
-ARMul_NegZero(ARMul_State *state, ARMword result)
+ARMul_CalcNegZero(ARMul_State *state, ARMword result)
 {
   ARMword flags = state->Reg[15] & ~(NBIT|ZBIT);
   if (NEG(result))
@@ -199,7 +246,7 @@ ARMul_NegZero(ARMul_State *state, ARMword result)
 \***************************************************************************/
 
 static inline void
-ARMul_AddFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
+ARMul_CalcAddFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
 {
   ARMword flags = state->Reg[15] & ~(NBIT|ZBIT|CBIT|VBIT);
   if (result == 0)
@@ -223,7 +270,7 @@ ARMul_AddFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
 \***************************************************************************/
 
 static inline void
-ARMul_SubFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
+ARMul_CalcSubFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
 {
   ARMword flags = state->Reg[15] & ~(CBIT|VBIT);
   if ((a >= b) || ((b | a) >> 31)) {
@@ -238,6 +285,60 @@ ARMul_SubFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
   state->Reg[15] = flags;
 }
 
+#ifdef ARMUL_LAZY_FLAGS
+/***************************************************************************\
+* Lazy flags. ADDS/SUBS/CMP/CMN just record their operands and result, and  *
+* the flags are only calculated once something needs them. A SUB is always  *
+* accompanied by an ARMul_NegZero of the same result, so a pending SUB      *
+* provides all four flags.                                                  *
+\***************************************************************************/
+
+void ARMul_FlushFlagsSlow(ARMul_State *state)
+{
+  if (state->FlagsOp == FLAGS_ADD) {
+    ARMul_CalcAddFlags(state,state->FlagsA,state->FlagsB,state->FlagsRes);
+  } else {
+    ARMul_CalcNegZero(state,state->FlagsRes);
+    ARMul_CalcSubFlags(state,state->FlagsA,state->FlagsB,state->FlagsRes);
+  }
+  state->FlagsOp = FLAGS_VALID;
+}
+
+static inline void
+ARMul_NegZero(ARMul_State *state, ARMword result)
+{
+  if (state->FlagsOp != FLAGS_VALID) {
+    /* A pending calculation with the same result already has the right N & Z */
+    if (state->FlagsRes == result)
+      return;
+    ARMul_FlushFlagsSlow(state);
+  }
+  ARMul_CalcNegZero(state,result);
+}
+
+static inline void
+ARMul_AddFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
+{
+  state->FlagsOp = FLAGS_ADD;
+  state->FlagsA = a;
+  state->FlagsB = b;
+  state->FlagsRes = result;
+}
+
+static inline void
+ARMul_SubFlags(ARMul_State *state, ARMword a, ARMword b, ARMword result)
+{
+  state->FlagsOp = FLAGS_SUB;
+  state->FlagsA = a;
+  state->FlagsB = b;
+  state->FlagsRes = result;
+}
+#else
+#define ARMul_NegZero ARMul_CalcNegZero
+#define ARMul_AddFlags ARMul_CalcAddFlags
+#define ARMul_SubFlags ARMul_CalcSubFlags
+#endif
+
 /***************************************************************************\
 * This routine evaluates most Data Processing register RHSs with the S     *
 * bit clear.  It is intended to be called from the macro DPRegRHS, which    *
@@ -520,6 +621,7 @@ static inline void WriteR15(ARMul_State *state, ARMword src)
 
 static inline void WriteSR15(ARMul_State *state, ARMword src)
 {
+ ARMul_DiscardFlags(state);
  if (state->Bank == USERBANK)
     state->Reg[15] = (src & (CCBITS | R15PCBITS)) | R15INTMODE;
  else
@@ -651,6 +753,56 @@ static bool StoreByte(ARMul_State *state, ARMword instr, ARMword address)
 }
 
 
+/***************************************************************************\
+* Helpers for the LDM/STM fast paths, used when the whole transfer lies     *
+* within one DIRECT FastMap page. ARMul_LSMFast returns the physical        *
+* address of the data, or NULL if the slow path must be used.               *
+\***************************************************************************/
+
+static inline ARMword *ARMul_LSMFast(ARMul_State *state,ARMword address,ARMword count,bool write)
+{
+  FastMapEntry *entry;
+  FastMapRes res;
+  if (!count || (((address & 0xffc) + (count << 2)) > 0x1000) || state->Aborted)
+    return NULL;
+  entry = FastMap_GetEntry(state,address);
+  res = (write ? FastMap_DecodeWrite(entry,state->FastMapMode) : FastMap_DecodeRead(entry,state->FastMapMode));
+  if (!FASTMAP_RESULT_DIRECT(res))
+    return NULL;
+  return FastMap_Log2Phy(entry,address&~3);
+}
+
+static inline void ARMul_LSMLoadRegs(ARMword *reg,const ARMword *data,ARMword mask,ARMword count)
+{
+  while (!(mask & 1)) {
+    mask >>= 1;
+    reg++;
+  }
+  if (!(mask & (mask+1))) {
+    /* Contiguous registers, e.g. for block copies */
+    memcpy(reg,data,count << 2);
+    return;
+  }
+  for (; mask; mask >>= 1, reg++)
+    if (mask & 1)
+      *reg = *(data++);
+}
+
+static inline void ARMul_LSMStoreRegs(const ARMword *reg,ARMword *data,ARMword mask,ARMword count)
+{
+  while (!(mask & 1)) {
+    mask >>= 1;
+    reg++;
+  }
+  if (!(mask & (mask+1))) {
+    memcpy(data,reg,count << 2);
+    return;
+  }
+  for (; mask; mask >>= 1, reg++)
+    if (mask & 1)
+      *(data++) = *reg;
+}
+
 /***************************************************************************\
 * This function does the work of loading the registers listed in an LDM     *
 * instruction, when the S bit is clear.  The code here is always increment  *
@@ -660,7 +812,7 @@ static bool StoreByte(ARMul_State *state, ARMword instr, ARMword address)
 
 static void LoadMult(ARMul_State *state, ARMword instr,
                      ARMword address, ARMword WBBase)
-{ARMword dest, temp, temp2;
+{ARMword dest, temp, temp2, count, *data;
 
  UNDEF_LSMNoRegs;
  UNDEF_LSMPCBase;
@@ -675,27 +827,16 @@ static void LoadMult(ARMul_State *state, ARMword instr,
  temp2 = state->Reg[15];
 
     /* Check if we can use the fastmap */
-    if((((uint32_t) (address<<20)) <= 0xfc000000) && !state->Aborted)
+    count = LSMNumRegs;
+    data = ARMul_LSMFast(state,address,count,false);
+    if(data)
     {
-       FastMapEntry *entry = FastMap_GetEntry(state,address);
-       FastMapRes res = FastMap_DecodeRead(entry,state->FastMapMode);
-       if(FASTMAP_RESULT_DIRECT(res))
-       {
-           ARMword *data, count;
-          /* Do it fast
-             This assumes we don't differentiate between N & S cycles */
-          ARMul_CLEARABORT;
-          data = FastMap_Log2Phy(entry,address&~3);
-          count=0;
-          for(temp=0;temp<16;temp++)
-            if(BIT(temp))
-            {
-              state->Reg[temp] = *(data++);
-              count++;
-            }
-          state->NumCycles += count;
-          goto done;
-       }
+       /* Do it fast
+          This assumes we don't differentiate between N & S cycles */
+       ARMul_CLEARABORT;
+       ARMul_LSMLoadRegs(state->Reg,data,BITS(0,15),count);
+       state->NumCycles += count;
+       goto done;
     }
 
     for (temp = 0; !BIT(temp); temp++); /* N cycle first */
@@ -744,7 +885,7 @@ done:
 
 static void LoadSMult(ARMul_State *state, ARMword instr,
                       ARMword address, ARMword WBBase)
-{ARMword dest, temp, temp2;
+{ARMword dest, temp, temp2, count, *data;
 
  UNDEF_LSMNoRegs;
  UNDEF_LSMPCBase;
@@ -766,27 +907,16 @@ static void LoadSMult(ARMul_State *state, ARMword instr,
     }
 
     /* Check if we can use the fastmap */
-    if((((uint32_t) (address<<20)) <= 0xfc000000) && !state->Aborted)
+    count = LSMNumRegs;
+    data = ARMul_LSMFast(state,address,count,false);
+    if(data)
     {
-       FastMapEntry *entry = FastMap_GetEntry(state,address);
-       FastMapRes res = FastMap_DecodeRead(entry,state->FastMapMode);
-       if(FASTMAP_RESULT_DIRECT(res))
-       {
-          ARMword *data, count;
-          /* Do it fast
-             This assumes we don't differentiate between N & S cycles */
-          ARMul_CLEARABORT;
-          data = FastMap_Log2Phy(entry,address&~3);
-          count=0;
-          for(temp=0;temp<16;temp++)
-            if(BIT(temp))
-            {
-              state->Reg[temp] = *(data++);
-              count++;
-            }
-          state->NumCycles += count;
-          goto done;
-       }
+       /* Do it fast
+          This assumes we don't differentiate between N & S cycles */
+       ARMul_CLEARABORT;
+       ARMul_LSMLoadRegs(state->Reg,data,BITS(0,15),count);
+       state->NumCycles += count;
+       goto done;
     }
 
     for (temp = 0; !BIT(temp); temp++); /* N cycle first */
@@ -843,7 +973,7 @@ done:
 static void StoreMult(ARMul_State *state, ARMword instr,
                       ARMword address, ARMword WBBase)
 {
-    ARMword temp;
+    ARMword temp, count, *data;
 
     UNDEF_LSMNoRegs;
     UNDEF_LSMPCBase;
@@ -856,44 +986,23 @@ static void StoreMult(ARMul_State *state, ARMword instr,
     for (temp = 0; !BIT(temp); temp++); /* N cycle first */
 
     /* Check if we can use the fastmap */
-    if((((uint32_t) (address<<20)) <= 0xfc000000) && !state->Aborted)
+    count = LSMNumRegs;
+    data = ARMul_LSMFast(state,address,count,true);
+    if(data)
     {
-        FastMapEntry *entry = FastMap_GetEntry(state,address);
-        FastMapRes res = FastMap_DecodeWrite(entry,state->FastMapMode);
-        if(FASTMAP_RESULT_DIRECT(res))
-        {
-            ARMword *data, count;
-#ifdef ARMUL_INSTR_FUNC_CACHE
-            ARMEmuFunc *pfunc;
-#endif
-            /* Do it fast
-               This assumes we don't differentiate between N & S cycles */
-            ARMul_CLEARABORT;
-            data = FastMap_Log2Phy(entry,address&~3);
-            count=1;
-#ifdef ARMUL_INSTR_FUNC_CACHE
-            pfunc = FastMap_Phy2Func(state,data);
-            *(pfunc++) = FASTMAP_CLOBBEREDFUNC;
-#else
-            FastMap_PhyClobberFunc(state,data);
-#endif
-            *(data++) = state->Reg[temp++];
-            if (BIT(21) && LHSReg != 15)
-                LSBase = WBBase;
-            for(;temp<16;temp++)
-                if(BIT(temp))
-                {
-#ifdef ARMUL_INSTR_FUNC_CACHE
-                    *(pfunc++) = FASTMAP_CLOBBEREDFUNC;
-#else
-                    FastMap_PhyClobberFunc(state,data);
-#endif
-                    *(data++) = state->Reg[temp];
-                    count++;
-                }
-            state->NumCycles += count;
-            return;
-        }
+        ARMword rest = BITS(0,15) & (BITS(0,15)-1);
+        /* Do it fast
+           This assumes we don't differentiate between N & S cycles */
+        ARMul_CLEARABORT;
+        FastMap_PhyClobberFuncRange(state,data,count << 2);
+        /* The first register is stored before the base is written back */
+        *data = state->Reg[temp];
+        if (BIT(21) && LHSReg != 15)
+            LSBase = WBBase;
+        if (rest)
+            ARMul_LSMStoreRegs(state->Reg,data+1,rest,count-1);
+        state->NumCycles += count;
+        return;
     }
 
     if (state->Aborted) {
@@ -937,7 +1046,7 @@ static void StoreMult(ARMul_State *state, ARMword instr,
 static void StoreSMult(ARMul_State *state, ARMword instr,
                        ARMword address, ARMword WBBase)
 {
-    ARMword temp;
+    ARMword temp, count, *data;
 
     UNDEF_LSMNoRegs;
     UNDEF_LSMPCBase;
@@ -955,44 +1064,23 @@ static void StoreSMult(ARMul_State *state, ARMword instr,
     for (temp = 0; !BIT(temp); temp++); /* N cycle first */
 
     /* Check if we can use the fastmap */
-    if((((uint32_t) (address<<20)) <= 0xfc000000) && !state->Aborted)
+    count = LSMNumRegs;
+    data = ARMul_LSMFast(state,address,count,true);
+    if(data)
     {
-        FastMapEntry *entry = FastMap_GetEntry(state,address);
-        FastMapRes res = FastMap_DecodeWrite(entry,state->FastMapMode);
-        if(FASTMAP_RESULT_DIRECT(res))
-        {
-            ARMword *data, count;
-#ifdef ARMUL_INSTR_FUNC_CACHE
-            ARMEmuFunc *pfunc;
-#endif
-            /* Do it fast
-               This assumes we don't differentiate between N & S cycles */
-            ARMul_CLEARABORT;
-            data = FastMap_Log2Phy(entry,address&~3);
-            count=1;
-#ifdef ARMUL_INSTR_FUNC_CACHE
-            pfunc = FastMap_Phy2Func(state,data);
-            *(pfunc++) = FASTMAP_CLOBBEREDFUNC;
-#else
-            FastMap_PhyClobberFunc(state,data);
-#endif
-            *(data++) = state->Reg[temp++];
-            if (BIT(21) && LHSReg != 15)
-                LSBase = WBBase;
-            for(;temp<16;temp++)
-                if(BIT(temp))
-                {
-#ifdef ARMUL_INSTR_FUNC_CACHE
-                    *(pfunc++) = FASTMAP_CLOBBEREDFUNC;
-#else
-                    FastMap_PhyClobberFunc(state,data);
-#endif
-                    *(data++) = state->Reg[temp];
-                    count++;
-                }
-            state->NumCycles += count;
-            goto done;
-        }
+        ARMword rest = BITS(0,15) & (BITS(0,15)-1);
+        /* Do it fast
+           This assumes we don't differentiate between N & S cycles */
+        ARMul_CLEARABORT;
+        FastMap_PhyClobberFuncRange(state,data,count << 2);
+        /* The first register is stored before the base is written back */
+        *data = state->Reg[temp];
+        if (BIT(21) && LHSReg != 15)
+            LSBase = WBBase;
+        if (rest)
+            ARMul_LSMStoreRegs(state->Reg,data+1,rest,count-1);
+        state->NumCycles += count;
+        goto done;
     }
 
     if (state->Aborted) {
@@ -1037,15 +1125,21 @@ done:
 *                               EmuRate code                                *
 \***************************************************************************/
 
-static CycleCount EmuRate_LastUpdateCycle;
-static clock_t EmuRate_LastUpdateTime;
-uint32_t ARMul_EmuRate = 1000000; /* Start with safe value of 1MHz */
+clock_t ARMul_HostClock(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+  if(!clock_gettime(CLOCK_THREAD_CPUTIME_ID,&ts))
+    return (clock_t) (((uint64_t) ts.tv_sec)*CLOCKS_PER_SEC+((uint64_t) ts.tv_nsec)*CLOCKS_PER_SEC/1000000000);
+#endif
+  return clock();
+}
 
 void EmuRate_Reset(ARMul_State *state)
 {
   /* Reset the EmuRate code */
-  EmuRate_LastUpdateCycle = ARMul_Time;
-  EmuRate_LastUpdateTime = clock();
+  state->EmuRateLastCycle = ARMul_Time;
+  state->EmuRateLastTime = ARMul_HostClock();
 }
 
 void EmuRate_Update(ARMul_State *state)
@@ -1053,17 +1147,17 @@ void EmuRate_Update(ARMul_State *state)
   uint64_t iocrate;
   clock_t nowtime, timediff;
   CycleCount nowcycle = ARMul_Time;
-  CycleDiff cycles = nowcycle-EmuRate_LastUpdateCycle;
+  CycleDiff cycles = nowcycle-state->EmuRateLastCycle;
   /* Ignore if not much time has passed */
   if(cycles < 40000)
     return;
-  nowtime = clock();
-  timediff = nowtime-EmuRate_LastUpdateTime;
+  nowtime = ARMul_HostClock();
+  timediff = nowtime-state->EmuRateLastTime;
   if(timediff < 10)
     return;
 
-  EmuRate_LastUpdateCycle = nowcycle;
-  EmuRate_LastUpdateTime = nowtime;
+  state->EmuRateLastCycle = nowcycle;
+  state->EmuRateLastTime = nowtime;
 
   /* Update IOC timers before we calculate the new value */
   UpdateTimerRegisters(state);
@@ -1087,13 +1181,13 @@ void EmuRate_Update(ARMul_State *state)
   /* Recalculate IOC rates */
 
   iocrate = (((uint64_t) 2000000)<<16)/ARMul_EmuRate;
-  ioc.InvIOCRate = (uint32_t) ((((uint64_t) ARMul_EmuRate)<<16)/2000000);
-  ioc.IOCRate = (uint32_t) iocrate;
+  IOC.InvIOCRate = (uint32_t) ((((uint64_t) ARMul_EmuRate)<<16)/2000000);
+  IOC.IOCRate = (uint32_t) iocrate;
 
   /* Update IOC timers again, to ensure the next interrupt occurs at the right time */
   UpdateTimerRegisters(state);
 
-  /*dbug("EmuRate %d IOC %.4f InvIOC %.4f\n",ARMul_EmuRate,((float)ioc.IOCRate)/65536,((float)ioc.InvIOCRate)/65536);  */
+  /*dbug("EmuRate %d IOC %.4f InvIOC %.4f\n",ARMul_EmuRate,((float)IOC.IOCRate)/65536,((float)IOC.InvIOCRate)/65536);  */
 }
 
 /***************************************************************************\
@@ -1101,27 +1195,91 @@ void EmuRate_Update(ARMul_State *state)
 \***************************************************************************/
 
 #define EMFUNCDECL26(name) ARMul_Emulate26_ ## name
+#define EMFUNCDEF26(name) static void EMFUNCDECL26(name) (ARMul_State *state, ARMword instr)
 #define EMFUNC_CONDTEST
+#define EMFUNC_RETURN return
+#define EMFUNC_TAILCALL(name) EMFUNCDECL26(name)(state,instr)
 #include "armemuinstr.c"
 
 #undef EMFUNCDECL26
+#undef EMFUNCDEF26
 #undef EMFUNC_CONDTEST
+#undef EMFUNC_RETURN
+#undef EMFUNC_TAILCALL
 
 
 /* ################################################################################## */
 /* ## Function called when the decode is unknown                                   ## */
 /* ################################################################################## */
-static ARMEmuFunc ARMul_Emulate_DecodeInstr(ARMword instr) {
-  ARMEmuFunc f;
 #define EMFUNCDECL26(name) ARMul_Emulate26_ ## name
+#define EMFUNCTYPE26 ARMEmuFunc
+
+static ARMEmuFunc ARMul_Emulate_DecodeARM2(ARMword instr) {
+  ARMEmuFunc f;
+#define EMFUNCSWP26(swp,noswp) EMFUNCDECL26(noswp)
+#include "armemudec.c"
+#undef EMFUNCSWP26
+
+  return f;
+} /* ARMul_Emulate_DecodeARM2 */
+
+static ARMEmuFunc ARMul_Emulate_DecodeARM250(ARMword instr) {
+  ARMEmuFunc f;
+#define EMFUNCSWP26(swp,noswp) EMFUNCDECL26(swp)
 #include "armemudec.c"
+#undef EMFUNCSWP26
 
   return f;
-} /* ARMul_Emulate_DecodeInstr */
+} /* ARMul_Emulate_DecodeARM250 */
+
+#undef EMFUNCTYPE26
+
+/* Pick the decoder to use for the processor model */
+void ARMul_EmulateSetModel(ARMul_State *state,bool hasswp)
+{
+  unsigned int model = (hasswp ? EMUMODEL_ARM250 : EMUMODEL_ARM2);
+  state->EmuDecode = ARMul_EmuDecoders[model];
+#ifdef ARMUL_INSTR_FUNC_INDEX
+  state->EmuFuncKeys = ARMul_EmuFuncKeyTable[model];
+#endif
+}
+
+#ifdef ARMUL_INSTR_FUNC_INDEX
+/* Build the key -> handler index table used by ARMul_Emulate_DecodeSlot */
+void ARMul_EmuFuncTableInit(void)
+{
+  unsigned int model, key, idx, num = 1;
+
+  ARMul_EmuFuncTable[0] = NULL;
+  for (model = 0; model < EMUMODEL_COUNT; model++) {
+    for (key = 0; key < EMUFUNC_KEYS; key++) {
+      ARMword instr = EMUFUNC_KEY_INSTR(key);
+      ARMEmuFunc f = ARMul_EmuDecoders[model](instr);
+      for (idx = 1; idx < num; idx++) {
+        if (ARMul_EmuFuncTable[idx] == f)
+          break;
+      }
+      if (idx == num) {
+        if (num == EMUFUNC_MAX) {
+          ControlPane_Error(true,"ARMul_EmuFuncTableInit: too many handlers");
+        }
+        ARMul_EmuFuncTable[num++] = f;
+      }
+      ARMul_EmuFuncKeyTable[model][key] = (ARMEmuFuncSlot) idx;
+    }
+  }
+#ifdef ARMUL_COMPUTED_GOTO
+  ARMul_ThreadBlock(NULL,NULL,NULL,NULL,0,NULL);
+#endif
+} /* ARMul_EmuFuncTableInit */
+#endif
 
 /* Pipeline entry used for prefetch aborts */
 static const PipelineEntry abortpipe = {
   ARMul_ABORTWORD
+#ifdef ARMUL_COMPUTED_GOTO
+  , FASTMAP_CLOBBEREDFUNC /* Never run from a block */
+#endif
 #ifdef ARMUL_INSTR_FUNC_CACHE
   , EMFUNCDECL26(SWI)
 #endif
@@ -1138,12 +1296,20 @@ static const PipelineEntry abortpipe = {
 static inline void execute_instruction(ARMul_State *state,const PipelineEntry *entry,ARMword r15)
 {
   ARMword instr = entry->instr;
+  state->NumInstrs++;
+#ifdef ARMUL_LAZY_FLAGS
+  if((state->FlagsOp != FLAGS_VALID) && !ARMul_FlagsSafe(instr))
+  {
+    ARMul_FlushFlagsSlow(state);
+    r15 = state->Reg[15];
+  }
+#endif
   if(ARMul_CCCheck(instr,(r15 & CCBITS)))
   {
 #ifdef ARMUL_INSTR_FUNC_CACHE
     ARMEmuFunc func = entry->func;
 #else
-    ARMEmuFunc func = ARMul_Emulate_DecodeInstr(instr);
+    ARMEmuFunc func = ARMul_Emulate_DecodeInstr(state,instr);
 #endif
     Prof_BeginFunc(func);
     (func)(state, instr);
@@ -1151,6 +1317,514 @@ static inline void execute_instruction(ARMul_State *state,const PipelineEntry *e
   }
 }
 
+/* Run any events which are due, and return the unmasked IRQ/FIQ bits which
+   are pending (plus Exception_Exit if ARMul_Exit has been called) */
+static ARMword ARMul_DispatchEvents(ARMul_State *state,ARMword r15)
+{
+  CycleCount local_time = ARMul_Time;
+  while(((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0)
+  {
+    EventQ_Func func = state->EventQ[0].Func;
+    state->EventDispatches++;
+    Prof_BeginFunc(func);
+    (func)(state,local_time);
+    Prof_EndFunc(func);
+  }
+#ifdef ARMUL_EVENT_DEADLINE
+  /* Masked IRQs/FIQs can only be unmasked by R15 writes, which will force
+     another check */
+  state->Deadline = state->EventQ[0].Time;
+#endif
+  return (state->Exception &~r15) | (state->KillEmulator ? Exception_Exit : 0);
+}
+
+/* As ARMul_DispatchEvents, but with ARMUL_EVENT_DEADLINE nothing needs doing
+   until the cycle count reaches the deadline */
+static inline ARMword ARMul_CheckEvents(ARMul_State *state,ARMword r15)
+{
+#ifdef ARMUL_EVENT_DEADLINE
+  if (((CycleDiff) (ARMul_Time-state->Deadline)) < 0)
+    return 0;
+#endif
+  return ARMul_DispatchEvents(state,r15);
+}
+
+#ifdef ARMUL_BLOCK_CACHE
+/***************************************************************************\
+*                           Basic block cache                               *
+\***************************************************************************/
+
+#define BLOCKCACHE_IDX(phys) ((((FastMapUInt)(phys))>>2)&(BLOCKCACHE_SIZE-1))
+
+/* The block loops take a copy of the deadline when they start, and after
+   each time they dispatch events, and compare the cycle count against that.
+   Anything which brings the deadline forwards also stops the block (see
+   ARMul_ForceEventCheck and EventQ_UpdateDeadline), so the copy can't go
+   stale. Without ARMUL_EVENT_DEADLINE, events get dispatched before every
+   instruction */
+#ifdef ARMUL_EVENT_DEADLINE
+#define BLOCK_DEADLINE (state->Deadline)
+#else
+#define BLOCK_DEADLINE (state->NumCycles)
+#endif
+
+/* Results of ARMul_RunBlock */
+#define BLOCK_MISS        0 /* No block available, nothing executed */
+#define BLOCK_FALLTHROUGH 1 /* Ran off the end of the block, pipe[1] & pipe[2] hold the next two instructions */
+#define BLOCK_PCCHANGED   2 /* An instruction altered the PC */
+#define BLOCK_EXCEPTION   3 /* An IRQ or FIQ was taken */
+
+/* Guess whether an instruction is likely to write to the PC, to avoid
+   wasting time decoding instructions which are unlikely to be reached */
+static inline bool ARMul_BlockEnds(ARMword instr)
+{
+  switch (BITS(25,27)) {
+    case 0: case 1: /* Data processing, multiply, swap */
+      return (BITS(12,15) == 15);
+    case 2: case 3: /* LDR/STR */
+      return (BIT(20) && (BITS(12,15) == 15));
+    case 4: /* LDM/STM */
+      return (BIT(20) && BIT(15));
+    default: /* Branch, coprocessor, SWI */
+      return true;
+  }
+}
+
+#ifdef ARMUL_IDLE_DETECT
+/* Register usage masks for idle loop detection; bits 0-15 are the registers */
+#define IDLE_N (UINT32_C(1) << 16)
+#define IDLE_Z (UINT32_C(1) << 17)
+#define IDLE_C (UINT32_C(1) << 18)
+#define IDLE_V (UINT32_C(1) << 19)
+#define IDLE_NZCV (IDLE_N|IDLE_Z|IDLE_C|IDLE_V)
+
+/* Work out which registers/flags an instruction reads and writes. Returns
+   false if it isn't one of the simple ALU ops or loads that idle loops are
+   made from. Writes which may or may not happen are returned in maybe */
+static bool ARMul_IdleOpRegs(ARMword instr,uint32_t *reads,uint32_t *writes,uint32_t *maybe)
+{
+  uint32_t r = 0, w = 0, m = 0;
+  if ((instr>>28) != AL)
+    r |= IDLE_NZCV;
+  switch (BITS(25,27)) {
+    case 0: /* Data processing with register RHS */
+      if (BIT(4) && BIT(7)) /* Multiply, swap */
+        return false;
+      if ((BITS(0,3) == 15) || (BIT(4) && (BITS(8,11) == 15)))
+        return false;
+      r |= 1u << BITS(0,3);
+      if (BIT(4))
+        r |= 1u << BITS(8,11);
+      else if (BITS(5,11) == 3) /* RRX */
+        r |= IDLE_C;
+      /* fall through */
+    case 1: /* Data processing with immediate RHS */
+      if ((BITS(12,15) == 15) || (BITS(16,19) == 15))
+        return false;
+      switch (BITS(21,24)) {
+        case 5: case 6: case 7: /* ADC, SBC, RSC */
+          r |= IDLE_C;
+          break;
+        case 8: case 9: case 10: case 11: /* TST, TEQ, CMP, CMN */
+          if (!BIT(20)) /* MRS, SWP, etc. */
+            return false;
+          break;
+      }
+      if ((BITS(21,24) != 13) && (BITS(21,24) != 15)) /* Not MOV, MVN */
+        r |= 1u << BITS(16,19);
+      if ((BITS(21,24) < 8) || (BITS(21,24) > 11))
+        w |= 1u << BITS(12,15);
+      if (BIT(20)) {
+        switch (BITS(21,24)) {
+          case 2: case 3: case 4: case 5: case 6: case 7: case 10: case 11:
+            w |= IDLE_NZCV; /* Arithmetic */
+            break;
+          default: /* Logical, C comes from the shifter */
+            w |= IDLE_N|IDLE_Z;
+            if (BIT(25) ? (BITS(8,11) != 0) : (BITS(4,11) != 0)) {
+              if (!BIT(25) && BIT(4))
+                m |= IDLE_C; /* Depends on Rs */
+              else
+                w |= IDLE_C;
+            }
+            break;
+        }
+      }
+      break;
+    case 2: /* LDR/LDRB with immediate offset, without writeback */
+      if (!BIT(20) || !BIT(24) || BIT(21) || (BITS(12,15) == 15) || (BITS(16,19) == 15))
+        return false;
+      r |= 1u << BITS(16,19);
+      w |= 1u << BITS(12,15);
+      break;
+    default:
+      return false;
+  }
+  *reads = r;
+  *writes = w;
+  *maybe = m;
+  return true;
+}
+
+/* Decide whether a block is an idle loop, i.e. a run of ALU ops and loads
+   ending with a branch back to the start of the block, where nothing is
+   carried over from one iteration to the next. Unless memory changes (which
+   only an IRQ handler or other event can do), every iteration will do
+   exactly the same thing. The loads are checked for I/O accesses each time
+   the loop is run, see ARMul_IdleCheck */
+static bool ARMul_BlockIsIdleLoop(const BasicBlock *blk)
+{
+  uint32_t reads, writes, maybe, written = 0, defined = 0;
+  uint_fast8_t i, len;
+
+  /* Find the branch, and everything the loop writes to */
+  for (len=0;len<blk->Len;len++) {
+    ARMword instr = blk->Ops[len].instr;
+    if (BITS(25,27) == 5) {
+      if (BIT(24) || ((instr & 0xffffff) != ((0-(len+2)) & 0xffffff)))
+        return false; /* BL, or not a branch to the start */
+      break;
+    }
+    if (!ARMul_IdleOpRegs(instr,&reads,&writes,&maybe))
+      return false;
+    written |= writes | maybe;
+  }
+  if (len == blk->Len)
+    return false;
+
+  /* Nothing written by the loop can be read before it's been written by
+     an unconditional instruction in the same iteration. Load addresses must
+     be loop invariant */
+  for (i=0;i<len;i++) {
+    ARMword instr = blk->Ops[i].instr;
+    ARMul_IdleOpRegs(instr,&reads,&writes,&maybe);
+    if (reads & written & ~defined)
+      return false;
+    if ((BITS(25,27) == 2) && (written & (1u << BITS(16,19))))
+      return false;
+    if ((instr>>28) == AL)
+      defined |= writes;
+  }
+  if (((blk->Ops[len].instr>>28) != AL) && (IDLE_NZCV & written & ~defined))
+    return false;
+  return true;
+}
+
+/* Called after a block has altered the PC. If it was an idle loop which
+   went round again without touching any I/O, skip ahead to the next event */
+static void ARMul_IdleCheck(ARMul_State *state,const BasicBlock *blk,ARMword start)
+{
+  const BlockOp *op;
+  if (((state->Reg[15] ^ start) & R15PCBITS) || (state->BlockCur != blk) || (state->Exception &~state->Reg[15]))
+    return;
+  for (op=blk->Ops;((op->instr>>25)&7) != 5;op++) {
+    ARMword instr = op->instr;
+    if (BITS(25,27) == 2) {
+      ARMword addr = state->Reg[BITS(16,19)];
+      FastMapEntry *entry;
+      addr = (BIT(23) ? addr+BITS(0,11) : addr-BITS(0,11));
+      entry = FastMap_GetEntry(state,addr);
+      if (!FASTMAP_RESULT_DIRECT(FastMap_DecodeRead(entry,state->FastMapMode)))
+        return;
+    }
+  }
+  if (((CycleDiff) (state->EventQ[0].Time-ARMul_Time)) > 0)
+    state->NumCycles = state->EventQ[0].Time;
+}
+#endif
+
+void ARMul_BlockCache_Clobber(ARMul_State *state,const ARMword *addr)
+{
+  /* Any block containing this word must start within BLOCK_MAXLEN words of it */
+  FastMapUInt start = (FastMapUInt) addr;
+  uint_fast8_t i;
+  for(i=0;i<BLOCK_MAXLEN;i++,start-=4)
+  {
+    BasicBlock *blk = &state->BlockCache[BLOCKCACHE_IDX(start)];
+    if(((FastMapUInt) blk->Phys == start) && (i < blk->Len))
+    {
+      blk->Phys = NULL;
+      if(blk == state->BlockCur)
+        state->BlockCur = NULL;
+    }
+  }
+}
+
+static BasicBlock *ARMul_BlockCache_Get(ARMul_State *state,ARMword addr)
+{
+  FastMapEntry *entry;
+  FastMapRes res;
+  ARMword *data;
+  ARMEmuFuncSlot *pfunc;
+  BasicBlock *blk;
+  uint_fast8_t len,end,max;
+
+  addr &= 0x3fffffc;
+  entry = FastMap_GetEntryNoWrap(state,addr);
+  res = FastMap_DecodeRead(entry,state->FastMapMode);
+  if(!FASTMAP_RESULT_DIRECT(res))
+    return NULL;
+
+  data = FastMap_Log2Phy(entry,addr);
+  blk = &state->BlockCache[BLOCKCACHE_IDX(data)];
+  if(blk->Phys == data)
+    return blk;
+
+  /* Build a new block. Blocks can't cross page boundaries, and must be at
+     least three instructions long to fill the pipeline */
+  max = MIN(BLOCK_MAXLEN,(4096-(addr&4095))>>2);
+  if(max < 3)
+    return NULL;
+  pfunc = FastMap_Phy2Func(state,data);
+  end = max;
+  for(len=0;len<end;len++)
+  {
+    ARMword instr = data[len];
+    ARMEmuFuncSlot temp = pfunc[len];
+    if(temp == FASTMAP_CLOBBEREDFUNC)
+    {
+      /* Decode the instruction */
+      temp = pfunc[len] = ARMul_Emulate_DecodeSlot(state,instr);
+      FastMap_PhyMarkCode(state,data);
+    }
+    blk->Ops[len].instr = instr;
+    blk->Ops[len].func = ARMul_EmuFuncFromSlot(temp);
+#ifdef ARMUL_COMPUTED_GOTO
+    blk->Ops[len].slot = temp;
+#endif
+    /* Keep the two instructions after a PC write, since they'll have been
+       fetched by the time it executes */
+    if((end == max) && ARMul_BlockEnds(instr))
+      end = MIN(max,len+3);
+  }
+  blk->Phys = data;
+  blk->Len = len;
+#ifdef ARMUL_IDLE_DETECT
+  blk->IdleLoop = state->IdleDetect && ARMul_BlockIsIdleLoop(blk);
+#endif
+  return blk;
+}
+
+#ifdef ARMUL_COMPUTED_GOTO
+/* Threaded code version of the ARMul_RunBlock loop, for compilers which
+   support labels as values. The handlers from armemuinstr.c are included
+   again as labels inside this function, with a copy of the code to fetch and
+   dispatch the next instruction in front of each one, so every handler ends
+   with its own indirect jump to the next handler. state, instr and r15 stay
+   in locals throughout, rather than being passed to a function call.
+
+   Called with state == NULL by ARMul_EmuFuncTableInit, to fill in
+   ARMul_EmuLabelTable */
+static int ARMul_ThreadBlock(ARMul_State *state,const BasicBlock *blk,const BlockOp *op,const BlockOp *last,ARMword r15,BlockOp *pipe)
+{
+  ARMword instr, excep;
+  CycleCount deadline;
+
+  if (!state) {
+    unsigned int key;
+    for (key = 0; key < EMUFUNC_KEYS; key++) {
+      ARMul_EmuLabel f;
+      instr = EMUFUNC_KEY_INSTR(key);
+#undef EMFUNCDECL26
+#define EMFUNCDECL26(name) &&EMLABEL_ ## name
+#define EMFUNCTYPE26 ARMul_EmuLabel
+#define EMFUNCSWP26(swp,noswp) EMFUNCDECL26(noswp)
+#include "armemudec.c"
+#undef EMFUNCSWP26
+      ARMul_EmuLabelTable[ARMul_EmuFuncKeyTable[EMUMODEL_ARM2][key]] = f;
+#define EMFUNCSWP26(swp,noswp) EMFUNCDECL26(swp)
+#include "armemudec.c"
+#undef EMFUNCSWP26
+      ARMul_EmuLabelTable[ARMul_EmuFuncKeyTable[EMUMODEL_ARM250][key]] = f;
+#undef EMFUNCDECL26
+#undef EMFUNCTYPE26
+    }
+    return BLOCK_MISS;
+  }
+
+#ifdef ARMUL_LAZY_FLAGS
+#define THREAD_FLAGS \
+  if((state->FlagsOp != FLAGS_VALID) && !ARMul_FlagsSafe(instr)) \
+  { \
+    ARMul_FlushFlagsSlow(state); \
+    r15 = state->Reg[15]; \
+  }
+#else
+#define THREAD_FLAGS
+#endif
+
+/* Fetch the instruction at op and jump to its handler, as per
+   ARMul_RunBlock and execute_instruction */
+#define THREAD_FETCH(cycles) \
+  state->NumCycles += cycles; \
+  ARMul_CLEARABORT; \
+  NORMALCYCLE; \
+  if (((CycleDiff) (state->NumCycles-deadline)) >= 0) \
+    goto events; \
+  THREAD_DISPATCH
+
+#define THREAD_DISPATCH \
+  state->Reg[15] = r15; \
+  instr = op->instr; \
+  state->NumInstrs++; \
+  THREAD_FLAGS \
+  if (!ARMul_CCCheck(instr,(r15 & CCBITS))) \
+    goto skipped; \
+  goto *ARMul_EmuLabelTable[op->slot];
+
+/* Move on to the next instruction after a handler has finished */
+#define THREAD_NEXT \
+  op++; \
+  if (state->NextInstr > PCINCED) \
+    return BLOCK_PCCHANGED; \
+  if ((op == last) || (state->BlockCur != blk)) \
+    goto fallthrough; \
+  r15 = state->Reg[15]; \
+  if (state->NextInstr == NORMAL) \
+    r15 += 4; \
+  THREAD_FETCH(1)
+
+  /* Equivalent of ARMul_LoadInstrTriplet */
+  deadline = BLOCK_DEADLINE;
+  THREAD_FETCH(3)
+
+#define EMFUNCDECL26(name) EMLABEL_ ## name
+#define EMFUNCDEF26(name) THREAD_NEXT EMFUNCDECL26(name):
+#define EMFUNC_CONDTEST
+#define EMFUNC_RETURN goto skipped
+#define EMFUNC_TAILCALL(name) goto EMFUNCDECL26(name)
+#include "armemuinstr.c"
+
+#undef EMFUNCDECL26
+#undef EMFUNCDEF26
+#undef EMFUNC_CONDTEST
+#undef EMFUNC_RETURN
+#undef EMFUNC_TAILCALL
+
+skipped:
+  THREAD_NEXT
+
+events:
+  excep = ARMul_DispatchEvents(state,r15);
+  deadline = BLOCK_DEADLINE;
+  if (excep) {
+    state->Reg[15] = r15;
+    goto exception;
+  }
+  THREAD_DISPATCH
+
+fallthrough:
+  pipe[1] = op[0];
+  pipe[2] = op[1];
+  return BLOCK_FALLTHROUGH;
+
+exception:
+  if (excep & Exception_FIQ) {
+    ARMul_Abort(state, ARMul_FIQV);
+  } else if (excep & Exception_IRQ) {
+    ARMul_Abort(state, ARMul_IRQV);
+  }
+  return BLOCK_EXCEPTION;
+
+#undef THREAD_FLAGS
+#undef THREAD_FETCH
+#undef THREAD_DISPATCH
+#undef THREAD_NEXT
+}
+#endif
+
+/* Execute instructions from a block, until the PC is altered, an exception
+   occurs, or the end of the block is reached. Behaves exactly as if the
+   instructions had been fetched one at a time */
+static int ARMul_RunBlock(ARMul_State *state,ARMword r15,PipelineEntry *pipe)
+{
+  BasicBlock *blk = ARMul_BlockCache_Get(state,r15);
+#ifdef ARMUL_IDLE_DETECT
+  const ARMword start = r15;
+#endif
+  const PipelineEntry *op, *last;
+#ifndef ARMUL_COMPUTED_GOTO
+  CycleCount deadline;
+#endif
+  if(!blk)
+    return BLOCK_MISS;
+
+  op = blk->Ops;
+  last = op+blk->Len-2;
+  state->BlockCur = blk;
+
+  r15 += 8;
+
+#ifdef ARMUL_COMPUTED_GOTO
+  {
+    int res = ARMul_ThreadBlock(state,blk,op,last,r15,pipe);
+#ifdef ARMUL_IDLE_DETECT
+    if ((res == BLOCK_PCCHANGED) && blk->IdleLoop)
+      ARMul_IdleCheck(state,blk,start);
+#endif
+    return res;
+  }
+#else
+  /* Equivalent of ARMul_LoadInstrTriplet */
+  state->NumCycles += 3;
+  ARMul_CLEARABORT;
+  deadline = BLOCK_DEADLINE;
+  for (;;) {
+    ARMword excep = 0;
+    NORMALCYCLE;
+
+    if (((CycleDiff) (state->NumCycles-deadline)) >= 0) {
+      excep = ARMul_DispatchEvents(state,r15);
+      deadline = BLOCK_DEADLINE;
+    }
+
+    /* Write back updated PC before handling exception/instruction */
+    state->Reg[15] = r15;
+
+    if (excep) { /* Any exceptions */
+      if (excep & Exception_FIQ) {
+        Prof_BeginFunc(ARMul_Abort);
+        ARMul_Abort(state, ARMul_FIQV);
+        Prof_EndFunc(ARMul_Abort);
+      } else if (excep & Exception_IRQ) {
+        Prof_BeginFunc(ARMul_Abort);
+        ARMul_Abort(state, ARMul_IRQV);
+        Prof_EndFunc(ARMul_Abort);
+      }
+      return BLOCK_EXCEPTION;
+    }
+
+    execute_instruction(state,op,r15);
+    op++;
+
+    if (state->NextInstr > PCINCED) {
+#ifdef ARMUL_IDLE_DETECT
+      if (blk->IdleLoop)
+        ARMul_IdleCheck(state,blk,start);
+#endif
+      return BLOCK_PCCHANGED;
+    }
+
+    /* Stop if we've run out of instructions, or if the block was clobbered
+       or the memory map changed (in which case the next two instructions
+       are still valid, as they'd already be in the pipeline) */
+    if ((op == last) || (state->BlockCur != blk)) {
+      pipe[1] = op[0];
+      pipe[2] = op[1];
+      return BLOCK_FALLTHROUGH;
+    }
+
+    /* Fetch the next instruction */
+    r15 = state->Reg[15];
+    if (state->NextInstr == NORMAL)
+      r15 += 4;
+    state->NumCycles++;
+    ARMul_CLEARABORT;
+  }
+#endif
+}
+#endif
+
 void
 ARMul_Emulate26(ARMul_State *state)
 {
@@ -1166,6 +1840,7 @@ ARMul_Emulate26(ARMul_State *state)
    *                        Execute the next instruction                    *
   \**************************************************************************/
   state->KillEmulator = false;
+  ARMul_ForceEventCheck(state);
   while (!state->KillEmulator) {
     Prof_Begin("ARMul_Emulate26 prime");
     if (state->NextInstr < PRIMEPIPE) {
@@ -1176,8 +1851,8 @@ ARMul_Emulate26(ARMul_State *state)
 #endif
 
 #ifdef ARMUL_INSTR_FUNC_CACHE
-      pipe[1].func = ARMul_Emulate_DecodeInstr(pipe[1].instr);
-      pipe[2].func = ARMul_Emulate_DecodeInstr(pipe[2].instr);
+      pipe[1].func = ARMul_Emulate_DecodeInstr(state,pipe[1].instr);
+      pipe[2].func = ARMul_Emulate_DecodeInstr(state,pipe[2].instr);
 #endif
 #ifndef FLATPIPE
       pipeidx = 0;
@@ -1235,6 +1910,7 @@ ARMul_Emulate26(ARMul_State *state)
       while(((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0)
       {
         EventQ_Func func = state->EventQ[0].Func;
+        state->EventDispatches++;
         Prof_BeginFunc(func);
         (func)(state,local_time);
         Prof_EndFunc(func);
@@ -1245,6 +1921,7 @@ ARMul_Emulate26(ARMul_State *state)
       while((((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0) && --loops)
       {
         EventQ_Func func = state->EventQ[0].Func;
+        state->EventDispatches++;
         Prof_BeginFunc(func);
         (func)(state,local_time);
         Prof_EndFunc(func);
@@ -1255,13 +1932,13 @@ ARMul_Emulate26(ARMul_State *state)
       }
 #endif
 
-      ARMword excep = state->Exception &~state->Reg[15];
+      ARMword excep = (state->Exception &~state->Reg[15]) | (state->KillEmulator ? Exception_Exit : 0);
       if (excep) { /* Any exceptions */
         if (excep & Exception_FIQ) {
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_FIQV);
           Prof_EndFunc(ARMul_Abort);
-        } else {
+        } else if (excep & Exception_IRQ) {
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_IRQV);
           Prof_EndFunc(ARMul_Abort);
@@ -1273,7 +1950,6 @@ ARMul_Emulate26(ARMul_State *state)
       execute_instruction(state,&pipe[pipeidx],state->Reg[15]);
 #else
 /* pipeidx = 0 */
-      CycleCount local_time;
       ARMword excep;
       ARMword r15 = state->Reg[15];
       Prof_Begin("Fetch/decode");
@@ -1290,17 +1966,8 @@ ARMul_Emulate26(ARMul_State *state)
       }
       Prof_End("Fetch/decode");
 
-      local_time = ARMul_Time;
-      while(((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0)
-      {
-        EventQ_Func func = state->EventQ[0].Func;
-        Prof_BeginFunc(func);
-        (func)(state,local_time);
-        Prof_EndFunc(func);
-      }
+      excep = ARMul_CheckEvents(state,r15);
 
-      excep = state->Exception &~r15;
-      
       /* Write back updated PC before handling exception/instruction */
       state->Reg[15] = r15;
 
@@ -1310,7 +1977,7 @@ ARMul_Emulate26(ARMul_State *state)
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_FIQV);
           Prof_EndFunc(ARMul_Abort);
-        } else {
+        } else if (excep & Exception_IRQ) {
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_IRQV);
           Prof_EndFunc(ARMul_Abort);
@@ -1336,17 +2003,8 @@ ARMul_Emulate26(ARMul_State *state)
       }
       Prof_End("Fetch/decode");
 
-      local_time = ARMul_Time;
-      while(((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0)
-      {
-        EventQ_Func func = state->EventQ[0].Func;
-        Prof_BeginFunc(func);
-        (func)(state,local_time);
-        Prof_EndFunc(func);
-      }
+      excep = ARMul_CheckEvents(state,r15);
 
-      excep = state->Exception &~r15;
-      
       /* Write back updated PC before handling exception/instruction */
       state->Reg[15] = r15;
 
@@ -1356,7 +2014,7 @@ ARMul_Emulate26(ARMul_State *state)
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_FIQV);
           Prof_EndFunc(ARMul_Abort);
-        } else {
+        } else if (excep & Exception_IRQ) {
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_IRQV);
           Prof_EndFunc(ARMul_Abort);
@@ -1379,6 +2037,23 @@ ARMul_Emulate26(ARMul_State *state)
         default: /* The program counter has been changed */
         reset_pipe:
           state->Aborted = 0;
+#ifdef ARMUL_BLOCK_CACHE
+          Prof_End("Fetch/decode");
+          switch (ARMul_RunBlock(state, r15, pipe)) {
+            case BLOCK_FALLTHROUGH: /* Resume from pipeidx 0 */
+              continue;
+            case BLOCK_PCCHANGED:
+              r15 = state->Reg[15];
+              Prof_Begin("Fetch/decode");
+              goto reset_pipe;
+            case BLOCK_EXCEPTION:
+              pipeidx = 0;
+              goto exception_taken;
+            default:
+              Prof_Begin("Fetch/decode");
+              break;
+          }
+#endif
           ARMul_LoadInstrTriplet(state, r15, pipe);
           r15 += 8;
           break;
@@ -1386,17 +2061,8 @@ ARMul_Emulate26(ARMul_State *state)
       NORMALCYCLE;
       Prof_End("Fetch/decode");
 
-      local_time = ARMul_Time;
-      while(((CycleDiff) (local_time-state->EventQ[0].Time)) >= 0)
-      {
-        EventQ_Func func = state->EventQ[0].Func;
-        Prof_BeginFunc(func);
-        (func)(state,local_time);
-        Prof_EndFunc(func);
-      }
+      excep = ARMul_CheckEvents(state,r15);
 
-      excep = state->Exception &~r15;
-      
       /* Write back updated PC before handling exception/instruction */
       state->Reg[15] = r15;
 
@@ -1406,7 +2072,7 @@ ARMul_Emulate26(ARMul_State *state)
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_FIQV);
           Prof_EndFunc(ARMul_Abort);
-        } else {
+        } else if (excep & Exception_IRQ) {
           Prof_BeginFunc(ARMul_Abort);
           ARMul_Abort(state, ARMul_IRQV);
           Prof_EndFunc(ARMul_Abort);
@@ -1418,6 +2084,9 @@ ARMul_Emulate26(ARMul_State *state)
 #endif
     } /* for loop */
 
+#ifdef ARMUL_BLOCK_CACHE
+exception_taken:
+#endif
     state->decoded = pipe[(pipeidx+1)%PIPESIZE].instr;
     state->loaded = pipe[(pipeidx+2)%PIPESIZE].instr;
 #ifndef FLATPIPE
@@ -1426,4 +2095,15 @@ ARMul_Emulate26(ARMul_State *state)
     state->pc = PC;
 #endif
   }
+#ifdef FLATPIPE
+  /* R15 is 8 ahead of the instruction that was about to run. Point it back
+     at that instruction and refill the pipeline on the next call, so that
+     we resume from the right place (unless an exception was just taken, in
+     which case R15 already holds the vector) */
+  if (!(state->NextInstr & PRIMEPIPE)) {
+    SETPC(state->Reg[15]-8);
+    FLUSHPIPE;
+  }
+#endif
+  ARMul_FlushFlags(state);
 } /* Emulate 26 in instruction based mode */
@@ -120,6 +120,30 @@
 #define SETV state->Reg[15] |= VBIT
 #define CLEARV state->Reg[15] &= ~VBIT
 
+#ifdef ARMUL_LAZY_FLAGS
+/* Values of state->FlagsOp. While a calculation is pending, the NZCV bits in
+   R15 are stale, and must be brought up to date with ARMul_FlushFlags before
+   anything looks at them */
+#define FLAGS_VALID 0 /* NZCV in R15 are up to date */
+#define FLAGS_ADD   1 /* NZCV are those of FlagsA + FlagsB (+ C) = FlagsRes */
+#define FLAGS_SUB   2 /* NZCV are those of FlagsA - FlagsB (- !C) = FlagsRes */
+
+extern void ARMul_FlushFlagsSlow(ARMul_State *state);
+
+static inline void ARMul_FlushFlags(ARMul_State *state)
+{
+  if (state->FlagsOp != FLAGS_VALID)
+    ARMul_FlushFlagsSlow(state);
+}
+
+/* Discard any pending calculation, for when all of NZCV are about to be
+   overwritten */
+#define ARMul_DiscardFlags(state) ((state)->FlagsOp = FLAGS_VALID)
+#else
+#define ARMul_FlushFlags(state) ((void) (state))
+#define ARMul_DiscardFlags(state) ((void) (state))
+#endif
+
 #ifndef ARMUL_ARCH_ARM
 #define ASSIGNC(res) state->Reg[15] = (res?state->Reg[15]|CBIT:state->Reg[15]&~CBIT)
 #else
@@ -163,7 +187,8 @@ static inline void inlASSIGN(ARMul_State *state,ARMword res,ARMword bit)
 #define ER15INT (state->Reg[15] & R15IFBITS)
 #define EMODE (state->Reg[15] & R15MODEBITS)
 
-#define SETR15PSR(s) if (R15MODE == USER26MODE) { \
+#define SETR15PSR(s) ARMul_DiscardFlags(state); \
+                     if (R15MODE == USER26MODE) { \
                         state->Reg[15] = ((s) & CCBITS) | R15INTPCMODE; \
                         } \
                      else { \
@@ -345,6 +370,10 @@ static inline ARMword inlLHS(ARMul_State *state,ARMword r)
 \***************************************************************************/
 
 void ARMul_Emulate26(ARMul_State *state);
+void ARMul_EmulateSetModel(ARMul_State *state,bool hasswp);
+#ifdef ARMUL_INSTR_FUNC_INDEX
+void ARMul_EmuFuncTableInit(void);
+#endif
 
 static inline void ARMul_Icycles(ARMul_State *state,unsigned number)
 {
@@ -360,6 +389,50 @@ extern uint_least8_t ARMul_BitList[];       /* Number of bits in a byte table */
 extern uint_least16_t ARMul_CCTable[16];
 #define ARMul_CCCheck(instr,psr) (ARMul_CCTable[instr>>28] & (1<<(psr>>28)))
 
+#ifdef ARMUL_LAZY_FLAGS
+/* Returns true if an instruction can be executed while a flag calculation is
+   pending, i.e. it's unconditional and it neither reads nor writes NZCV (other
+   than via ARMul_AddFlags/ARMul_SubFlags) or any other part of R15. Errs on
+   the side of caution */
+static inline bool ARMul_FlagsSafe(ARMword instr)
+{
+  if ((instr>>28) != AL)
+    return false;
+  switch (BITS(25,27)) {
+    case 0: /* Data processing with register RHS, multiply, swap */
+      /* Reject register specified shifts, R15 and RRX */
+      if (BIT(4) || (BITS(0,3) == 15) || (BITS(5,11) == 3))
+        return false;
+      /* fall through */
+    case 1: /* Data processing with immediate RHS */
+      if ((BITS(12,15) == 15) || (BITS(16,19) == 15))
+        return false;
+      switch (BITS(21,24)) {
+        case 2: case 3: case 4: /* SUB, RSB, ADD */
+          return true;
+        case 10: case 11: /* CMP, CMN */
+          return BIT(20);
+        case 0: case 1: case 12: case 13: case 14: case 15: /* AND, EOR, ORR, MOV, BIC, MVN */
+          return !BIT(20);
+        default: /* ADC, SBC, RSC, TST, TEQ */
+          return false;
+      }
+    case 3: /* LDR/STR with register offset */
+      if (BIT(4) || (BITS(0,3) == 15) || (BITS(5,11) == 3))
+        return false;
+      /* fall through */
+    case 2: /* LDR/STR with immediate offset */
+      return (BITS(12,15) != 15) && (BITS(16,19) != 15);
+    case 4: /* LDM/STM */
+      return !BIT(15) && (BITS(16,19) != 15);
+    case 5: /* B, but not BL */
+      return !BIT(24);
+    default: /* Coprocessor, SWI */
+      return false;
+  }
+}
+#endif
+
 unsigned ARMul_NthReg(ARMword instr,unsigned number);
 void ARMul_R15Altered(ARMul_State *state);
 ARMword ARMul_SwitchMode(ARMul_State *state,ARMword oldmode, ARMword newmode);
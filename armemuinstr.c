@@ -1,14 +1,14 @@
 /* ################################################################################## */
 /* ## Individual decoded instruction functions                                     ## */
 /* ################################################################################## */
-static void EMFUNCDECL26(Branch) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Branch) {
   EMFUNC_CONDTEST
   /* Note that the upper bits of instr (those that don't form the branch offset) get masked out by INCPC */
   INCPCAMT(instr<<2);
   FLUSHPIPE;
 } /* EMFUNCDECL26(Branch */
 
-static void EMFUNCDECL26(BranchLink) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BranchLink) {
   EMFUNC_CONDTEST
 #ifndef ARMUL_USE_IMMEDTABLE
   /* Do what INCPCAMT does when the immedtable isn't in use. Compiler should spot that they're similar and merge them. */
@@ -23,7 +23,7 @@ static void EMFUNCDECL26(BranchLink) (ARMul_State *state, ARMword instr) {
   FLUSHPIPE;
 } /* EMFUNCDECL26(BranchLink */
 
-static void EMFUNCDECL26(Mul) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Mul) {
   register ARMword temp;
   ARMword rhs;
 
@@ -43,7 +43,7 @@ static void EMFUNCDECL26(Mul) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(Mul */
 
-static void EMFUNCDECL26(Muls) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Muls) {
   register ARMword dest,temp;
   ARMword rhs;
 
@@ -68,7 +68,7 @@ static void EMFUNCDECL26(Muls) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(Muls */
 
-static void EMFUNCDECL26(Mla) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Mla) {
   register ARMword temp;
   ARMword rhs;
 
@@ -88,7 +88,7 @@ static void EMFUNCDECL26(Mla) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(Mla */
 
-static void EMFUNCDECL26(Mlas) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Mlas) {
   register ARMword dest,temp;
   ARMword rhs;
 
@@ -113,7 +113,7 @@ static void EMFUNCDECL26(Mlas) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(Mlas */
 
-static void EMFUNCDECL26(AndReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AndReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -124,7 +124,7 @@ static void EMFUNCDECL26(AndReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(AndReg */
 
-static void EMFUNCDECL26(AndsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AndsReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -135,7 +135,7 @@ static void EMFUNCDECL26(AndsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(AndsReg */
 
-static void EMFUNCDECL26(EorReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(EorReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -146,7 +146,7 @@ static void EMFUNCDECL26(EorReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(EorReg */
 
-static void EMFUNCDECL26(EorsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(EorsReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -157,7 +157,7 @@ static void EMFUNCDECL26(EorsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(EorsReg */
 
-static void EMFUNCDECL26(SubReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SubReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -167,7 +167,7 @@ static void EMFUNCDECL26(SubReg) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26(SubReg */
 
-static void EMFUNCDECL26(SubsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SubsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -180,7 +180,7 @@ static void EMFUNCDECL26(SubsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(SubsReg */
 
-static void EMFUNCDECL26(RsbReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RsbReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -190,7 +190,7 @@ static void EMFUNCDECL26(RsbReg) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26(RsbReg */
 
-static void EMFUNCDECL26(RsbsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RsbsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -203,7 +203,7 @@ static void EMFUNCDECL26(RsbsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(RsbsReg */
 
-static void EMFUNCDECL26(AddReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AddReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -214,7 +214,7 @@ static void EMFUNCDECL26(AddReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(AddReg */
 
-static void EMFUNCDECL26(AddsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AddsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -227,7 +227,7 @@ static void EMFUNCDECL26(AddsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(AddsReg */
 
-static void EMFUNCDECL26(AdcReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AdcReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -238,7 +238,7 @@ rhs = DPRegRHS;
 
 } /* EMFUNCDECL26(AdcReg */
 
-static void EMFUNCDECL26(AdcsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AdcsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -252,7 +252,7 @@ static void EMFUNCDECL26(AdcsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(AdcsReg */
 
-static void EMFUNCDECL26(SbcReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SbcReg) {
   register ARMword dest;
   ARMword rhs;
 
@@ -263,7 +263,7 @@ static void EMFUNCDECL26(SbcReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(SbcReg */
 
-static void EMFUNCDECL26(SbcsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SbcsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -276,7 +276,7 @@ static void EMFUNCDECL26(SbcsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(SbcsReg */
 
-static void EMFUNCDECL26(RscReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RscReg) {
   ARMword dest,rhs;
 
   EMFUNC_CONDTEST
@@ -286,7 +286,7 @@ static void EMFUNCDECL26(RscReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(RscReg */
 
-static void EMFUNCDECL26(RscsReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RscsReg) {
   register ARMword dest;
   ARMword lhs,rhs;
 
@@ -299,16 +299,11 @@ static void EMFUNCDECL26(RscsReg) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26(RscsReg */
 
-static void EMFUNCDECL26(TstRegMrs1SwpNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TstRegMrs1SwpNorm) {
   register ARMword dest, temp;
 
   EMFUNC_CONDTEST
              if (BITS(4,11) == 9) { /* SWP */
-                if (!state->HasSWP) {
-                  ARMul_Abort(state,ARMul_UndefinedInstrV);
-                  return;
-                }
-
                 temp = LHS;
                 BUSUSEDINCPCS;
 
@@ -335,7 +330,7 @@ static void EMFUNCDECL26(TstRegMrs1SwpNorm) (ARMul_State *state, ARMword instr)
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TstpRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TstpRegNorm) {
   register ARMword dest;
   ARMword rhs;
 
@@ -345,7 +340,7 @@ static void EMFUNCDECL26(TstpRegNorm) (ARMul_State *state, ARMword instr) {
   ARMul_NegZero(state,dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TeqpRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TeqpRegNorm) {
   register ARMword dest;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -355,16 +350,11 @@ static void EMFUNCDECL26(TeqpRegNorm) (ARMul_State *state, ARMword instr) {
   ARMul_NegZero(state,dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmpRegMrs2SwpNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmpRegMrs2SwpNorm) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
              if (BITS(4,11) == 9) { /* SWP */
-                if (!state->HasSWP) {
-                  ARMul_Abort(state,ARMul_UndefinedInstrV);
-                  return;
-                }
-
                 temp = LHS;
                 BUSUSEDINCPCS;
                 if (ADDREXCEPT(temp)) {
@@ -381,7 +371,7 @@ static void EMFUNCDECL26(CmpRegMrs2SwpNorm) (ARMul_State *state, ARMword instr)
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmppRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmppRegNorm) {
   register ARMword dest;
   ARMword lhs,rhs;
   EMFUNC_CONDTEST
@@ -389,11 +379,11 @@ static void EMFUNCDECL26(CmppRegNorm) (ARMul_State *state, ARMword instr) {
   lhs = LHS;
   rhs = DPRegRHS;
   dest = lhs - rhs;
-  ARMul_NegZero(state,dest);
   ARMul_SubFlags(state,lhs,rhs,dest);
+  ARMul_NegZero(state,dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmnpRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmnpRegNorm) {
   register ARMword dest;
   ARMword lhs,rhs;
   EMFUNC_CONDTEST
@@ -404,7 +394,7 @@ static void EMFUNCDECL26(CmnpRegNorm) (ARMul_State *state, ARMword instr) {
   ARMul_AddFlags(state,lhs,rhs,dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrRegNorm) {
   register ARMword dest;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -414,7 +404,7 @@ static void EMFUNCDECL26(OrrRegNorm) (ARMul_State *state, ARMword instr) {
   WRITEDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrsRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrsRegNorm) {
   register ARMword dest;
   ARMword rhs;
 
@@ -424,7 +414,7 @@ static void EMFUNCDECL26(OrrsRegNorm) (ARMul_State *state, ARMword instr) {
   WRITESDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MovRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovRegNorm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -432,7 +422,7 @@ static void EMFUNCDECL26(MovRegNorm) (ARMul_State *state, ARMword instr) {
   WRITEDESTNORM(dest);
 } /* EMFUNCDECL26(MovReg */
 
-static void EMFUNCDECL26(MovsRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovsRegNorm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -440,7 +430,7 @@ static void EMFUNCDECL26(MovsRegNorm) (ARMul_State *state, ARMword instr) {
   WRITESDESTNORM(dest);
 } /* EMFUNCDECL26(MovsReg */
 
-static void EMFUNCDECL26(BicRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicRegNorm) {
   register ARMword dest;
   ARMword rhs;
 
@@ -450,7 +440,7 @@ static void EMFUNCDECL26(BicRegNorm) (ARMul_State *state, ARMword instr) {
   WRITEDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(BicsRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicsRegNorm) {
   register ARMword dest;
   ARMword rhs;
 
@@ -460,7 +450,7 @@ static void EMFUNCDECL26(BicsRegNorm) (ARMul_State *state, ARMword instr) {
   WRITESDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnRegNorm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -468,7 +458,7 @@ static void EMFUNCDECL26(MvnRegNorm) (ARMul_State *state, ARMword instr) {
   WRITEDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnsRegNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnsRegNorm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -476,16 +466,11 @@ static void EMFUNCDECL26(MvnsRegNorm) (ARMul_State *state, ARMword instr) {
   WRITESDESTNORM(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TstRegMrs1SwpPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TstRegMrs1SwpPC) {
   register ARMword dest, temp;
 
   EMFUNC_CONDTEST
              if (BITS(4,11) == 9) { /* SWP */
-                if (!state->HasSWP) {
-                  ARMul_Abort(state,ARMul_UndefinedInstrV);
-                  return;
-                }
-
                 temp = LHS;
                 BUSUSEDINCPCS;
                 if (ADDREXCEPT(temp)) {
@@ -507,7 +492,7 @@ static void EMFUNCDECL26(TstRegMrs1SwpPC) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TstpRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TstpRegPC) {
   register ARMword temp;
   ARMword rhs;
 
@@ -517,7 +502,7 @@ static void EMFUNCDECL26(TstpRegPC) (ARMul_State *state, ARMword instr) {
   SETR15PSR(temp);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TeqpRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TeqpRegPC) {
   register ARMword temp;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -527,16 +512,11 @@ static void EMFUNCDECL26(TeqpRegPC) (ARMul_State *state, ARMword instr) {
   SETR15PSR(temp);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmpRegMrs2SwpPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmpRegMrs2SwpPC) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
              if (BITS(4,11) == 9) { /* SWP */
-                if (!state->HasSWP) {
-                  ARMul_Abort(state,ARMul_UndefinedInstrV);
-                  return;
-                }
-
                 temp = LHS;
                 BUSUSEDINCPCS;
                 if (ADDREXCEPT(temp)) {
@@ -553,7 +533,45 @@ static void EMFUNCDECL26(CmpRegMrs2SwpPC) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmppRegPC) (ARMul_State *state, ARMword instr) {
+/* Versions of the above for processors without SWP (ARM2), selected by the
+   decoder, see EMFUNCSWP26 */
+EMFUNCDEF26(TstRegMrs1UndNorm) {
+  EMFUNC_CONDTEST
+  if (BITS(4,11) == 9) { /* SWP */
+    ARMul_Abort(state,ARMul_UndefinedInstrV);
+    EMFUNC_RETURN;
+  }
+  EMFUNC_TAILCALL(TstRegMrs1SwpNorm);
+}
+
+EMFUNCDEF26(CmpRegMrs2UndNorm) {
+  EMFUNC_CONDTEST
+  if (BITS(4,11) == 9) { /* SWP */
+    ARMul_Abort(state,ARMul_UndefinedInstrV);
+    EMFUNC_RETURN;
+  }
+  EMFUNC_TAILCALL(CmpRegMrs2SwpNorm);
+}
+
+EMFUNCDEF26(TstRegMrs1UndPC) {
+  EMFUNC_CONDTEST
+  if (BITS(4,11) == 9) { /* SWP */
+    ARMul_Abort(state,ARMul_UndefinedInstrV);
+    EMFUNC_RETURN;
+  }
+  EMFUNC_TAILCALL(TstRegMrs1SwpPC);
+}
+
+EMFUNCDEF26(CmpRegMrs2UndPC) {
+  EMFUNC_CONDTEST
+  if (BITS(4,11) == 9) { /* SWP */
+    ARMul_Abort(state,ARMul_UndefinedInstrV);
+    EMFUNC_RETURN;
+  }
+  EMFUNC_TAILCALL(CmpRegMrs2SwpPC);
+}
+
+EMFUNCDEF26(CmppRegPC) {
   register ARMword temp;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -563,7 +581,7 @@ static void EMFUNCDECL26(CmppRegPC) (ARMul_State *state, ARMword instr) {
   SETR15PSR(temp);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmnpRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmnpRegPC) {
   register ARMword temp;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -574,7 +592,7 @@ static void EMFUNCDECL26(CmnpRegPC) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrRegPC) {
   register ARMword dest;
   ARMword rhs;
   EMFUNC_CONDTEST
@@ -584,7 +602,7 @@ static void EMFUNCDECL26(OrrRegPC) (ARMul_State *state, ARMword instr) {
   WRITEDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrsRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrsRegPC) {
   register ARMword dest;
   ARMword rhs;
 
@@ -594,7 +612,7 @@ static void EMFUNCDECL26(OrrsRegPC) (ARMul_State *state, ARMword instr) {
   WRITESDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MovRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovRegPC) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -602,7 +620,7 @@ static void EMFUNCDECL26(MovRegPC) (ARMul_State *state, ARMword instr) {
   WRITEDESTPC(dest);
 } /* EMFUNCDECL26(MovReg */
 
-static void EMFUNCDECL26(MovsRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovsRegPC) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -610,7 +628,7 @@ static void EMFUNCDECL26(MovsRegPC) (ARMul_State *state, ARMword instr) {
   WRITESDESTPC(dest);
 } /* EMFUNCDECL26(MovsReg */
 
-static void EMFUNCDECL26(BicRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicRegPC) {
   register ARMword dest;
   ARMword rhs;
 
@@ -620,7 +638,7 @@ static void EMFUNCDECL26(BicRegPC) (ARMul_State *state, ARMword instr) {
   WRITEDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(BicsRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicsRegPC) {
   register ARMword dest;
   ARMword rhs;
 
@@ -630,7 +648,7 @@ static void EMFUNCDECL26(BicsRegPC) (ARMul_State *state, ARMword instr) {
   WRITESDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnRegPC) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -638,7 +656,7 @@ static void EMFUNCDECL26(MvnRegPC) (ARMul_State *state, ARMword instr) {
   WRITEDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnsRegPC) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnsRegPC) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -646,7 +664,7 @@ static void EMFUNCDECL26(MvnsRegPC) (ARMul_State *state, ARMword instr) {
   WRITESDESTPC(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AndImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AndImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -654,7 +672,7 @@ static void EMFUNCDECL26(AndImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AndsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AndsImm) {
   register ARMword dest,rhs,temp;
 
   EMFUNC_CONDTEST
@@ -663,7 +681,7 @@ static void EMFUNCDECL26(AndsImm) (ARMul_State *state, ARMword instr) {
   WRITESDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(EorImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(EorImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -671,7 +689,7 @@ static void EMFUNCDECL26(EorImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(EorsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(EorsImm) {
   register ARMword dest,rhs,temp;
 
   EMFUNC_CONDTEST
@@ -680,7 +698,7 @@ static void EMFUNCDECL26(EorsImm) (ARMul_State *state, ARMword instr) {
   WRITESDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(SubImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SubImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -688,7 +706,7 @@ static void EMFUNCDECL26(SubImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(SubsImmNorm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SubsImmNorm) {
   register ARMword dest,rhs,lhs;
 
   EMFUNC_CONDTEST
@@ -704,7 +722,7 @@ static void EMFUNCDECL26(SubsImmNorm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-/*static void EMFUNCDECL26(SubsImmPc) (ARMul_State *state, ARMword instr) {
+/*EMFUNCDEF26(SubsImmPc) {
   register ARMword dest,rhs,lhs;
 
   EMFUNC_CONDTEST
@@ -716,7 +734,7 @@ static void EMFUNCDECL26(SubsImmNorm) (ARMul_State *state, ARMword instr) {
 
 }*/ /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(RsbImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RsbImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -724,7 +742,7 @@ static void EMFUNCDECL26(RsbImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(RsbsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RsbsImm) {
   register ARMword dest,rhs,lhs;
 
   EMFUNC_CONDTEST
@@ -736,7 +754,7 @@ static void EMFUNCDECL26(RsbsImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AddImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AddImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -744,7 +762,7 @@ static void EMFUNCDECL26(AddImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AddsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AddsImm) {
   register ARMword dest,lhs,rhs;
 
   EMFUNC_CONDTEST
@@ -756,7 +774,7 @@ static void EMFUNCDECL26(AddsImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AdcImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AdcImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -764,7 +782,7 @@ static void EMFUNCDECL26(AdcImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(AdcsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(AdcsImm) {
   register ARMword dest,lhs,rhs;
 
   EMFUNC_CONDTEST
@@ -776,7 +794,7 @@ static void EMFUNCDECL26(AdcsImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(SbcImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SbcImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -784,7 +802,7 @@ static void EMFUNCDECL26(SbcImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(SbcsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SbcsImm) {
   register ARMword dest,lhs,rhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -794,7 +812,7 @@ static void EMFUNCDECL26(SbcsImm) (ARMul_State *state, ARMword instr) {
              WRITESDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(RscImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RscImm) {
   register ARMword dest;
 
   EMFUNC_CONDTEST
@@ -802,7 +820,7 @@ static void EMFUNCDECL26(RscImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(RscsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(RscsImm) {
   register ARMword dest,lhs,rhs;
   EMFUNC_CONDTEST
 
@@ -814,7 +832,7 @@ static void EMFUNCDECL26(RscsImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TstpImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TstpImm) {
   register ARMword dest,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -830,7 +848,7 @@ static void EMFUNCDECL26(TstpImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(TeqpImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(TeqpImm) {
   register ARMword dest,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -846,7 +864,7 @@ static void EMFUNCDECL26(TeqpImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmppImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmppImm) {
   register ARMword dest,lhs,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -858,13 +876,13 @@ static void EMFUNCDECL26(CmppImm) (ARMul_State *state, ARMword instr) {
                 lhs = LHS; /* CMP immed */
                 rhs = DPImmRHS;
                 dest = lhs - rhs;
-                ARMul_NegZero(state,dest);
                 ARMul_SubFlags(state,lhs,rhs,dest);
+                ARMul_NegZero(state,dest);
                 }
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(CmnpImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CmnpImm) {
   register ARMword dest,lhs,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -882,7 +900,7 @@ static void EMFUNCDECL26(CmnpImm) (ARMul_State *state, ARMword instr) {
 
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrImm) {
   register ARMword dest;
   EMFUNC_CONDTEST
 
@@ -890,7 +908,7 @@ static void EMFUNCDECL26(OrrImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(OrrsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(OrrsImm) {
   register ARMword dest,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -899,7 +917,7 @@ static void EMFUNCDECL26(OrrsImm) (ARMul_State *state, ARMword instr) {
   WRITESDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MovImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovImm) {
   register ARMword dest;
   EMFUNC_CONDTEST
 
@@ -907,7 +925,7 @@ static void EMFUNCDECL26(MovImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MovsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MovsImm) {
   register ARMword rhs,temp;
   EMFUNC_CONDTEST
 
@@ -915,7 +933,7 @@ static void EMFUNCDECL26(MovsImm) (ARMul_State *state, ARMword instr) {
   WRITESDEST(rhs);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(BicImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicImm) {
   register ARMword dest;
   EMFUNC_CONDTEST
 
@@ -923,7 +941,7 @@ static void EMFUNCDECL26(BicImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(BicsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(BicsImm) {
   register ARMword dest,rhs,temp;
   EMFUNC_CONDTEST
 
@@ -932,7 +950,7 @@ static void EMFUNCDECL26(BicsImm) (ARMul_State *state, ARMword instr) {
   WRITESDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnImm) {
   register ARMword dest;
   EMFUNC_CONDTEST
 
@@ -940,7 +958,7 @@ static void EMFUNCDECL26(MvnImm) (ARMul_State *state, ARMword instr) {
   WRITEDEST(dest);
 } /* EMFUNCDECL26( */
 
-static void EMFUNCDECL26(MvnsImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MvnsImm) {
   register ARMword rhs,temp;
   EMFUNC_CONDTEST
 
@@ -949,7 +967,7 @@ static void EMFUNCDECL26(MvnsImm) (ARMul_State *state, ARMword instr) {
 } /* EMFUNCDECL26( */
 
 
-static void EMFUNCDECL26(StoreNoWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -957,7 +975,7 @@ static void EMFUNCDECL26(StoreNoWritePostDecImm) (ARMul_State *state, ARMword in
                 LSBase = lhs - LSImmRHS;
 }
 
-static void EMFUNCDECL26(LoadNoWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -965,7 +983,7 @@ static void EMFUNCDECL26(LoadNoWritePostDecImm) (ARMul_State *state, ARMword ins
                 LSBase = lhs - LSImmRHS;
 }
 
-static void EMFUNCDECL26(StoreWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePostDecImm) {
   register ARMword lhs,temp;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -976,7 +994,7 @@ static void EMFUNCDECL26(StoreWritePostDecImm) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -986,7 +1004,7 @@ static void EMFUNCDECL26(LoadWritePostDecImm) (ARMul_State *state, ARMword instr
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -994,7 +1012,7 @@ static void EMFUNCDECL26(StoreBNoWritePostDecImm) (ARMul_State *state, ARMword i
                 LSBase = lhs - LSImmRHS;
 }
 
-static void EMFUNCDECL26(LoadBNoWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1002,7 +1020,7 @@ static void EMFUNCDECL26(LoadBNoWritePostDecImm) (ARMul_State *state, ARMword in
                 LSBase = lhs - LSImmRHS;
 }
 
-static void EMFUNCDECL26(StoreBWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1012,7 +1030,7 @@ static void EMFUNCDECL26(StoreBWritePostDecImm) (ARMul_State *state, ARMword ins
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadBWritePostDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePostDecImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1022,7 +1040,7 @@ static void EMFUNCDECL26(LoadBWritePostDecImm) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreNoWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1030,7 +1048,7 @@ static void EMFUNCDECL26(StoreNoWritePostIncImm) (ARMul_State *state, ARMword in
                 LSBase = lhs + LSImmRHS;
 }
 
-static void EMFUNCDECL26(LoadNoWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1038,7 +1056,7 @@ static void EMFUNCDECL26(LoadNoWritePostIncImm) (ARMul_State *state, ARMword ins
                 LSBase = lhs + LSImmRHS;
 }
 
-static void EMFUNCDECL26(StoreWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1048,7 +1066,7 @@ static void EMFUNCDECL26(StoreWritePostIncImm) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1058,7 +1076,7 @@ static void EMFUNCDECL26(LoadWritePostIncImm) (ARMul_State *state, ARMword instr
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1066,7 +1084,7 @@ static void EMFUNCDECL26(StoreBNoWritePostIncImm) (ARMul_State *state, ARMword i
                 LSBase = lhs + LSImmRHS;
 }
 
-static void EMFUNCDECL26(LoadBNoWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1074,7 +1092,7 @@ static void EMFUNCDECL26(LoadBNoWritePostIncImm) (ARMul_State *state, ARMword in
                 LSBase = lhs + LSImmRHS;
 }
 
-static void EMFUNCDECL26(StoreBWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1084,7 +1102,7 @@ static void EMFUNCDECL26(StoreBWritePostIncImm) (ARMul_State *state, ARMword ins
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadBWritePostIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePostIncImm) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1095,17 +1113,17 @@ static void EMFUNCDECL26(LoadBWritePostIncImm) (ARMul_State *state, ARMword inst
 }
 
 
-static void EMFUNCDECL26(StoreNoWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePreDecImm) {
   EMFUNC_CONDTEST
              (void)StoreWord(state,instr,LHS - LSImmRHS);
 }
 
-static void EMFUNCDECL26(LoadNoWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePreDecImm) {
   EMFUNC_CONDTEST
              (void)LoadWord(state,instr,LHS - LSImmRHS);
 }
 
-static void EMFUNCDECL26(StoreWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePreDecImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSImmRHS;
@@ -1113,7 +1131,7 @@ static void EMFUNCDECL26(StoreWritePreDecImm) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePreDecImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSImmRHS;
@@ -1121,17 +1139,17 @@ static void EMFUNCDECL26(LoadWritePreDecImm) (ARMul_State *state, ARMword instr)
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePreDecImm) {
   EMFUNC_CONDTEST
              (void)StoreByte(state,instr,LHS - LSImmRHS);
 }
 
-static void EMFUNCDECL26(LoadBNoWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePreDecImm) {
   EMFUNC_CONDTEST
              (void)LoadByte(state,instr,LHS - LSImmRHS);
 }
 
-static void EMFUNCDECL26(StoreBWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePreDecImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSImmRHS;
@@ -1139,7 +1157,7 @@ static void EMFUNCDECL26(StoreBWritePreDecImm) (ARMul_State *state, ARMword inst
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadBWritePreDecImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePreDecImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSImmRHS;
@@ -1147,17 +1165,17 @@ static void EMFUNCDECL26(LoadBWritePreDecImm) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreNoWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePreIncImm) {
   EMFUNC_CONDTEST
              (void)StoreWord(state,instr,LHS + LSImmRHS);
 }
 
-static void EMFUNCDECL26(LoadNoWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePreIncImm) {
   EMFUNC_CONDTEST
              (void)LoadWord(state,instr,LHS + LSImmRHS);
 }
 
-static void EMFUNCDECL26(StoreWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePreIncImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSImmRHS;
@@ -1165,7 +1183,7 @@ static void EMFUNCDECL26(StoreWritePreIncImm) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePreIncImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSImmRHS;
@@ -1173,17 +1191,17 @@ static void EMFUNCDECL26(LoadWritePreIncImm) (ARMul_State *state, ARMword instr)
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePreIncImm) {
   EMFUNC_CONDTEST
              (void)StoreByte(state,instr,LHS + LSImmRHS);
 }
 
-static void EMFUNCDECL26(LoadBNoWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePreIncImm) {
   EMFUNC_CONDTEST
              (void)LoadByte(state,instr,LHS + LSImmRHS);
 }
 
-static void EMFUNCDECL26(StoreBWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePreIncImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSImmRHS;
@@ -1191,7 +1209,7 @@ static void EMFUNCDECL26(StoreBWritePreIncImm) (ARMul_State *state, ARMword inst
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadBWritePreIncImm) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePreIncImm) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSImmRHS;
@@ -1200,7 +1218,7 @@ static void EMFUNCDECL26(LoadBWritePreIncImm) (ARMul_State *state, ARMword instr
 }
 
 
-static void EMFUNCDECL26(StoreNoWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1208,7 +1226,7 @@ static void EMFUNCDECL26(StoreNoWritePostDecReg) (ARMul_State *state, ARMword in
                 LSBase = lhs - LSRegRHS;
 }
 
-static void EMFUNCDECL26(LoadNoWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1216,7 +1234,7 @@ static void EMFUNCDECL26(LoadNoWritePostDecReg) (ARMul_State *state, ARMword ins
                 LSBase = lhs - LSRegRHS;
 }
 
-static void EMFUNCDECL26(StoreWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1226,7 +1244,7 @@ static void EMFUNCDECL26(StoreWritePostDecReg) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1236,7 +1254,7 @@ static void EMFUNCDECL26(LoadWritePostDecReg) (ARMul_State *state, ARMword instr
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1244,7 +1262,7 @@ static void EMFUNCDECL26(StoreBNoWritePostDecReg) (ARMul_State *state, ARMword i
                 LSBase = lhs - LSRegRHS;
 }
 
-static void EMFUNCDECL26(LoadBNoWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1252,7 +1270,7 @@ static void EMFUNCDECL26(LoadBNoWritePostDecReg) (ARMul_State *state, ARMword in
                 LSBase = lhs - LSRegRHS;
 }
 
-static void EMFUNCDECL26(StoreBWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1262,7 +1280,7 @@ static void EMFUNCDECL26(StoreBWritePostDecReg) (ARMul_State *state, ARMword ins
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadBWritePostDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePostDecReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1272,7 +1290,7 @@ static void EMFUNCDECL26(LoadBWritePostDecReg) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreNoWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1280,7 +1298,7 @@ static void EMFUNCDECL26(StoreNoWritePostIncReg) (ARMul_State *state, ARMword in
                 LSBase = lhs + LSRegRHS;
 }
 
-static void EMFUNCDECL26(LoadNoWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1288,7 +1306,7 @@ static void EMFUNCDECL26(LoadNoWritePostIncReg) (ARMul_State *state, ARMword ins
                 LSBase = lhs + LSRegRHS;
 }
 
-static void EMFUNCDECL26(StoreWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1298,7 +1316,7 @@ static void EMFUNCDECL26(StoreWritePostIncReg) (ARMul_State *state, ARMword inst
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1308,7 +1326,7 @@ static void EMFUNCDECL26(LoadWritePostIncReg) (ARMul_State *state, ARMword instr
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1316,7 +1334,7 @@ static void EMFUNCDECL26(StoreBNoWritePostIncReg) (ARMul_State *state, ARMword i
                 LSBase = lhs + LSRegRHS;
 }
 
-static void EMFUNCDECL26(LoadBNoWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1324,7 +1342,7 @@ static void EMFUNCDECL26(LoadBNoWritePostIncReg) (ARMul_State *state, ARMword in
                 LSBase = lhs + LSRegRHS;
 }
 
-static void EMFUNCDECL26(StoreBWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1334,7 +1352,7 @@ static void EMFUNCDECL26(StoreBWritePostIncReg) (ARMul_State *state, ARMword ins
              state->NtransSig = (R15MODE)?HIGH:LOW;
 }
 
-static void EMFUNCDECL26(LoadBWritePostIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePostIncReg) {
   register ARMword lhs;
   EMFUNC_CONDTEST
              lhs = LHS;
@@ -1345,17 +1363,17 @@ static void EMFUNCDECL26(LoadBWritePostIncReg) (ARMul_State *state, ARMword inst
 }
 
 
-static void EMFUNCDECL26(StoreNoWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePreDecReg) {
   EMFUNC_CONDTEST
              (void)StoreWord(state,instr,LHS - LSRegRHS);
 }
 
-static void EMFUNCDECL26(LoadNoWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePreDecReg) {
   EMFUNC_CONDTEST
              (void)LoadWord(state,instr,LHS - LSRegRHS);
 }
 
-static void EMFUNCDECL26(StoreWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePreDecReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSRegRHS;
@@ -1363,7 +1381,7 @@ static void EMFUNCDECL26(StoreWritePreDecReg) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePreDecReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSRegRHS;
@@ -1371,17 +1389,17 @@ static void EMFUNCDECL26(LoadWritePreDecReg) (ARMul_State *state, ARMword instr)
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePreDecReg) {
   EMFUNC_CONDTEST
              (void)StoreByte(state,instr,LHS - LSRegRHS);
 }
 
-static void EMFUNCDECL26(LoadBNoWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePreDecReg) {
   EMFUNC_CONDTEST
              (void)LoadByte(state,instr,LHS - LSRegRHS);
 }
 
-static void EMFUNCDECL26(StoreBWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePreDecReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSRegRHS;
@@ -1389,7 +1407,7 @@ static void EMFUNCDECL26(StoreBWritePreDecReg) (ARMul_State *state, ARMword inst
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadBWritePreDecReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePreDecReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS - LSRegRHS;
@@ -1397,17 +1415,17 @@ static void EMFUNCDECL26(LoadBWritePreDecReg) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreNoWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreNoWritePreIncReg) {
   EMFUNC_CONDTEST
              (void)StoreWord(state,instr,LHS + LSRegRHS);
 }
 
-static void EMFUNCDECL26(LoadNoWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadNoWritePreIncReg) {
   EMFUNC_CONDTEST
              (void)LoadWord(state,instr,LHS + LSRegRHS);
 }
 
-static void EMFUNCDECL26(StoreWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreWritePreIncReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSRegRHS;
@@ -1415,7 +1433,7 @@ static void EMFUNCDECL26(StoreWritePreIncReg) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadWritePreIncReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSRegRHS;
@@ -1423,17 +1441,17 @@ static void EMFUNCDECL26(LoadWritePreIncReg) (ARMul_State *state, ARMword instr)
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(StoreBNoWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBNoWritePreIncReg) {
   EMFUNC_CONDTEST
              (void)StoreByte(state,instr,LHS + LSRegRHS);
 }
 
-static void EMFUNCDECL26(LoadBNoWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBNoWritePreIncReg) {
   EMFUNC_CONDTEST
              (void)LoadByte(state,instr,LHS + LSRegRHS);
 }
 
-static void EMFUNCDECL26(StoreBWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(StoreBWritePreIncReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSRegRHS;
@@ -1441,7 +1459,7 @@ static void EMFUNCDECL26(StoreBWritePreIncReg) (ARMul_State *state, ARMword inst
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(LoadBWritePreIncReg) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(LoadBWritePreIncReg) {
   register ARMword temp;
   EMFUNC_CONDTEST
              temp = LHS + LSRegRHS;
@@ -1449,33 +1467,33 @@ static void EMFUNCDECL26(LoadBWritePreIncReg) (ARMul_State *state, ARMword instr
                 LSBase = temp;
 }
 
-static void EMFUNCDECL26(Undef) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Undef) {
   UNUSED_VAR(instr);
   EMFUNC_CONDTEST
   ARMul_Abort(state,ARMul_UndefinedInstrV);
 }
 
-static void EMFUNCDECL26(MultiStorePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStorePostDec) {
   EMFUNC_CONDTEST
 
   STOREMULT(instr,LSBase - LSMNumRegs + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadPostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadPostDec) {
   EMFUNC_CONDTEST
 
   LOADMULT(instr,LSBase - LSMNumRegs + 4L,0L);
   
 }
 
-static void EMFUNCDECL26(MultiStoreWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWritePostDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
   temp = LSBase - LSMNumRegs;
   STOREMULT(instr,temp + 4L,temp);}
 
-static void EMFUNCDECL26(MultiLoadWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWritePostDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1484,19 +1502,19 @@ static void EMFUNCDECL26(MultiLoadWritePostDec) (ARMul_State *state, ARMword ins
 
 }
 
-static void EMFUNCDECL26(MultiStoreFlagsPostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreFlagsPostDec) {
   EMFUNC_CONDTEST
 
   STORESMULT(instr,LSBase - LSMNumRegs + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadFlagsPostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadFlagsPostDec) {
   EMFUNC_CONDTEST
 
   LOADSMULT(instr,LSBase - LSMNumRegs + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWriteFlagsPostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWriteFlagsPostDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1504,7 +1522,7 @@ static void EMFUNCDECL26(MultiStoreWriteFlagsPostDec) (ARMul_State *state, ARMwo
   STORESMULT(instr,temp + 4L,temp);
 }
 
-static void EMFUNCDECL26(MultiLoadWriteFlagsPostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWriteFlagsPostDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1512,19 +1530,19 @@ static void EMFUNCDECL26(MultiLoadWriteFlagsPostDec) (ARMul_State *state, ARMwor
   LOADSMULT(instr,temp + 4L,temp);
 }
 
-static void EMFUNCDECL26(MultiStorePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStorePostInc) {
   EMFUNC_CONDTEST
 
   STOREMULT(instr,LSBase,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadPostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadPostInc) {
   EMFUNC_CONDTEST
 
   LOADMULT(instr,LSBase,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWritePostInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1532,7 +1550,7 @@ static void EMFUNCDECL26(MultiStoreWritePostInc) (ARMul_State *state, ARMword in
   STOREMULT(instr,temp,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiLoadWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWritePostInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1540,19 +1558,19 @@ static void EMFUNCDECL26(MultiLoadWritePostInc) (ARMul_State *state, ARMword ins
   LOADMULT(instr,temp,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiStoreFlagsPostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreFlagsPostInc) {
   EMFUNC_CONDTEST
 
   STORESMULT(instr,LSBase,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadFlagsPostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadFlagsPostInc) {
   EMFUNC_CONDTEST
 
   LOADSMULT(instr,LSBase,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWriteFlagsPostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWriteFlagsPostInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1560,7 +1578,7 @@ static void EMFUNCDECL26(MultiStoreWriteFlagsPostInc) (ARMul_State *state, ARMwo
   STORESMULT(instr,temp,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiLoadWriteFlagsPostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWriteFlagsPostInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1568,19 +1586,19 @@ static void EMFUNCDECL26(MultiLoadWriteFlagsPostInc) (ARMul_State *state, ARMwor
   LOADSMULT(instr,temp,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiStorePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStorePreDec) {
   EMFUNC_CONDTEST
 
   STOREMULT(instr,LSBase - LSMNumRegs,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadPreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadPreDec) {
   EMFUNC_CONDTEST
 
   LOADMULT(instr,LSBase - LSMNumRegs,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWritePreDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1588,7 +1606,7 @@ static void EMFUNCDECL26(MultiStoreWritePreDec) (ARMul_State *state, ARMword ins
   STOREMULT(instr,temp,temp);
 }
 
-static void EMFUNCDECL26(MultiLoadWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWritePreDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1596,20 +1614,20 @@ static void EMFUNCDECL26(MultiLoadWritePreDec) (ARMul_State *state, ARMword inst
   LOADMULT(instr,temp,temp);
 }
 
-static void EMFUNCDECL26(MultiStoreFlagsPreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreFlagsPreDec) {
   EMFUNC_CONDTEST
 
   STORESMULT(instr,LSBase - LSMNumRegs,0L);
   
 }
 
-static void EMFUNCDECL26(MultiLoadFlagsPreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadFlagsPreDec) {
   EMFUNC_CONDTEST
 
   LOADSMULT(instr,LSBase - LSMNumRegs,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWriteFlagsPreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWriteFlagsPreDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1617,7 +1635,7 @@ static void EMFUNCDECL26(MultiStoreWriteFlagsPreDec) (ARMul_State *state, ARMwor
   STORESMULT(instr,temp,temp);
 }
 
-static void EMFUNCDECL26(MultiLoadWriteFlagsPreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWriteFlagsPreDec) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1625,19 +1643,19 @@ static void EMFUNCDECL26(MultiLoadWriteFlagsPreDec) (ARMul_State *state, ARMword
   LOADSMULT(instr,temp,temp);
 }
 
-static void EMFUNCDECL26(MultiStorePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStorePreInc) {
   EMFUNC_CONDTEST
 
   STOREMULT(instr,LSBase + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadPreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadPreInc) {
   EMFUNC_CONDTEST
 
   LOADMULT(instr,LSBase + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWritePreInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1645,7 +1663,7 @@ static void EMFUNCDECL26(MultiStoreWritePreInc) (ARMul_State *state, ARMword ins
   STOREMULT(instr,temp + 4L,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiLoadWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWritePreInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1653,19 +1671,19 @@ static void EMFUNCDECL26(MultiLoadWritePreInc) (ARMul_State *state, ARMword inst
   LOADMULT(instr,temp + 4L,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiStoreFlagsPreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreFlagsPreInc) {
   EMFUNC_CONDTEST
 
   STORESMULT(instr,LSBase + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiLoadFlagsPreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadFlagsPreInc) {
   EMFUNC_CONDTEST
 
   LOADSMULT(instr,LSBase + 4L,0L);
 }
 
-static void EMFUNCDECL26(MultiStoreWriteFlagsPreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiStoreWriteFlagsPreInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1673,7 +1691,7 @@ static void EMFUNCDECL26(MultiStoreWriteFlagsPreInc) (ARMul_State *state, ARMwor
   STORESMULT(instr,temp + 4L,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(MultiLoadWriteFlagsPreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(MultiLoadWriteFlagsPreInc) {
   register ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1681,7 +1699,7 @@ static void EMFUNCDECL26(MultiLoadWriteFlagsPreInc) (ARMul_State *state, ARMword
   LOADSMULT(instr,temp + 4L,temp + LSMNumRegs);
 }
 
-static void EMFUNCDECL26(CoLoadWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadWritePostDec) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1690,20 +1708,20 @@ static void EMFUNCDECL26(CoLoadWritePostDec) (ARMul_State *state, ARMword instr)
   ARMul_LDC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoStoreNoWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreNoWritePostDec) {
   EMFUNC_CONDTEST
 
   ARMul_STC(state,instr,LHS);
 
 }
 
-static void EMFUNCDECL26(CoLoadNoWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadNoWritePostDec) {
   EMFUNC_CONDTEST
 
   ARMul_LDC(state,instr,LHS);
 }
 
-static void EMFUNCDECL26(CoStoreWritePostDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreWritePostDec) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1712,19 +1730,19 @@ static void EMFUNCDECL26(CoStoreWritePostDec) (ARMul_State *state, ARMword instr
   ARMul_STC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoStoreNoWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreNoWritePostInc) {
   EMFUNC_CONDTEST
 
   ARMul_STC(state,instr,LHS);
 }
 
-static void EMFUNCDECL26(CoLoadNoWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadNoWritePostInc) {
   EMFUNC_CONDTEST
 
   ARMul_LDC(state,instr,LHS);
 }
 
-static void EMFUNCDECL26(CoStoreWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreWritePostInc) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1733,7 +1751,7 @@ static void EMFUNCDECL26(CoStoreWritePostInc) (ARMul_State *state, ARMword instr
   ARMul_STC(state,instr,LHS);
 }
 
-static void EMFUNCDECL26(CoLoadWritePostInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadWritePostInc) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1742,19 +1760,19 @@ static void EMFUNCDECL26(CoLoadWritePostInc) (ARMul_State *state, ARMword instr)
   ARMul_LDC(state,instr,LHS);
 }
 
-static void EMFUNCDECL26(CoStoreNoWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreNoWritePreDec) {
   EMFUNC_CONDTEST
 
   ARMul_STC(state,instr,LHS - LSCOff);
 }
 
-static void EMFUNCDECL26(CoLoadNoWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadNoWritePreDec) {
   EMFUNC_CONDTEST
 
   ARMul_LDC(state,instr,LHS - LSCOff);
 }
 
-static void EMFUNCDECL26(CoStoreWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreWritePreDec) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1763,7 +1781,7 @@ static void EMFUNCDECL26(CoStoreWritePreDec) (ARMul_State *state, ARMword instr)
   ARMul_STC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoLoadWritePreDec) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadWritePreDec) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1772,20 +1790,20 @@ static void EMFUNCDECL26(CoLoadWritePreDec) (ARMul_State *state, ARMword instr)
   ARMul_LDC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoStoreNoWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreNoWritePreInc) {
   EMFUNC_CONDTEST
 
   ARMul_STC(state,instr,LHS + LSCOff);
 
 }
 
-static void EMFUNCDECL26(CoLoadNoWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadNoWritePreInc) {
   EMFUNC_CONDTEST
 
   ARMul_LDC(state,instr,LHS + LSCOff);
 }
 
-static void EMFUNCDECL26(CoStoreWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoStoreWritePreInc) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1794,7 +1812,7 @@ static void EMFUNCDECL26(CoStoreWritePreInc) (ARMul_State *state, ARMword instr)
   ARMul_STC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoLoadWritePreInc) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoLoadWritePreInc) {
   register ARMword lhs;
   EMFUNC_CONDTEST
 
@@ -1803,7 +1821,7 @@ static void EMFUNCDECL26(CoLoadWritePreInc) (ARMul_State *state, ARMword instr)
   ARMul_LDC(state,instr,lhs);
 }
 
-static void EMFUNCDECL26(CoMCRDataOp) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoMCRDataOp) {
   EMFUNC_CONDTEST
              if (BIT(4)) { /* MCR */
                 if (DESTReg == 15) {
@@ -1817,7 +1835,7 @@ static void EMFUNCDECL26(CoMCRDataOp) (ARMul_State *state, ARMword instr) {
                 ARMul_CDP(state,instr);
 }
 
-static void EMFUNCDECL26(CoMRCDataOp) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(CoMRCDataOp) {
   ARMword temp;
   EMFUNC_CONDTEST
 
@@ -1834,17 +1852,17 @@ static void EMFUNCDECL26(CoMRCDataOp) (ARMul_State *state, ARMword instr) {
                 ARMul_CDP(state,instr);
 }
 
-static void EMFUNCDECL26(SWI) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(SWI) {
   EMFUNC_CONDTEST
              if (instr == ARMul_ABORTWORD && state->AbortAddr == ((state->Reg[15]-8) & R15PCBITS)) { /* a prefetch abort */
                 ARMul_Abort(state,ARMul_PrefetchAbortV);
-                return;
+                EMFUNC_RETURN;
                 }
 
                 ARMul_Abort(state,ARMul_SWIV);
 }
 
-static void EMFUNCDECL26(Noop) (ARMul_State *state, ARMword instr) {
+EMFUNCDEF26(Noop) {
   UNUSED_VAR(state);
   UNUSED_VAR(instr);
 }
@@ -23,11 +23,10 @@
 #include "arch/ControlPane.h"
 #include "arch/dbugsys.h"
 #include "arch/fastmap.h"
+#include "arch/rowkernels.h"
 #include "eventq.h"
 #include "hostfs.h"
 
-FastMapEntry FastMap[FASTMAP_SIZE];
-
 /***************************************************************************\
 *                 Definitions for the emulator architecture                 *
 \***************************************************************************/
@@ -46,11 +45,83 @@ uint_least16_t ARMul_CCTable[16];
 
 /***************************************************************************\
 *         Call this routine once to set up the emulator's tables.           *
+*  The tables are shared by all machines. It's safe to call it from        *
+*  several threads at once; any callers which arrive while the tables are  *
+*  being built wait for them to be finished.                               *
 \***************************************************************************/
 
+#define EMULATEINIT_NONE     0
+#define EMULATEINIT_BUILDING 1
+#define EMULATEINIT_DONE     2
+
+#if defined(__GNUC__)
+static int EmulateInitStage = EMULATEINIT_NONE;
+
+static inline int EmulateInit_Stage(void)
+{
+  return __atomic_load_n(&EmulateInitStage,__ATOMIC_ACQUIRE);
+}
+
+static inline bool EmulateInit_Claim(void)
+{
+  int expected = EMULATEINIT_NONE;
+  return __atomic_compare_exchange_n(&EmulateInitStage,&expected,EMULATEINIT_BUILDING,false,__ATOMIC_ACQUIRE,__ATOMIC_ACQUIRE);
+}
+
+static inline void EmulateInit_Done(void)
+{
+  __atomic_store_n(&EmulateInitStage,EMULATEINIT_DONE,__ATOMIC_RELEASE);
+}
+#elif defined(_MSC_VER)
+#include <intrin.h>
+static volatile long EmulateInitStage = EMULATEINIT_NONE;
+
+static inline int EmulateInit_Stage(void)
+{
+  return EmulateInitStage;
+}
+
+static inline bool EmulateInit_Claim(void)
+{
+  return _InterlockedCompareExchange(&EmulateInitStage,EMULATEINIT_BUILDING,EMULATEINIT_NONE) == EMULATEINIT_NONE;
+}
+
+static inline void EmulateInit_Done(void)
+{
+  _InterlockedExchange(&EmulateInitStage,EMULATEINIT_DONE);
+}
+#else
+/* No atomics available, so machines must only be created on one thread */
+static int EmulateInitStage = EMULATEINIT_NONE;
+
+static inline int EmulateInit_Stage(void)
+{
+  return EmulateInitStage;
+}
+
+static inline bool EmulateInit_Claim(void)
+{
+  EmulateInitStage = EMULATEINIT_BUILDING;
+  return true;
+}
+
+static inline void EmulateInit_Done(void)
+{
+  EmulateInitStage = EMULATEINIT_DONE;
+}
+#endif
+
 void ARMul_EmulateInit(void) {
   unsigned int i, j;
 
+  if (EmulateInit_Stage() == EMULATEINIT_DONE)
+    return;
+  if (!EmulateInit_Claim()) {
+    /* Another thread is building the tables */
+    while (EmulateInit_Stage() != EMULATEINIT_DONE) {}
+    return;
+  }
+
 #ifdef ARMUL_USE_IMMEDTABLE
   for (i = 0; i < 4096; i++) { /* the values of 12 bit dp rhs's */
     ARMul_ImmedTable[i] = ROTATER(i & 0xffL,(i >> 7L) & 0x1eL);
@@ -92,6 +163,15 @@ void ARMul_EmulateInit(void) {
 #undef Z
 #undef N
 #undef COMPUTE
+
+#ifdef ARMUL_INSTR_FUNC_INDEX
+  ARMul_EmuFuncTableInit();
+#endif
+
+  RowKernels_Init();
+
+  /* Only now can other threads use the tables */
+  EmulateInit_Done();
 }
 
 
@@ -118,22 +198,25 @@ ARMul_State *ARMul_NewState(ArcemConfig *pConfig)
     }
 
  state->Aborted = ARMul_ResetV;
+ state->NumInstrs = 0;
+ state->EventDispatches = 0;
  state->Display = NULL;
- state->FastMap = FastMap;
+ state->DisplayUseUpdateFlags = true;
  state->Config  = pConfig;
+ state->EmuRate = 1000000; /* Start with safe value of 1MHz */
 
  switch (CONFIG.eProcessor) {
  case Processor_ARM2:
-     state->HasSWP  = false;
+     ARMul_EmulateSetModel(state, false);
      state->HasCP15 = false;
      break;
  case Processor_ARM250:
-     state->HasSWP  = true;
+     ARMul_EmulateSetModel(state, true);
      state->HasCP15 = false;
      break;
  case Processor_ARM3:
  default:
-     state->HasSWP  = true;
+     ARMul_EmulateSetModel(state, true);
      state->HasCP15 = true;
      break;
  }
@@ -145,6 +228,9 @@ ARMul_State *ARMul_NewState(ArcemConfig *pConfig)
     ARMul_FreeState(state);
     return false;
  }
+#ifdef ARMUL_IDLE_DETECT
+ state->IdleDetect = CONFIG.bIdleDetect;
+#endif
 #ifdef ARMUL_COPRO_SUPPORT
  if (!ARMul_CoProInit(state)) {
     ARMul_FreeState(state);
@@ -181,6 +267,7 @@ void ARMul_FreeState(ARMul_State *state)
 
 void ARMul_Reset(ARMul_State *state)
 {state->NextInstr = 0;
+    ARMul_DiscardFlags(state);
     state->Reg[15] = R15INTBITS | SVC26MODE;
  ARMul_R15Altered(state);
  state->Bank = SVCBANK;
@@ -192,16 +279,29 @@ void ARMul_Reset(ARMul_State *state)
  state->AbortAddr = 1;
 
  state->NumCycles = 0;
+ ARMul_ForceEventCheck(state);
 }
 
 void ARMul_Exit(ARMul_State *state, uint_least8_t exit_code) {
   state->ExitCode = exit_code;
+  ARMul_Stop(state, ARMul_Stop_Exit);
+}
+
+/***************************************************************************\
+* Make ARMul_DoProg return before the next instruction. It can be called    *
+* again afterwards to carry on from where it left off.                      *
+\***************************************************************************/
+
+void ARMul_Stop(ARMul_State *state, uint_least8_t reason) {
+  state->StopReason |= reason;
   state->KillEmulator = true;
+  /* Make sure the main loop notices promptly */
+  ARMul_ForceEventCheck(state);
 }
 
 int ARMul_DoProg(ARMul_State *state) {
+  state->StopReason = 0;
   ARMul_Emulate26(state);
-  state->Reg[15] -= 8; /* undo the pipeline (bogus?) */
 
   return(state->ExitCode);
 }
@@ -216,6 +316,9 @@ void ARMul_Abort(ARMul_State *state, ARMword vector) {
   ARMword temp;
   state->Aborted = ARMul_ResetV;
 
+  /* R14 gets a copy of the flags */
+  ARMul_FlushFlags(state);
+
   dbug("ARMul_Abort: vector=0x%"PRIx32"\n",vector);
 
   temp = state->Reg[15];
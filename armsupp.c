@@ -66,6 +66,7 @@ ARMword ARMul_GetNextPC(ARMul_State *state)
 
 void ARMul_SetPC(ARMul_State *state, ARMword value)
 {
+  ARMul_FlushFlags(state);
   state->Reg[15] = R15CCINTMODE | (value & R15PCBITS);
  FLUSHPIPE;
 }
@@ -76,6 +77,7 @@ void ARMul_SetPC(ARMul_State *state, ARMword value)
 
 ARMword ARMul_GetR15(ARMul_State *state)
 {
+    ARMul_FlushFlags(state);
     return state->Reg[15];
 }
 
@@ -85,6 +87,7 @@ ARMword ARMul_GetR15(ARMul_State *state)
 
 void ARMul_SetR15(ARMul_State *state, ARMword value)
 {
+  ARMul_DiscardFlags(state);
   state->Reg[15] = value;
   ARMul_R15Altered(state);
  FLUSHPIPE;
@@ -99,10 +102,17 @@ void ARMul_SetR15(ARMul_State *state, ARMword value)
 void ARMul_R15Altered(ARMul_State *state)
 {
  register ARMword mode = R15MODE;
+ /* IF bits may have changed */
+ ARMul_ForceEventCheck(state);
  if (state->Bank != mode) {
+    bool ntrans = (mode != USER26MODE);
     ARMul_SwitchMode(state,state->Bank,mode);
-    state->NtransSig = (mode)?HIGH:LOW;
-    FastMap_RebuildMapMode(state);
+    /* The memory map only depends on whether we're privileged, so switching
+       between IRQ/SVC/FIQ (e.g. an IRQ taken in SVC mode) can leave it alone */
+    if (state->NtransSig != ntrans) {
+       state->NtransSig = ntrans;
+       FastMap_RebuildMapMode(state);
+       }
     }
 }
 
@@ -117,6 +127,7 @@ void ARMul_R15Altered(ARMul_State *state)
 ARMword ARMul_SwitchMode(ARMul_State *state,ARMword oldmode, ARMword newmode)
 {unsigned i;
 
+ ARMul_FlushFlags(state);
  oldmode = ModeToBank(oldmode);
  state->Bank = ModeToBank(newmode);
  if (oldmode != state->Bank) { /* really need to do it */
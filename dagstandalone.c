@@ -23,8 +23,10 @@
 #include <stdlib.h>
 
 #include "dagstandalone.h"
+#include "arcem.h"
 #include "armdefs.h"
 #include "arch/ArcemConfig.h"
+#include "arch/bench.h"
 
 static ArcemConfig hArcemConfig;
 
@@ -38,7 +40,7 @@ static ArcemConfig hArcemConfig;
  */
 int dagstandalone(int argc, char *argv[]) {
   ArcemConfig_Result result = Result_Continue;
-  ARMul_State *state = NULL;
+  ArcemMachine *machine = NULL;
   int exit_code;
 
   /* Setup the default values for the config system */
@@ -59,19 +61,21 @@ int dagstandalone(int argc, char *argv[]) {
     return (result == Result_Success ? EXIT_SUCCESS : EXIT_FAILURE);
   }
 
-  /* Initialise */
-  state = ARMul_NewState(&hArcemConfig);
-  if (!state) {
-    ArcemConfig_Free(&hArcemConfig);
+  /* Initialise (the machine takes over the config) */
+  machine = Arcem_CreateFromConfig(&hArcemConfig);
+  if (!machine) {
     return EXIT_FAILURE;
   }
 
-  /* Execute */
-  exit_code = ARMul_DoProg(state);
+  /* Execute until the guest exits */
+  Arcem_Run(machine, 0, 0);
+  exit_code = Arcem_ExitCode(machine);
+
+  /* Report benchmark results, if requested */
+  Bench_Report(Arcem_GetState(machine),stdout);
 
   /* Finalise */
-  ARMul_FreeState(state);
-  ArcemConfig_Free(&hArcemConfig);
+  Arcem_Destroy(machine);
 
   return exit_code;
 }
@@ -24,6 +24,24 @@
 /* Initialise the queue */
 extern void EventQ_Init(ARMul_State *state);
 
+/* Make sure the main loop notices an event scheduled for the given time */
+static inline void EventQ_UpdateDeadline(ARMul_State *state,CycleCount eventtime)
+{
+#ifdef ARMUL_EVENT_DEADLINE
+	if(((CycleDiff) (eventtime-state->Deadline)) < 0)
+	{
+		state->Deadline = eventtime;
+#ifdef ARMUL_BLOCK_CACHE
+		/* Make the block loops notice the new deadline */
+		state->BlockCur = NULL;
+#endif
+	}
+#else
+	UNUSED_VAR(state);
+	UNUSED_VAR(eventtime);
+#endif
+}
+
 /* Remove an entry with a certain index */
 static inline void EventQ_Remove(ARMul_State *state,int idx)
 {
@@ -53,6 +71,7 @@ static inline int EventQ_Reschedule(ARMul_State *state,CycleCount eventtime,Even
 	}
 	state->EventQ[idx].Time = eventtime;
 	state->EventQ[idx].Func = func;
+	EventQ_UpdateDeadline(state,eventtime);
 	return idx;
 }
 
@@ -74,6 +93,7 @@ static inline int EventQ_Insert(ARMul_State *state,CycleCount eventtime,EventQ_F
 	}
 	state->EventQ[idx].Time = eventtime;
 	state->EventQ[idx].Func = func;
+	EventQ_UpdateDeadline(state,eventtime);
 	return idx;
 }
 
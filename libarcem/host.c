@@ -0,0 +1,74 @@
+/*
+  libarcem/host.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Host support for libarcem. There's no display, sound or input; machines
+  always use the null display device, and are driven through arcem.h.
+  Messages go to stdout/stderr, and application data files (e.g. hexcmos)
+  are looked for in the current directory.
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../armdefs.h"
+#include "../arch/ControlPane.h"
+#include "../arch/dbugsys.h"
+#include "../arch/displaydev.h"
+#include "../arch/filecalls.h"
+#include "../arch/keyboard.h"
+
+bool ControlPane_Init(ARMul_State *state)
+{
+  UNUSED_VAR(state);
+  return true;
+}
+
+void ControlPane_Error(bool fatal,const char *fmt,...)
+{
+  va_list args;
+
+  /* Log it */
+  va_start(args,fmt);
+  log_msgv(LOG_ERROR,fmt,args);
+  va_end(args);
+  log_msg(LOG_ERROR,"\n");
+
+  /* Quit */
+  if (fatal)
+    exit(EXIT_FAILURE);
+}
+
+void log_msgv(int type, const char *format, va_list ap)
+{
+  if (type >= LOG_WARN)
+    vfprintf(stderr, format, ap);
+  else
+    vfprintf(stdout, format, ap);
+}
+
+bool DisplayDev_Init(ARMul_State *state)
+{
+  return DisplayDev_Set(state,&Null_DisplayDev);
+}
+
+int Kbd_PollHostKbd(ARMul_State *state)
+{
+  /* Input is injected with Arcem_Key/Arcem_MouseMove */
+  UNUSED_VAR(state);
+  return 0;
+}
+
+FILE *File_OpenAppData(const char *sName, const char *sMode)
+{
+  return fopen(sName, sMode);
+}
+
+Directory *Directory_OpenAppDir(const char *sName)
+{
+  UNUSED_VAR(sName);
+  return NULL;
+}
@@ -293,7 +293,7 @@ ArcemConfig hArcemConfig;
     // One assumes if we managed to select a file then it exists...
     
     // Force the FDC to reload that drive
-    FDC_InsertFloppy(fdNum, [newfile fileSystemRepresentation]);
+    [emuThread insertFloppy: fdNum path: [newfile fileSystemRepresentation]];
     
     // Now disable the insert menu option and enable the eject menu option
     [menuItemsMount[fdNum] setEnabled: NO];
@@ -307,7 +307,7 @@ ArcemConfig hArcemConfig;
 - (IBAction)menuEject0:(id)sender
 {
     // Update the sim
-    FDC_EjectFloppy(0);
+    [emuThread ejectFloppy: 0];
     
     // Now disable the insert menu option and enable the eject menu option
     [menuItemsMount[0] setEnabled: YES];
@@ -321,7 +321,7 @@ ArcemConfig hArcemConfig;
 - (IBAction)menuEject1:(id)sender
 {
     // Update the sim
-    FDC_EjectFloppy(1);
+    [emuThread ejectFloppy: 1];
 
     // Now disable the insert menu option and enable the eject menu option
     [menuItemsMount[1] setEnabled: YES];
@@ -336,7 +336,7 @@ ArcemConfig hArcemConfig;
 - (IBAction)menuEject2:(id)sender
 {
     // Update the sim
-    FDC_EjectFloppy(2);
+    [emuThread ejectFloppy: 2];
 
     // Now disable the insert menu option and enable the eject menu option
     [menuItemsMount[2] setEnabled: YES];
@@ -351,7 +351,7 @@ ArcemConfig hArcemConfig;
 - (IBAction)menuEject3:(id)sender
 {
     // Update the sim
-    FDC_EjectFloppy(3);
+    [emuThread ejectFloppy: 3];
 
     // Now disable the insert menu option and enable the eject menu option
     [menuItemsMount[3] setEnabled: YES];
@@ -50,6 +50,9 @@ struct ARMul_State;
 - (void)keyUp:(int)key;
 - (void)mouseMovedX:(int)xdiff
                   Y:(int)ydiff;
+- (const char *)insertFloppy:(int)drive
+                        path:(const char *)path;
+- (const char *)ejectFloppy:(int)drive;
 
 - (void)threadStart:(id)anObject;  //!< Where the thread is launched
 
@@ -36,6 +36,7 @@
 #import "PreferenceController.h"
 #import "win.h"
 #include "../arch/keyboard.h"
+#include "../arch/fdc1772.h"
 
 #import <pthread.h>
 
@@ -202,4 +203,21 @@ void updateDisplay(int x, int y, int width, int height)
     KBD.MouseYCount = -ydiff & 127;
 }
 
+/*------------------------------------------------------------------------------
+ * insertFloppy
+ */
+- (const char *)insertFloppy:(int)drive
+                        path:(const char *)path
+{
+    return FDC_InsertFloppy(state, drive, path);
+}
+
+/*------------------------------------------------------------------------------
+ * ejectFloppy
+ */
+- (const char *)ejectFloppy:(int)drive
+{
+    return FDC_EjectFloppy(state, drive);
+}
+
 @end
@@ -0,0 +1,296 @@
+/*
+  prof.c
+
+  Part of Arcem released under the GNU GPL, see file COPYING
+  for details.
+
+  Portable implementation of the prof.h profiling interface, for POSIX hosts.
+  (RISC OS uses riscos-single/prof.s instead)
+
+  Each Prof_Begin/Prof_BeginFunc call site is identified by the pointer it
+  was given, and has its call count, inclusive time and exclusive time (i.e.
+  minus the time spent in any nested Begin/End pairs) recorded. Function
+  pointers are resolved to symbol names via dladdr() when the results are
+  dumped, so link with -rdynamic to get names for non-static functions.
+  Static functions will be shown as an offset from the nearest exported
+  symbol, along with the raw address for use with addr2line.
+
+  Results are dumped to stderr at exit, or whenever SIGUSR1 is received. On
+  x86 the TSC is used for timing, elsewhere CLOCK_MONOTONIC_RAW. Times are
+  reported in timer ticks, along with a conversion to nanoseconds based on
+  the wall time elapsed since Prof_Init/Prof_Reset.
+
+  Not thread safe; only the emulator thread should be profiled.
+*/
+
+#ifdef PROFILE_ENABLED
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* For dladdr */
+#endif
+#include <dlfcn.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "c99.h"
+#include "prof.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROF_TSC
+#endif
+
+#define PROF_MAX_ENTRIES 4096 /* Must be power of 2 */
+#define PROF_MAX_DEPTH 64
+
+typedef uint64_t ProfTime;
+
+typedef struct {
+  const void *Key;           /* Pointer passed to Begin, NULL if entry unused */
+  bool IsFunc;               /* Whether Key is a function or a string */
+  uint_least8_t Active;      /* Number of frames for this entry on the stack */
+  uint64_t Calls;
+  ProfTime Inclusive;
+  ProfTime Exclusive;
+} ProfEntry;
+
+typedef struct {
+  ProfEntry *Entry;
+  ProfTime Start;
+  ProfTime Children;         /* Time spent in nested calls */
+} ProfFrame;
+
+static ProfEntry prof_entries[PROF_MAX_ENTRIES];
+static unsigned int prof_num_entries;
+static ProfFrame prof_stack[PROF_MAX_DEPTH];
+static unsigned int prof_depth;
+static uint64_t prof_dropped; /* Begin calls ignored due to full table/stack */
+static volatile sig_atomic_t prof_dump_pending;
+static ProfTime prof_epoch_ticks;
+static uint64_t prof_epoch_ns;
+
+static inline ProfTime prof_now(void)
+{
+#ifdef PROF_TSC
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_RAW,&ts);
+  return ((ProfTime) ts.tv_sec)*1000000000+ts.tv_nsec;
+#endif
+}
+
+static uint64_t prof_wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_RAW,&ts);
+  return ((uint64_t) ts.tv_sec)*1000000000+ts.tv_nsec;
+}
+
+static ProfEntry *prof_lookup(const void *key,bool isfunc)
+{
+  unsigned int idx = (unsigned int) ((((uintptr_t) key)>>2)*2654435761u);
+  for(;;)
+  {
+    ProfEntry *e;
+    idx &= PROF_MAX_ENTRIES-1;
+    e = &prof_entries[idx];
+    if(e->Key == key)
+      return e;
+    if(!e->Key)
+    {
+      /* Keep one slot free so the search always terminates */
+      if(prof_num_entries == PROF_MAX_ENTRIES-1)
+        return NULL;
+      prof_num_entries++;
+      e->Key = key;
+      e->IsFunc = isfunc;
+      return e;
+    }
+    idx++;
+  }
+}
+
+static void prof_begin(const void *key,bool isfunc)
+{
+  ProfEntry *e = prof_lookup(key,isfunc);
+  ProfFrame *f;
+  if(!e || (prof_depth == PROF_MAX_DEPTH))
+  {
+    prof_dropped++;
+    return;
+  }
+  f = &prof_stack[prof_depth++];
+  f->Entry = e;
+  f->Children = 0;
+  e->Active++;
+  f->Start = prof_now();
+}
+
+static bool prof_matches(const ProfEntry *e,const void *key,bool isfunc)
+{
+  if(e->Key == key)
+    return true;
+  /* Identical string literals aren't guaranteed to share an address */
+  return !isfunc && !e->IsFunc && !strcmp((const char *) e->Key,(const char *) key);
+}
+
+static void prof_end(const void *key,bool isfunc)
+{
+  ProfTime now = prof_now();
+  unsigned int depth = prof_depth;
+  /* Find the matching Begin. Anything above it on the stack must have been
+     skipped over (e.g. by an abort), so close those frames too. If there's
+     no match, the Begin was dropped */
+  while(depth && !prof_matches(prof_stack[depth-1].Entry,key,isfunc))
+    depth--;
+  if(!depth)
+    return;
+  while(prof_depth >= depth)
+  {
+    ProfFrame *f = &prof_stack[--prof_depth];
+    ProfEntry *e = f->Entry;
+    ProfTime elapsed = now-f->Start;
+    e->Calls++;
+    e->Exclusive += elapsed-f->Children;
+    /* Only count the outermost call of a recursive function */
+    if(!--e->Active)
+      e->Inclusive += elapsed;
+    if(prof_depth)
+      prof_stack[prof_depth-1].Children += elapsed;
+  }
+  if(!prof_depth && prof_dump_pending)
+  {
+    prof_dump_pending = 0;
+    Prof_Dump(stderr);
+  }
+}
+
+void Prof_BeginFunc(const void *func)
+{
+  prof_begin(func,true);
+}
+
+void Prof_EndFunc(const void *func)
+{
+  prof_end(func,true);
+}
+
+void Prof_Begin(const char *name)
+{
+  prof_begin(name,false);
+}
+
+void Prof_End(const char *name)
+{
+  prof_end(name,false);
+}
+
+void Prof_Reset(void)
+{
+  unsigned int i;
+  for(i=0;i<PROF_MAX_ENTRIES;i++)
+  {
+    ProfEntry *e = &prof_entries[i];
+    e->Calls = 0;
+    e->Inclusive = e->Exclusive = 0;
+  }
+  prof_dropped = 0;
+  prof_epoch_ns = prof_wall_ns();
+  prof_epoch_ticks = prof_now();
+  /* Any frames still open now start from here */
+  for(i=0;i<prof_depth;i++)
+  {
+    prof_stack[i].Start = prof_epoch_ticks;
+    prof_stack[i].Children = 0;
+  }
+}
+
+static int prof_compare(const void *a,const void *b)
+{
+  const ProfEntry *ea = *(const ProfEntry * const *) a;
+  const ProfEntry *eb = *(const ProfEntry * const *) b;
+  if(ea->Exclusive != eb->Exclusive)
+    return (ea->Exclusive < eb->Exclusive ? 1 : -1);
+  return (ea->Calls < eb->Calls ? 1 : (ea->Calls > eb->Calls ? -1 : 0));
+}
+
+static void prof_print_name(FILE *f,const ProfEntry *e)
+{
+  Dl_info info;
+  if(!e->IsFunc)
+  {
+    fprintf(f,"%s\n",(const char *) e->Key);
+    return;
+  }
+  /* dladdr takes a void * in older glibc, so a cast is unavoidable */
+  if(!dladdr((void *) (uintptr_t) e->Key,&info))
+  {
+    fprintf(f,"(%p)\n",e->Key);
+    return;
+  }
+  if(info.dli_sname)
+  {
+    uintptr_t ofs = ((uintptr_t) e->Key)-((uintptr_t) info.dli_saddr);
+    if(!ofs)
+    {
+      fprintf(f,"%s\n",info.dli_sname);
+      return;
+    }
+    fprintf(f,"%s+0x%"PRIxPTR" ",info.dli_sname,ofs);
+  }
+  fprintf(f,"(%s+0x%"PRIxPTR")\n",info.dli_fname,((uintptr_t) e->Key)-((uintptr_t) info.dli_fbase));
+}
+
+void Prof_Dump(FILE *f)
+{
+  ProfEntry *sorted[PROF_MAX_ENTRIES];
+  unsigned int i, num = 0;
+  ProfTime total = prof_now()-prof_epoch_ticks;
+  double ns_per_tick = 0;
+  uint64_t wall = prof_wall_ns()-prof_epoch_ns;
+
+  if(total)
+    ns_per_tick = ((double) wall)/total;
+
+  for(i=0;i<PROF_MAX_ENTRIES;i++)
+    if(prof_entries[i].Calls)
+      sorted[num++] = &prof_entries[i];
+  qsort(sorted,num,sizeof(ProfEntry *),prof_compare);
+
+  fprintf(f,"Profile: %"PRIu64" ticks over %"PRIu64" ns (%.3f ns/tick), %"PRIu64" dropped calls\n",total,wall,ns_per_tick,prof_dropped);
+  fprintf(f,"%12s %16s %16s %7s %10s  %s\n","calls","inclusive","exclusive","excl%","ns/call","name");
+  for(i=0;i<num;i++)
+  {
+    const ProfEntry *e = sorted[i];
+    fprintf(f,"%12"PRIu64" %16"PRIu64" %16"PRIu64" %6.2f%% %10.1f  ",
+            e->Calls,e->Inclusive,e->Exclusive,
+            (total ? (100.0*e->Exclusive)/total : 0.0),
+            (ns_per_tick*e->Exclusive)/e->Calls);
+    prof_print_name(f,e);
+  }
+  fflush(f);
+}
+
+static void prof_atexit(void)
+{
+  Prof_Dump(stderr);
+}
+
+static void prof_signal(int sig)
+{
+  (void) sig;
+  /* Dumping isn't async-signal-safe, so wait until the stack unwinds */
+  prof_dump_pending = 1;
+}
+
+void Prof_Init(void)
+{
+  Prof_Reset();
+  atexit(prof_atexit);
+  signal(SIGUSR1,prof_signal);
+}
+
+#endif
@@ -16,6 +16,8 @@
 
 #ifdef PROFILE_ENABLED
 
+#include <stdio.h>
+
 extern void Prof_Init(void);
 extern void Prof_Dump(FILE *f);
 extern void Prof_BeginFunc(const void *);
@@ -1389,7 +1389,7 @@ static void GoMenu(ARMul_State *state)
   if(CONFIG.eDisplayDriver == DisplayDriver_Standard)
     DisplayDev_UseUpdateFlags = 1;
   /* Rebuild fastmap for DisplayDev_UseUpdateFlags changes */
-  ARMul_RebuildFastMap(state);
+  ARMul_RebuildFastMapRegions(state,FASTMAP_REGION_RAM);
   /* Gobble any keyboard input */
   while(_swi (ArcEmKey_GetKey, _RETURN(0))) {};
   /* Reset EmuRate */
@@ -40,6 +40,7 @@ int sound_buff_mask=BUFFER_SAMPLES-1; /* For benefit of assembler code */
 int sound_rate = 1<<24; /* Fixed output rate! */
 static int buffer_threshold; /* Threshold value used to control desired buffer level; chosen based around the output sample rate & buffer_seconds */
 static float buffer_seconds = 0.2f; /* How much audio we want to try and keep buffered */ 
+static ARMul_State *sound_state; /* The machine being played, for debug dumps */
 
 extern void buffer_fill(void); /* Assembler function for performing the buffer fills */
 extern void error_handler(void); /* Assembler function attached to ErrorV */
@@ -53,7 +54,7 @@ static void sigfunc(int sig)
 	shutdown_sharedsound();
 #if 0
 	/* Dump some emulator state */
-	ARMul_State *state = &statestr;
+	ARMul_State *state = sound_state;
 	dbug_sound("r0 = %08x  r4 = %08x  r8  = %08x  r12 = %08x\n"
 	           "r1 = %08x  r5 = %08x  r9  = %08x  sp  = %08x\n"
 	           "r2 = %08x  r6 = %08x  r10 = %08x  lr  = %08x\n"
@@ -65,7 +66,7 @@ static void sigfunc(int sig)
 	  state->Reg[3], state->Reg[7], state->Reg[11], state->Reg[15]);
 	int i;
 	for(i=0;i<4;i++)
-	  dbug_sound("Timer%d Count %08x Latch %08x\n",i,ioc.TimerCount[i],ioc.TimerInputLatch[i]);
+	  dbug_sound("Timer%d Count %08x Latch %08x\n",i,IOC.TimerCount[i],IOC.TimerInputLatch[i]);
 	FILE *f = fopen("$.dump","wb");
 	if(f)
 	{
@@ -181,7 +182,7 @@ static void shutdown_sharedsound(void)
 
 bool Sound_InitHost(ARMul_State *state)
 {
-  UNUSED_VAR(state);
+  sound_state = state;
 
   /* We want the right channel first */
   eSound_StereoSense = Stereo_RightLeft;
@@ -46,6 +46,8 @@ static BOOL captureMouse = FALSE;
 
 static RECT rcClip;           /* new area for ClipCursor */
 
+static ARMul_State *emuState = NULL; /* The machine the window belongs to */
+
 
 
 
@@ -131,17 +133,17 @@ ATOM MyRegisterClass(HINSTANCE hInstance)
     return RegisterClassEx(&wcex);
 }
 
-static void insert_floppy(HWND hWnd, int drive, char *image)
+static void insert_floppy(ARMul_State *state, HWND hWnd, int drive, char *image)
 {
 	const char *err;
 
-	if (FDC_IsFloppyInserted(drive)) {
-		err = FDC_EjectFloppy(drive);
+	if (FDC_IsFloppyInserted(state, drive)) {
+		err = FDC_EjectFloppy(state, drive);
 		warn_fdc("ejecting drive %d: %s\n", drive,
 		         err ? err : "ok");
 	}
 
-	err = FDC_InsertFloppy(drive, image);
+	err = FDC_InsertFloppy(state, drive, image);
 	warn_fdc("inserting floppy image %s into drive %d: %s\n",
 	         image, drive, err ? err : "ok");
 
@@ -151,7 +153,7 @@ static void insert_floppy(HWND hWnd, int drive, char *image)
 		EnableMenuItem(GetMenu(hWnd), IDM_EJECT0 + drive, MF_GRAYED);
 }
 
-static void OpenFloppyImageDialog(HWND hWnd, int drive) {
+static void OpenFloppyImageDialog(ARMul_State *state, HWND hWnd, int drive) {
 	OPENFILENAMEA ofn;      /* common dialog box structure */
 	char szFile[260];       /* buffer for file name */
 
@@ -173,12 +175,12 @@ static void OpenFloppyImageDialog(HWND hWnd, int drive) {
 
 	/* Display the Open dialog box. */
 	if (GetOpenFileNameA(&ofn)==TRUE) {
-		insert_floppy(hWnd, drive, szFile);
+		insert_floppy(state, hWnd, drive, szFile);
 	}
 }
 
-static void EjectFloppyImage(HWND hWnd, int drive) {
-	const char *err = FDC_EjectFloppy(drive);
+static void EjectFloppyImage(ARMul_State *state, HWND hWnd, int drive) {
+	const char *err = FDC_EjectFloppy(state, drive);
 	warn_fdc("ejecting drive %d: %s\n",
 	         drive, err ? err : "ok");
 
@@ -260,7 +262,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
   int wmId, nVirtKey;
   PAINTSTRUCT ps;
   HDC hdc;
-  ARMul_State *state = &statestr;
+  ARMul_State *state = emuState;
 
   switch (message)
   {
@@ -288,13 +290,13 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         case IDM_OPEN1:
         case IDM_OPEN2:
         case IDM_OPEN3:
-            OpenFloppyImageDialog(hWnd, wmId - IDM_OPEN0);
+            OpenFloppyImageDialog(state, hWnd, wmId - IDM_OPEN0);
             break;
         case IDM_EJECT0:
         case IDM_EJECT1:
         case IDM_EJECT2:
         case IDM_EJECT3:
-            EjectFloppyImage(hWnd, wmId - IDM_EJECT0);
+            EjectFloppyImage(state, hWnd, wmId - IDM_EJECT0);
             break;
         case IDM_EXIT:
           DestroyWindow(hWnd);
@@ -561,6 +563,7 @@ INT_PTR CALLBACK AboutDlgProc(HWND hDlg, UINT iMsg, WPARAM wParam, LPARAM lParam
  */
 int createWindow(ARMul_State *state, int x, int y)
 {
+   emuState = state;
    xSize = x;
    ySize = y;
 